@@ -37,6 +37,12 @@ UFlareResourceCatalog::UFlareResourceCatalog(const class FObjectInitializer& PCI
 	Resources.Sort(SortByResourceType);
 	ConsumerResources.Sort(SortByResourceType);
 	MaintenanceResources.Sort(SortByResourceType);
+
+	// Index resources for per-resource arrays
+	for (int32 Index = 0; Index < Resources.Num(); Index++)
+	{
+		Resources[Index]->Data.Index = Index;
+	}
 }
 
 
@@ -134,6 +134,8 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 		return 0;
 	}
 
+	Parent->GetCompany()->InvalidateCompanyValue();
+
 	// First pass: take resource from the less full cargo
 	uint32 MinQuantity = 0;
 	FFlareCargo* MinQuantityCargo = NULL;
@@ -210,6 +212,7 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 
 void UFlareCargoBay::DumpCargo(FFlareCargo* Cargo)
 {
+	Parent->GetCompany()->InvalidateCompanyValue();
 	Cargo->Quantity = 0;
 	if (Cargo->Lock == EFlareResourceLock::NoLock)
 	{
@@ -226,6 +229,8 @@ uint32 UFlareCargoBay::GiveResources(FFlareResourceDescription* Resource, uint32
 		return Quantity;
 	}
 
+	Parent->GetCompany()->InvalidateCompanyValue();
+
 	// First pass, fill already existing slots
 	for (int CargoIndex = 0 ; CargoIndex < CargoBay.Num() ; CargoIndex++)
 	{
@@ -31,6 +31,9 @@ void UFlarePeople::Load(UFlareSimulatedSector* ParentSector, const FFlarePeopleS
 
 	PeopleData = Data;
 	Parent = ParentSector;
+
+	DeferMoney = false;
+	DeferredWorldMoneyReference = 0;
 }
 
 FFlarePeopleSave* UFlarePeople::Save()
@@ -344,7 +347,15 @@ uint32 UFlarePeople::BuyInStationForCompany(FFlareResourceDescription* Resource,
 		RemainingQuantity -= TakenQuantity;
 		uint32 Price = (uint32) (Parent->GetResourcePrice(Resource, EFlareResourcePriceContext::ConsumerConsumption)) * TakenQuantity;
 		PeopleData.Money -= Price;
-		Company->GiveMoney(Price);
+
+		if (DeferMoney)
+		{
+			DeferredCompanyIncome.FindOrAdd(Company) += Price;
+		}
+		else
+		{
+			Company->GiveMoney(Price);
+		}
 	}
 
 	return Quantity - RemainingQuantity;
@@ -457,7 +468,15 @@ void UFlarePeople::GiveBirth(uint32 BirthCount)
 	// Money creation
 	uint32 NewMoney = BirthCount * MONETARY_CREATION;
 	PeopleData.Money += NewMoney;
-	Game->GetGameWorld()->WorldMoneyReference += NewMoney;
+
+	if (DeferMoney)
+	{
+		DeferredWorldMoneyReference += NewMoney;
+	}
+	else
+	{
+		Game->GetGameWorld()->WorldMoneyReference += NewMoney;
+	}
 
 	IncreaseHappiness(BirthCount * 100 * 2);
 	PeopleData.HappinessPoint += BirthCount * 100 * 2; // Birth happiness bonus
@@ -504,7 +523,15 @@ void UFlarePeople::KillPeople(uint32 KillCount)
 	// Money destruction (delayed, really destroy on Pay)
 	uint32 DestroyedMoney = KillCount * MONETARY_CREATION;
 	PeopleData.Dept += DestroyedMoney;
-	Game->GetGameWorld()->WorldMoneyReference -= DestroyedMoney;
+
+	if (DeferMoney)
+	{
+		DeferredWorldMoneyReference -= DestroyedMoney;
+	}
+	else
+	{
+		Game->GetGameWorld()->WorldMoneyReference -= DestroyedMoney;
+	}
 
 	DecreaseHappiness(KillCount * 100 * 2); // Death happiness malus
 
@@ -612,6 +639,28 @@ void UFlarePeople::ResetPeople()
 
 }
 
+void UFlarePeople::BeginDeferredMoney()
+{
+	DeferMoney = true;
+	DeferredCompanyIncome.Empty();
+	DeferredWorldMoneyReference = 0;
+}
+
+void UFlarePeople::CommitDeferredMoney()
+{
+	DeferMoney = false;
+
+	for (auto& Income : DeferredCompanyIncome)
+	{
+		Income.Key->GiveMoney(Income.Value);
+	}
+
+	Game->GetGameWorld()->WorldMoneyReference += DeferredWorldMoneyReference;
+
+	DeferredCompanyIncome.Empty();
+	DeferredWorldMoneyReference = 0;
+}
+
 void UFlarePeople::PrintInfo()
 {
 	FFlareResourceDescription* Food = Game->GetResourceCatalog()->Get("food");
@@ -4,6 +4,7 @@
 #include "FlarePeople.generated.h"
 
 class AFlareGame;
+class UFlareCompany;
 class UFlareSimulatedSector;
 class UFlareSimulatedSpacecraft;
 struct FFlareResourceDescription;
@@ -135,6 +136,12 @@ public:
 
 	void CheckPopulationDisparition();
 
+	/** Record company payments and money creation instead of applying them, so that Simulate can run off the game thread */
+	void BeginDeferredMoney();
+
+	/** Apply the payments recorded since BeginDeferredMoney. Game thread only */
+	void CommitDeferredMoney();
+
 protected:
 
 	/*----------------------------------------------------
@@ -147,6 +154,11 @@ protected:
 	AFlareGame*                              Game;
 	UFlareSimulatedSector*   				 Parent;
 
+	// Deferred money movements
+	bool                                     DeferMoney;
+	TMap<UFlareCompany*, int64>              DeferredCompanyIncome;
+	int64                                    DeferredWorldMoneyReference;
+
 public:
 
 	/*----------------------------------------------------
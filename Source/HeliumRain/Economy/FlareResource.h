@@ -53,6 +53,9 @@ struct FFlareResourceDescription
 	/** Display sorting index */
 	UPROPERTY(EditAnywhere, Category = Content)
 	float DisplayIndex;
+
+	/** Dense index in the resource catalog, set when the catalog is built */
+	int32 Index;
 };
 
 /** Spacecraft cargo data */
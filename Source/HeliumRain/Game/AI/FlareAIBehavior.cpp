@@ -102,7 +102,11 @@ void UFlareAIBehavior::SimulateGeneralBehavior()
 	// Repair and refill ships and stations
 	Company->GetAI()->RepairAndRefill();
 
-	Company->GetAI()->ProcessBudget(Company->GetAI()->AllBudgets);
+	// Spend budgets on the planning days only
+	if (Company->GetAI()->IsPlanningDay())
+	{
+		Company->GetAI()->ProcessBudget(Company->GetAI()->AllBudgets);
+	}
 
 	// Create or upgrade stations
 	Company->GetAI()->UpdateStationConstruction();
@@ -187,7 +191,11 @@ void UFlareAIBehavior::SimulatePirateBehavior()
 	// Update trade routes
 	Company->GetAI()->UpdateTrading();
 
-	Company->GetAI()->ProcessBudget(Company->GetAI()->AllBudgets);
+	// Spend budgets on the planning days only
+	if (Company->GetAI()->IsPlanningDay())
+	{
+		Company->GetAI()->ProcessBudget(Company->GetAI()->AllBudgets);
+	}
 
 	// Create or upgrade stations
 	Company->GetAI()->UpdateStationConstruction();
@@ -10,6 +10,12 @@
 #include "../../Economy/FlareCargoBay.h"
 #include "../../Spacecrafts/FlareSimulatedSpacecraft.h"
 
+DECLARE_CYCLE_STAT(TEXT("FlareCompanyAI UpdateTrading"), STAT_FlareCompanyAI_UpdateTrading, STATGROUP_Flare);
+DECLARE_CYCLE_STAT(TEXT("FlareCompanyAI PlanTrading"), STAT_FlareCompanyAI_PlanTrading, STATGROUP_Flare);
+DECLARE_CYCLE_STAT(TEXT("FlareCompanyAI BuildTradeDealIndex"), STAT_FlareCompanyAI_BuildTradeDealIndex, STATGROUP_Flare);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("FlareCompanyAI Trade deal mismatches"), STAT_FlareCompanyAI_TradeDealMismatches, STATGROUP_Flare);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("FlareCompanyAI Construction score hits"), STAT_FlareCompanyAI_ConstructionScoreHits, STATGROUP_Flare);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("FlareCompanyAI Construction score misses"), STAT_FlareCompanyAI_ConstructionScoreMisses, STATGROUP_Flare);
 
 #define STATION_CONSTRUCTION_PRICE_BONUS 1.2
 // TODO, make it depend on player CA
@@ -23,6 +29,9 @@
 // TODO, make it depend on company's nature
 #define AI_CARGO_PEACE_MILILTARY_THRESOLD 10
 
+// Safety margin of the trade deal score bounds, for float rounding
+#define AI_TRADE_DEAL_BOUND_MARGIN 1.01f
+
 
 //#define DEBUG_AI_WAR_MILITARY_MOVEMENT
 //#define DEBUG_AI_BATTLE_STATES
@@ -53,6 +62,14 @@ void UFlareCompanyAI::Load(UFlareCompany* ParentCompany, const FFlareCompanyAISa
 	ConstructionProjectNeedCapacity = AIData.ConstructionProjectNeedCapacity;
 	ConstructionShips.Empty();
 	ConstructionStaticShips.Empty();
+	TradeDealIndexValid = false;
+	PlanningDay = true;
+	PlanningDangerousSectors.Empty();
+	PlannedTradeDeals.Empty();
+	PlannedTradeSpending = 0;
+	WarMovementPlanned = false;
+	ConstructionScoreCache.Empty();
+	ConstructionSectorInputsCache.Empty();
 
 	if(AIData.ConstructionProjectSectorIdentifier != NAME_None)
 	{
@@ -139,17 +156,36 @@ void UFlareCompanyAI::Tick()
 	}
 }
 
-void UFlareCompanyAI::Simulate()
+void UFlareCompanyAI::PrepareSimulation()
 {
 	if (Game && Company != Game->GetPC()->GetCompany())
 	{
 		Behavior->Load(Company);
 
+		// Stagger the strategic planning of companies to keep the daily load flat
+		int32 PlanningPeriod = FMath::Max(1, UFlareGameTools::AIPlanningPeriod);
+		PlanningDay = ((Game->GetGameWorld()->GetDate() + Company->GetWorldIndex()) % PlanningPeriod == 0);
+
 		CheckBattleResolution();
 		UpdateDiplomacy();
-	
+	}
+}
+
+void UFlareCompanyAI::PlanSimulation()
+{
+	if (Game && Company != Game->GetPC()->GetCompany())
+	{
 		ResourceFlow = ComputeWorldResourceFlow();
-		WorldStats = WorldHelper::ComputeWorldResourceStats(Game);
+
+		const FFlareEconomySnapshot& EconomySnapshot = Game->GetGameWorld()->GetEconomySnapshot();
+		WorldStats = EconomySnapshot.GetWorldStats();
+		WorldStatsVersions.SetNum(EconomySnapshot.GetResourceCount());
+		for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+			WorldStatsVersions[Resource->Index] = EconomySnapshot.GetWorldStatsVersion(Resource);
+		}
+
 		Shipyards = FindShipyards();
 
 		// Compute input and output ressource equation (ex: 100 + 10/ day)
@@ -160,13 +196,53 @@ void UFlareCompanyAI::Simulate()
 			SectorVariation Variation = ComputeSectorResourceVariation(Sector);
 
 			WorldResourceVariation.Add(Sector, Variation);
+			UpdateConstructionSectorInputs(Sector, WorldResourceVariation[Sector]);
 			//DumpSectorResourceVariation(Sector, &Variation);
 		}
 
+		PlanTrading();
+
+		// Retreats and fleet movements are left to the commit
+		WarMovementPlanned = false;
+		if (PlanningDay && Company->AtWar())
+		{
+			PlannedWarTargets = GenerateWarTargetList();
+			PlannedDefenseSectors = GenerateDefenseSectorList();
+			WarMovementPlanned = true;
+		}
+	}
+}
+
+void UFlareCompanyAI::CommitSimulation()
+{
+	if (Game && Company != Game->GetPC()->GetCompany())
+	{
 		Behavior->Simulate();
 	}
 }
 
+void UFlareCompanyAI::SetSimulationSeed(int32 Seed)
+{
+	SimulationRandom.Initialize(Seed);
+}
+
+void UFlareCompanyAI::CaptureBattleStates()
+{
+	PlanningDangerousSectors.Empty();
+
+	if (Game && Company != Game->GetPC()->GetCompany())
+	{
+		// Battle states are flushed on read, keep them away from the planning
+		for (UFlareSimulatedSector* Sector : Company->GetKnownSectors())
+		{
+			if (Sector->GetSectorBattleState(Company).HasDanger)
+			{
+				PlanningDangerousSectors.Add(Sector);
+			}
+		}
+	}
+}
+
 void UFlareCompanyAI::DestroySpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 {
 	// Don't keep reference on destroyed stations
@@ -178,6 +254,26 @@ void UFlareCompanyAI::DestroySpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 	// Don't keep reference on destroyed ship
 	ConstructionShips.Remove(Spacecraft);
 	ConstructionStaticShips.Remove(Spacecraft);
+
+	for (int32 DealIndex = PlannedTradeDeals.Num() - 1; DealIndex >= 0; DealIndex--)
+	{
+		if (PlannedTradeDeals[DealIndex].Ship == Spacecraft)
+		{
+			PlannedTradeDeals.RemoveAt(DealIndex);
+		}
+	}
+}
+
+void UFlareCompanyAI::ClearConstructionScores(UFlareSimulatedSpacecraft* Station)
+{
+	// The pointer of a destroyed station may be reused
+	for (TMap<ConstructionScoreKey, ConstructionScoreEntry>::TIterator Iterator = ConstructionScoreCache.CreateIterator(); Iterator; ++Iterator)
+	{
+		if (Iterator.Key().Station == Station)
+		{
+			Iterator.RemoveCurrent();
+		}
+	}
 }
 
 
@@ -194,14 +290,32 @@ void UFlareCompanyAI::UpdateDiplomacy()
 //#define DEBUG_AI_TRADING
 #define DEBUG_AI_TRADING_COMPANY "PIR"
 
-void UFlareCompanyAI::UpdateTrading()
+void UFlareCompanyAI::PlanTrading()
 {
-	IdleCargoCapacity = 0;
+	SCOPE_CYCLE_COUNTER(STAT_FlareCompanyAI_PlanTrading);
+
+	PlannedTradeDeals.Empty();
+	PlannedTradeSpending = 0;
+
 	TArray<UFlareSimulatedSpacecraft*> IdleCargos = FindIdleCargos();
+	for (int32 ShipIndex = IdleCargos.Num() - 1; ShipIndex >= 0; ShipIndex--)
+	{
+		// Cargos in danger will flee before trading
+		UFlareSimulatedSpacecraft* Ship = IdleCargos[ShipIndex];
+		if (IsSectorDangerous(Ship->GetCurrentSector()) && Ship->CanTravel() && !Ship->IsMilitary())
+		{
+			IdleCargos.RemoveAt(ShipIndex);
+		}
+	}
+
+	if (IdleCargos.Num() > 0)
+	{
+		BuildTradeDealIndex();
+	}
 #ifdef DEBUG_AI_TRADING
 	if(Company->GetShortName() == DEBUG_AI_TRADING_COMPANY)
 	{
-		FLOGV("UFlareCompanyAI::UpdateTrading : %s has %d idle ships", *Company->GetCompanyName().ToString(), IdleCargos.Num());
+		FLOGV("UFlareCompanyAI::PlanTrading : %s has %d idle ships", *Company->GetCompanyName().ToString(), IdleCargos.Num());
 	}
 #endif
 
@@ -281,6 +395,56 @@ void UFlareCompanyAI::UpdateTrading()
 			}
 		}
 
+		if (BestDeal.Resource)
+		{
+			// Reserve the deal for the next ships, as if it succeeded
+			SectorVariation* SectorVariationA = &WorldResourceVariation[BestDeal.SectorA];
+			struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[BestDeal.Resource];
+			VariationA->OwnedStock -= BestDeal.BuyQuantity;
+
+			if (Ship->GetCurrentSector() == BestDeal.SectorA && BestDeal.BuyQuantity > 0)
+			{
+				// Resources are bought now and arrive in B
+				SectorVariation* SectorVariationB = &WorldResourceVariation[BestDeal.SectorB];
+				SectorVariationB->IncomingCapacity += BestDeal.BuyQuantity;
+
+				struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[BestDeal.Resource];
+				VariationB->OwnedCapacity -= BestDeal.BuyQuantity;
+
+				PlannedTradeSpending += BestDeal.BuyQuantity * BestDeal.SectorA->GetResourcePrice(BestDeal.Resource, EFlareResourcePriceContext::FactoryInput);
+			}
+		}
+
+		PlannedTradeDeal PlannedDeal;
+		PlannedDeal.Ship = Ship;
+		PlannedDeal.Deal = BestDeal;
+		PlannedTradeDeals.Add(PlannedDeal);
+	}
+}
+
+void UFlareCompanyAI::UpdateTrading()
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareCompanyAI_UpdateTrading);
+
+	IdleCargoCapacity = 0;
+
+	for (int32 DealIndex = 0; DealIndex < PlannedTradeDeals.Num(); DealIndex++)
+	{
+		UFlareSimulatedSpacecraft* Ship = PlannedTradeDeals[DealIndex].Ship;
+		SectorDeal BestDeal = PlannedTradeDeals[DealIndex].Deal;
+
+		// Other companies played since the deals were planned
+		if (!IsIdleCargo(Ship))
+		{
+			continue;
+		}
+
+		if (BestDeal.Resource
+		 && (BestDeal.SectorA->GetSectorBattleState(Company).HasDanger || BestDeal.SectorB->GetSectorBattleState(Company).HasDanger))
+		{
+			continue;
+		}
+
 		if (BestDeal.Resource)
 		{
 #ifdef DEBUG_AI_TRADING
@@ -338,19 +502,22 @@ void UFlareCompanyAI::UpdateTrading()
 
 					if (BroughtResource > 0)
 					{
+						// The planning reserved the promised quantity, correct it with the bought one
+						int32 UnplannedQuantity = BroughtResource - BestDeal.BuyQuantity;
+
 						// Virtualy decrease the stock for other ships in sector A
 						SectorVariation* SectorVariationA = &WorldResourceVariation[BestDeal.SectorA];
 						struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[BestDeal.Resource];
-						VariationA->OwnedStock -= BroughtResource;
+						VariationA->OwnedStock -= UnplannedQuantity;
 
 
 						// Virtualy say some capacity arrive in sector B
 						SectorVariation* SectorVariationB = &WorldResourceVariation[BestDeal.SectorB];
-						SectorVariationB->IncomingCapacity += BroughtResource;
+						SectorVariationB->IncomingCapacity += UnplannedQuantity;
 
 						// Virtualy decrease the capacity for other ships in sector B
 						struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[BestDeal.Resource];
-						VariationB->OwnedCapacity -= BroughtResource;
+						VariationB->OwnedCapacity -= UnplannedQuantity;
 					}
 					else if (BroughtResource == 0)
 					{
@@ -364,6 +531,12 @@ void UFlareCompanyAI::UpdateTrading()
 							VariationA->OwnedFlow = 0;
 						if (VariationA->FactoryFlow > 0)
 							VariationA->FactoryFlow = 0;
+
+						// Release the capacity the planning reserved in sector B
+						SectorVariation* SectorVariationB = &WorldResourceVariation[BestDeal.SectorB];
+						SectorVariationB->IncomingCapacity -= BestDeal.BuyQuantity;
+						struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[BestDeal.Resource];
+						VariationB->OwnedCapacity += BestDeal.BuyQuantity;
 #ifdef DEBUG_AI_TRADING
 						if(Company->GetShortName() == DEBUG_AI_TRADING_COMPANY)
 						{
@@ -394,11 +567,6 @@ void UFlareCompanyAI::UpdateTrading()
 					}
 #endif
 				}
-
-				// Reserve the deal by virtualy decrease the stock for other ships
-				SectorVariation* SectorVariationA = &WorldResourceVariation[BestDeal.SectorA];
-				struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[BestDeal.Resource];
-				VariationA->OwnedStock -= BestDeal.BuyQuantity;
 			}
 
 			if (Ship->GetCurrentSector() == BestDeal.SectorB && !Ship->IsTrading())
@@ -550,7 +718,7 @@ void UFlareCompanyAI::UpdateStationConstruction()
 	{
 		TArray<FText> Reasons;
 		bool ShouldBeAbleToBuild = true;
-		if (!ConstructionProjectStation && !ConstructionProjectSector->CanBuildStation(ConstructionProjectStationDescription, Company, Reasons, true))
+		if (!ConstructionProjectStation && !ConstructionProjectSector->CanBuildStation(ConstructionProjectStationDescription, Company, true))
 		{
 			ShouldBeAbleToBuild = false;
 		}
@@ -569,7 +737,7 @@ void UFlareCompanyAI::UpdateStationConstruction()
 			}
 			else
 			{
-				BuildSuccess = ConstructionProjectSector->CanBuildStation(ConstructionProjectStationDescription, Company, Reasons, false) &&
+				BuildSuccess = ConstructionProjectSector->CanBuildStation(ConstructionProjectStationDescription, Company, false) &&
 						(ConstructionProjectSector->BuildStation(ConstructionProjectStationDescription, Company) != NULL);
 			}
 
@@ -1448,8 +1616,7 @@ void UFlareCompanyAI::ProcessBudgetStation(int64 BudgetAmount, bool& Lock, bool&
 			}
 
 			// Check sector limitations
-			TArray<FText> Reasons;
-			if (!Sector->CanBuildStation(StationDescription, Company, Reasons, true))
+			if (!Sector->CanBuildStation(StationDescription, Company, true))
 			{
 				continue;
 			}
@@ -1463,14 +1630,14 @@ void UFlareCompanyAI::ProcessBudgetStation(int64 BudgetAmount, bool& Lock, bool&
 
 
 				// Add weight if the company already have another station in this type
-				float Score = ComputeConstructionScoreForStation(Sector, StationDescription, FactoryDescription, NULL);
+				float Score = GetConstructionScoreForStation(Sector, StationDescription, FactoryDescription, NULL);
 
 				UpdateBestScore(Score, Sector, StationDescription, NULL, &CurrentConstructionScore, &BestScore, &BestStationDescription, &BestStation, &BestSector);
 			}
 
 			if (StationDescription->Factories.Num() == 0)
 			{
-				float Score = ComputeConstructionScoreForStation(Sector, StationDescription, NULL, NULL);
+				float Score = GetConstructionScoreForStation(Sector, StationDescription, NULL, NULL);
 				UpdateBestScore(Score, Sector, StationDescription, NULL, &CurrentConstructionScore, &BestScore, &BestStationDescription, &BestStation, &BestSector);
 			}
 		}
@@ -1492,14 +1659,14 @@ void UFlareCompanyAI::ProcessBudgetStation(int64 BudgetAmount, bool& Lock, bool&
 				FFlareFactoryDescription* FactoryDescription = &Station->GetDescription()->Factories[FactoryIndex]->Data;
 
 				// Add weight if the company already have another station in this type
-				float Score = ComputeConstructionScoreForStation(Sector, Station->GetDescription(), FactoryDescription, Station);
+				float Score = GetConstructionScoreForStation(Sector, Station->GetDescription(), FactoryDescription, Station);
 
 				UpdateBestScore(Score, Sector, Station->GetDescription(), Station, &CurrentConstructionScore, &BestScore, &BestStationDescription, &BestStation, &BestSector);
 			}
 
 			if (Station->GetDescription()->Factories.Num() == 0)
 			{
-				float Score = ComputeConstructionScoreForStation(Sector, Station->GetDescription(), NULL, Station);
+				float Score = GetConstructionScoreForStation(Sector, Station->GetDescription(), NULL, Station);
 				UpdateBestScore(Score, Sector, Station->GetDescription(), Station, &CurrentConstructionScore, &BestScore, &BestStationDescription, &BestStation, &BestSector);
 			}
 
@@ -1660,7 +1827,10 @@ void UFlareCompanyAI::UpdateMilitaryMovement()
 {
 	if (Company->AtWar())
 	{
-		UpdateWarMilitaryMovement();
+		if (PlanningDay)
+		{
+			UpdateWarMilitaryMovement();
+		}
 	}
 	else
 	{
@@ -1794,7 +1964,7 @@ TArray<WarTargetIncomingFleet> UFlareCompanyAI::GenerateWarTargetIncomingFleets(
 	return IncomingFleetList;
 }
 
-inline static bool WarTargetComparator(const WarTarget& ip1, const WarTarget& ip2)
+inline static bool WarTargetComparator(const WarTarget& ip1, const WarTarget& ip2, FRandomStream& Random)
 {
 	bool SELECT_TARGET1 = true;
 	bool SELECT_TARGET2 = false;
@@ -1849,7 +2019,7 @@ inline static bool WarTargetComparator(const WarTarget& ip1, const WarTarget& ip
 
 
 	// Cargo or station
-	return FMath::RandBool();
+	return (Random.RandRange(0, 1) == 1);
 }
 
 
@@ -1861,7 +2031,7 @@ TArray<WarTarget> UFlareCompanyAI::GenerateWarTargetList()
 	{
 		bool IsTarget = false;
 
-		if (Sector->GetSectorBattleState(Company).HasDanger)
+		if (IsSectorDangerous(Sector))
 		{
 			IsTarget = true;
 		}
@@ -1967,42 +2137,83 @@ TArray<WarTarget> UFlareCompanyAI::GenerateWarTargetList()
 		}
 
 
+		// The ships retreat from these targets at commit time, see RetreatFromWarTargets
 		if (Target.OwnedArmyAntiLValue <= Target.EnemyArmyLValue * Behavior->RetreatThreshold ||
 				Target.OwnedArmyAntiSValue <= Target.EnemyArmySValue * Behavior->RetreatThreshold)
 		{
 			WarTargetList.Add(Target);
+		}
+	}
+
+	return WarTargetList;
+}
+
+void UFlareCompanyAI::RetreatFromWarTargets(TArray<WarTarget>& TargetList, TArray<DefenseSector>& DefenseSectorList)
+{
+	for (int32 TargetIndex = 0; TargetIndex < TargetList.Num(); TargetIndex++)
+	{
+		WarTarget& Target = TargetList[TargetIndex];
+
+		TArray<UFlareSimulatedSpacecraft*> MovableShips = GenerateWarShipList(Target.Sector);
+		if (MovableShips.Num() == 0)
+		{
+			continue;
+		}
+
+		// Find nearest sector without danger with available FS and travel there
+		UFlareSimulatedSector* RetreatSector = FindNearestSectorWithFS(Target.Sector);
+		if (!RetreatSector)
+		{
+			RetreatSector = FindNearestSectorWithPeace(Target.Sector);
+		}
+
+		if (!RetreatSector)
+		{
+			continue;
+		}
 
-			// Retreat
-			TArray<UFlareSimulatedSpacecraft*> MovableShips = GenerateWarShipList(Target.Sector);
-			if (MovableShips.Num() > 0)
+		int32 DefenseSectorIndex = INDEX_NONE;
+		for (int32 SectorIndex = 0; SectorIndex < DefenseSectorList.Num(); SectorIndex++)
+		{
+			if (DefenseSectorList[SectorIndex].Sector == Target.Sector)
 			{
-				// Find nearest sector without danger with available FS and travel there
-				UFlareSimulatedSector* RetreatSector = FindNearestSectorWithFS(Target.Sector);
-				if (!RetreatSector)
-				{
-					RetreatSector = FindNearestSectorWithPeace(Target.Sector);
-				}
+				DefenseSectorIndex = SectorIndex;
+				break;
+			}
+		}
 
-				if(RetreatSector)
-				{
-					for (UFlareSimulatedSpacecraft* Ship : MovableShips)
-					{
-						FLOGV("UpdateWarMilitaryMovement %s : move %s from %s to %s for retreat",
-							*Company->GetCompanyName().ToString(),
-							*Ship->GetImmatriculation().ToString(),
-							*Ship->GetCurrentSector()->GetSectorName().ToString(),
-							*RetreatSector->GetSectorName().ToString());
+		for (UFlareSimulatedSpacecraft* Ship : MovableShips)
+		{
+			FLOGV("UpdateWarMilitaryMovement %s : move %s from %s to %s for retreat",
+				*Company->GetCompanyName().ToString(),
+				*Ship->GetImmatriculation().ToString(),
+				*Ship->GetCurrentSector()->GetSectorName().ToString(),
+				*RetreatSector->GetSectorName().ToString());
 
-						Game->GetGameWorld()->StartTravel(Ship->GetCurrentFleet(), RetreatSector);
-					}
-				}
+			// The planned defense counted the ship in the sector it leaves
+			int64 ShipValue = Ship->ComputeCombatValue();
+			if (DefenseSectorIndex != INDEX_NONE && ShipValue != 0)
+			{
+				AddDefenseShip(DefenseSectorList[DefenseSectorIndex], Ship, ShipValue, -1);
 			}
+
+			Game->GetGameWorld()->StartTravel(Ship->GetCurrentFleet(), RetreatSector);
 		}
-	}
 
-	WarTargetList.Sort(&WarTargetComparator);
+		if (DefenseSectorIndex != INDEX_NONE && DefenseSectorList[DefenseSectorIndex].ArmyValue <= 0)
+		{
+			DefenseSectorList.RemoveAt(DefenseSectorIndex);
+		}
 
-	return WarTargetList;
+		// Retreating fleets now travel to the retreat sector
+		for (int32 NextTargetIndex = TargetIndex + 1; NextTargetIndex < TargetList.Num(); NextTargetIndex++)
+		{
+			if (TargetList[NextTargetIndex].Sector == RetreatSector)
+			{
+				TargetList[NextTargetIndex].WarTargetIncomingFleets = GenerateWarTargetIncomingFleets(RetreatSector);
+			}
+		}
+	}
 }
 
 TArray<DefenseSector> UFlareCompanyAI::GenerateDefenseSectorList()
@@ -2011,7 +2222,7 @@ TArray<DefenseSector> UFlareCompanyAI::GenerateDefenseSectorList()
 
 	for (UFlareSimulatedSector* Sector : Company->GetKnownSectors())
 	{
-		if(Sector->GetSectorBattleState(Company).HasDanger)
+		if(IsSectorDangerous(Sector))
 		{
 			continue;
 		}
@@ -2036,28 +2247,8 @@ TArray<DefenseSector> UFlareCompanyAI::GenerateDefenseSectorList()
 			{
 				continue;
 			}
-			
-			Target.ArmyValue += ShipValue;
-			if (Ship->GetSize() == EFlarePartSize::L)
-			{
-				Target.LargeShipArmyValue += ShipValue;
-				Target.LargeShipArmyCount++;
-			}
-			else
-			{
-				Target.SmallShipArmyValue += ShipValue;
-				Target.SmallShipArmyCount++;
-			}
-
-			if (Ship->GetWeaponsSystem()->HasAntiLargeShipWeapon())
-			{
-				Target.ArmyAntiLValue += ShipValue;
-			}
 
-			if (Ship->GetWeaponsSystem()->HasAntiSmallShipWeapon())
-			{
-				Target.ArmyAntiSValue += ShipValue;
-			}
+			AddDefenseShip(Target, Ship, ShipValue, 1);
 		}
 
 		Target.CapturingStation = false;
@@ -2081,10 +2272,41 @@ TArray<DefenseSector> UFlareCompanyAI::GenerateDefenseSectorList()
 	return DefenseSectorList;
 }
 
+void UFlareCompanyAI::AddDefenseShip(DefenseSector& Target, UFlareSimulatedSpacecraft* Ship, int64 ShipValue, int32 Sign)
+{
+	Target.ArmyValue += Sign * ShipValue;
+	if (Ship->GetSize() == EFlarePartSize::L)
+	{
+		Target.LargeShipArmyValue += Sign * ShipValue;
+		Target.LargeShipArmyCount += Sign;
+	}
+	else
+	{
+		Target.SmallShipArmyValue += Sign * ShipValue;
+		Target.SmallShipArmyCount += Sign;
+	}
+
+	if (Ship->GetWeaponsSystem()->HasAntiLargeShipWeapon())
+	{
+		Target.ArmyAntiLValue += Sign * ShipValue;
+	}
+
+	if (Ship->GetWeaponsSystem()->HasAntiSmallShipWeapon())
+	{
+		Target.ArmyAntiSValue += Sign * ShipValue;
+	}
+}
+
 TArray<UFlareSimulatedSpacecraft*> UFlareCompanyAI::GenerateWarShipList(UFlareSimulatedSector* Sector)
 {
 	TArray<UFlareSimulatedSpacecraft*> WarShips;
 
+	// No armed ship here
+	if (Sector->GetCompanyForces(Company).DangerousShipCount == 0)
+	{
+		return WarShips;
+	}
+
 	for (UFlareSimulatedSpacecraft* Ship : Sector->GetSectorShips())
 	{
 		if ( Ship->GetCompany() == Company
@@ -2105,7 +2327,7 @@ int64 UFlareCompanyAI::GetDefenseSectorTravelDuration(TArray<DefenseSector>& Def
 
 	for (DefenseSector& Sector : DefenseSectorList)
 	{
-		int64 TravelDuration = UFlareTravel::ComputeTravelDuration(GetGame()->GetGameWorld(), OriginSector.Sector, Sector.Sector);
+		int64 TravelDuration = GetGame()->GetGameWorld()->GetTravelDuration(OriginSector.Sector, Sector.Sector);
 		if (TravelDuration > MaxTravelDuration)
 		{
 			MaxTravelDuration = TravelDuration;
@@ -2126,7 +2348,7 @@ TArray<DefenseSector> UFlareCompanyAI::GetDefenseSectorListInRange(TArray<Defens
 			continue;
 		}
 
-		int64 TravelDuration = UFlareTravel::ComputeTravelDuration(GetGame()->GetGameWorld(), OriginSector.Sector, Sector.Sector);
+		int64 TravelDuration = GetGame()->GetGameWorld()->GetTravelDuration(OriginSector.Sector, Sector.Sector);
 		if (TravelDuration <= MaxTravelDuration)
 		{
 			Sectors.Add(Sector);
@@ -2138,8 +2360,8 @@ TArray<DefenseSector> UFlareCompanyAI::GetDefenseSectorListInRange(TArray<Defens
 
 inline static bool SectorDefenseDistanceComparator(const DefenseSector& ip1, const DefenseSector& ip2)
 {
-	int64 ip1TravelDuration = UFlareTravel::ComputeTravelDuration(ip1.Sector->GetGame()->GetGameWorld(), ip1.TempBaseSector, ip1.Sector);
-	int64 ip2TravelDuration = UFlareTravel::ComputeTravelDuration(ip1.Sector->GetGame()->GetGameWorld(), ip2.TempBaseSector, ip2.Sector);
+	int64 ip1TravelDuration = ip1.Sector->GetGame()->GetGameWorld()->GetTravelDuration(ip1.TempBaseSector, ip1.Sector);
+	int64 ip2TravelDuration = ip1.Sector->GetGame()->GetGameWorld()->GetTravelDuration(ip2.TempBaseSector, ip2.Sector);
 
 	return (ip1TravelDuration < ip2TravelDuration);
 }
@@ -2157,8 +2379,25 @@ TArray<DefenseSector> UFlareCompanyAI::SortSectorsByDistance(UFlareSimulatedSect
 
 void UFlareCompanyAI::UpdateWarMilitaryMovement()
 {
-	TArray<WarTarget> TargetList = GenerateWarTargetList();
-	TArray<DefenseSector> DefenseSectorList = GenerateDefenseSectorList();
+	if (!WarMovementPlanned)
+	{
+		CaptureBattleStates();
+		PlannedWarTargets = GenerateWarTargetList();
+		PlannedDefenseSectors = GenerateDefenseSectorList();
+	}
+
+	TArray<WarTarget> TargetList = MoveTemp(PlannedWarTargets);
+	TArray<DefenseSector> DefenseSectorList = MoveTemp(PlannedDefenseSectors);
+	PlannedWarTargets.Empty();
+	PlannedDefenseSectors.Empty();
+	WarMovementPlanned = false;
+
+	RetreatFromWarTargets(TargetList, DefenseSectorList);
+
+	TargetList.Sort([this](const WarTarget& ip1, const WarTarget& ip2)
+	{
+		return WarTargetComparator(ip1, ip2, SimulationRandom);
+	});
 
 #ifdef DEBUG_AI_WAR_MILITARY_MOVEMENT
 	FLOGV("UpdateWarMilitaryMovement for %s : Target count %d, Defense sector count %d",
@@ -2208,7 +2447,7 @@ void UFlareCompanyAI::UpdateWarMilitaryMovement()
 
 			// Check if there is an incomming fleet bigger than local
 			bool DefenseFleetFound = false;
-			int64 TravelDuration = UFlareTravel::ComputeTravelDuration(GetGame()->GetGameWorld(), Sector.Sector, Target.Sector);
+			int64 TravelDuration = GetGame()->GetGameWorld()->GetTravelDuration(Sector.Sector, Target.Sector);
 			for (WarTargetIncomingFleet& Fleet : Target.WarTargetIncomingFleets)
 			{
 				// Incoming fleet will be late, ignore it
@@ -2281,7 +2520,7 @@ void UFlareCompanyAI::UpdateWarMilitaryMovement()
 			while (MovableShips.Num() > 0 &&
 				   ((SentShips < MinShipToSend) || (AntiLFleetValue < AntiLFleetValueLimit || AntiSFleetValue < AntiSFleetValueLimit)))
 			{
-				int32 ShipIndex = FMath::RandRange(0, MovableShips.Num()-1);
+				int32 ShipIndex = SimulationRandom.RandRange(0, MovableShips.Num()-1);
 
 				UFlareSimulatedSpacecraft* SelectedShip = MovableShips[ShipIndex];
 				MovableShips.RemoveAt(ShipIndex);
@@ -2480,7 +2719,7 @@ UFlareSimulatedSector* UFlareCompanyAI::FindNearestSectorWithPeace(UFlareSimulat
 			continue;
 		}
 
-		int64 Duration = UFlareTravel::ComputeTravelDuration(Sector->GetGame()->GetGameWorld(), OriginSector, Sector);
+		int64 Duration = Sector->GetGame()->GetGameWorld()->GetTravelDuration(OriginSector, Sector);
 
 		if (!NearestSector || Duration < NearestDuration)
 		{
@@ -2515,7 +2754,7 @@ UFlareSimulatedSector* UFlareCompanyAI::FindNearestSectorWithFS(UFlareSimulatedS
 			continue;
 		}
 
-		int64 Duration = UFlareTravel::ComputeTravelDuration(Sector->GetGame()->GetGameWorld(), OriginSector, Sector);
+		int64 Duration = Sector->GetGame()->GetGameWorld()->GetTravelDuration(OriginSector, Sector);
 
 		if (!NearestSector || Duration < NearestDuration)
 		{
@@ -2539,7 +2778,7 @@ UFlareSimulatedSector* UFlareCompanyAI::FindNearestSectorWithUpgradePossible(UFl
 			continue;
 		}
 
-		int64 Duration = UFlareTravel::ComputeTravelDuration(Sector->GetGame()->GetGameWorld(), OriginSector, Sector);
+		int64 Duration = Sector->GetGame()->GetGameWorld()->GetTravelDuration(OriginSector, Sector);
 
 		if (!NearestSector || Duration < NearestDuration)
 		{
@@ -2580,7 +2819,7 @@ bool UFlareCompanyAI::UpgradeShip(UFlareSimulatedSpacecraft* Ship, EFlarePartSiz
 
 			if(WeaponTargetSize == EFlarePartSize::L)
 			{
-				if(Part->WeaponCharacteristics.BombCharacteristics.IsBomb && FMath::FRand() < 0.8)
+				if(Part->WeaponCharacteristics.BombCharacteristics.IsBomb && SimulationRandom.FRand() < 0.8)
 				{
 					continue;
 				}
@@ -2588,7 +2827,7 @@ bool UFlareCompanyAI::UpgradeShip(UFlareSimulatedSpacecraft* Ship, EFlarePartSiz
 				if (Part->WeaponCharacteristics.DamageType == EFlareShellDamageType::HEAT)
 				{
 					// Compatible target
-					bool HasChance = FMath::FRand() < 0.7;
+					bool HasChance = SimulationRandom.FRand() < 0.7;
 					if(!BestWeapon || (BestWeapon->Cost < Part->Cost && HasChance))
 					{
 						BestWeapon = Part;
@@ -2605,7 +2844,7 @@ bool UFlareCompanyAI::UpgradeShip(UFlareSimulatedSpacecraft* Ship, EFlarePartSiz
 				if (Part->WeaponCharacteristics.DamageType != EFlareShellDamageType::HEAT)
 				{
 					// Compatible target
-					bool HasChance = FMath::RandBool();
+					bool HasChance = (SimulationRandom.RandRange(0, 1) == 1);
 					if(!BestWeapon || (BestWeapon->Cost < Part->Cost && HasChance))
 					{
 						BestWeapon = Part;
@@ -2658,7 +2897,7 @@ bool UFlareCompanyAI::UpgradeShip(UFlareSimulatedSpacecraft* Ship, EFlarePartSiz
 	}
 
 	// Chance to upgrade rcs (optional)
-	if(FMath::RandBool() && Ship->CanUpgrade(EFlarePartType::RCS)) // 50 % chance
+	if((SimulationRandom.RandRange(0, 1) == 1) && Ship->CanUpgrade(EFlarePartType::RCS)) // 50 % chance
 	{
 		// iterate to find best par
 		FFlareSpacecraftComponentDescription* OldPart = Ship->GetCurrentPart(EFlarePartType::RCS, 0);
@@ -2668,7 +2907,7 @@ bool UFlareCompanyAI::UpgradeShip(UFlareSimulatedSpacecraft* Ship, EFlarePartSiz
 
 		for (FFlareSpacecraftComponentDescription* Part : PartListData)
 		{
-			bool HasChance = FMath::RandBool();
+			bool HasChance = (SimulationRandom.RandRange(0, 1) == 1);
 			if(!BestPart || (BestPart->Cost < Part->Cost && HasChance))
 			{
 				BestPart = Part;
@@ -2689,7 +2928,7 @@ bool UFlareCompanyAI::UpgradeShip(UFlareSimulatedSpacecraft* Ship, EFlarePartSiz
 	}
 
 	// Chance to upgrade pod (optional)
-	if(FMath::RandBool() && Ship->CanUpgrade(EFlarePartType::OrbitalEngine)) // 50 % chance
+	if((SimulationRandom.RandRange(0, 1) == 1) && Ship->CanUpgrade(EFlarePartType::OrbitalEngine)) // 50 % chance
 	{
 		// iterate to find best par
 		FFlareSpacecraftComponentDescription* OldPart = Ship->GetCurrentPart(EFlarePartType::OrbitalEngine, 0);
@@ -2699,7 +2938,7 @@ bool UFlareCompanyAI::UpgradeShip(UFlareSimulatedSpacecraft* Ship, EFlarePartSiz
 
 		for (FFlareSpacecraftComponentDescription* Part : PartListData)
 		{
-			bool HasChance = FMath::RandBool();
+			bool HasChance = (SimulationRandom.RandRange(0, 1) == 1);
 			if(!BestPart || (BestPart->Cost < Part->Cost && HasChance))
 			{
 				BestPart = Part;
@@ -3028,7 +3267,7 @@ void UFlareCompanyAI::UpdatePeaceMilitaryMovement()
 
 			if (ShipCandidates.Num() > 1 || (SectorDefendableValue == 0 && ShipCandidates.Num() > 0))
 			{
-				UFlareSimulatedSpacecraft* SelectedShip = ShipCandidates[FMath::RandRange(0, ShipCandidates.Num()-1)];
+				UFlareSimulatedSpacecraft* SelectedShip = ShipCandidates[SimulationRandom.RandRange(0, ShipCandidates.Num()-1)];
 				ShipsToMove.Add(SelectedShip);
 
 				#ifdef DEBUG_AI_PEACE_MILITARY_MOVEMENT
@@ -3062,7 +3301,7 @@ void UFlareCompanyAI::UpdatePeaceMilitaryMovement()
 
 		for (UFlareSimulatedSector* SectorCandidate : LowDefenseSectors)
 		{
-			int64 TravelDuration = UFlareTravel::ComputeTravelDuration(Game->GetGameWorld(), Ship->GetCurrentSector(), SectorCandidate);
+			int64 TravelDuration = Game->GetGameWorld()->GetTravelDuration(Ship->GetCurrentSector(), SectorCandidate);
 			if (BestSectorCandidate == NULL || MinDurationTravel > TravelDuration)
 			{
 				MinDurationTravel = TravelDuration;
@@ -3415,18 +3654,21 @@ TArray<UFlareSimulatedSpacecraft*> UFlareCompanyAI::FindIdleCargos() const
 		for (int32 ShipIndex = 0 ; ShipIndex < Sector->GetSectorShips().Num(); ShipIndex++)
 		{
 			UFlareSimulatedSpacecraft* Ship = Sector->GetSectorShips()[ShipIndex];
-			if (Ship->GetCompany() != Company || Ship->GetDamageSystem()->IsStranded() || Ship->IsTrading() || (Ship->GetCurrentFleet() && Ship->GetCurrentFleet()->IsTraveling()) || Ship->GetCurrentTradeRoute() != NULL || Ship->GetCargoBay()->GetCapacity() == 0 || ConstructionShips.Contains(Ship))
+			if (IsIdleCargo(Ship))
 			{
-				continue;
+				IdleCargos.Add(Ship);
 			}
-
-			IdleCargos.Add(Ship);
 		}
 	}
 
 	return IdleCargos;
 }
 
+bool UFlareCompanyAI::IsIdleCargo(UFlareSimulatedSpacecraft* Ship) const
+{
+	return !(Ship->GetCompany() != Company || Ship->GetDamageSystem()->IsStranded() || Ship->IsTrading() || (Ship->GetCurrentFleet() && Ship->GetCurrentFleet()->IsTraveling()) || Ship->GetCurrentTradeRoute() != NULL || Ship->GetCargoBay()->GetCapacity() == 0 || ConstructionShips.Contains(Ship));
+}
+
 void UFlareCompanyAI::CargosEvasion()
 {
 	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
@@ -3464,7 +3706,7 @@ void UFlareCompanyAI::CargosEvasion()
 			for (int32 SectorIndex2 = 0; SectorIndex2 < Company->GetKnownSectors().Num(); SectorIndex2++)
 			{
 				UFlareSimulatedSector* SectorCandidate = Company->GetKnownSectors()[SectorIndex2];
-				int64 TravelDuration = UFlareTravel::ComputeTravelDuration(Game->GetGameWorld(), Sector, SectorCandidate);
+				int64 TravelDuration = Game->GetGameWorld()->GetTravelDuration(Sector, SectorCandidate);
 
 				if(DistantUnsafeSector == NULL || MaxDurationTravel < TravelDuration)
 				{
@@ -3504,6 +3746,13 @@ void UFlareCompanyAI::CargosEvasion()
 int32 UFlareCompanyAI::GetDamagedCargosCapacity()
 {
 	int32 DamagedCapacity = 0;
+
+	// No stranded ship anywhere
+	if (Company->GetStrandedShipCount() == 0)
+	{
+		return DamagedCapacity;
+	}
+
 	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
 	{
 		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
@@ -3641,7 +3890,7 @@ float UFlareCompanyAI::ComputeConstructionScoreForStation(UFlareSimulatedSector*
 			const struct ResourceVariation* Variation = &ThisSectorVariation->ResourceVariations[Resource];
 
 
-			float Consumption = Sector->GetPeople()->GetRessourceConsumption(Resource, false);
+			float Consumption = Game->GetGameWorld()->GetEconomySnapshot().GetSector(Sector).Consumption[Resource->Index];
 			//FLOGV("%s comsumption = %f", *Resource->Name.ToString(), Consumption);
 
 			float ReserveStock =  Variation->ConsumerMaxStock / 10.f;
@@ -3862,6 +4111,123 @@ float UFlareCompanyAI::ComputeConstructionScoreForStation(UFlareSimulatedSector*
 	return Score;
 }
 
+float UFlareCompanyAI::GetConstructionScoreForStation(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription, UFlareSimulatedSpacecraft* Station)
+{
+	ConstructionScoreKey Key;
+	Key.Sector = Sector;
+	Key.StationDescription = StationDescription;
+	Key.FactoryDescription = FactoryDescription;
+	Key.Station = Station;
+
+	ConstructionScoreDependencies Dependencies = ComputeConstructionScoreDependencies(Sector, StationDescription, FactoryDescription, Station);
+
+	ConstructionScoreEntry* Entry = ConstructionScoreCache.Find(Key);
+	if (Entry && Entry->Dependencies == Dependencies)
+	{
+		INC_DWORD_STAT(STAT_FlareCompanyAI_ConstructionScoreHits);
+		return Entry->Score;
+	}
+
+	INC_DWORD_STAT(STAT_FlareCompanyAI_ConstructionScoreMisses);
+
+	ConstructionScoreEntry NewEntry;
+	NewEntry.Dependencies = Dependencies;
+	NewEntry.Score = ComputeConstructionScoreForStation(Sector, StationDescription, FactoryDescription, Station);
+	ConstructionScoreCache.Add(Key, NewEntry);
+
+	return NewEntry.Score;
+}
+
+ConstructionScoreDependencies UFlareCompanyAI::ComputeConstructionScoreDependencies(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription, UFlareSimulatedSpacecraft* Station) const
+{
+	ConstructionScoreDependencies Dependencies;
+	Dependencies.StationCount = Sector->GetSectorStations().Num();
+	Dependencies.StationLevel = (Station ? Station->GetLevel() : 0);
+	Dependencies.PriceVersion = 0;
+	Dependencies.WorldStatsVersion = 0;
+	Dependencies.SectorInputsVersion = 0;
+	Dependencies.ShipyardUsageRatio = 0;
+
+	// Station price
+	for (int32 ResourceIndex = 0; ResourceIndex < StationDescription->CycleCost.InputResources.Num(); ResourceIndex++)
+	{
+		Dependencies.PriceVersion += Sector->GetResourcePriceVersion(&StationDescription->CycleCost.InputResources[ResourceIndex].Resource->Data);
+	}
+	for (int32 ResourceIndex = 0; ResourceIndex < StationDescription->CycleCost.OutputResources.Num(); ResourceIndex++)
+	{
+		Dependencies.PriceVersion += Sector->GetResourcePriceVersion(&StationDescription->CycleCost.OutputResources[ResourceIndex].Resource->Data);
+	}
+
+	// Factory balance and world flows
+	if (FactoryDescription)
+	{
+		for (int32 ResourceIndex = 0; ResourceIndex < FactoryDescription->CycleCost.InputResources.Num(); ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &FactoryDescription->CycleCost.InputResources[ResourceIndex].Resource->Data;
+			Dependencies.PriceVersion += Sector->GetResourcePriceVersion(Resource);
+			Dependencies.WorldStatsVersion += WorldStatsVersions[Resource->Index];
+		}
+		for (int32 ResourceIndex = 0; ResourceIndex < FactoryDescription->CycleCost.OutputResources.Num(); ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &FactoryDescription->CycleCost.OutputResources[ResourceIndex].Resource->Data;
+			Dependencies.PriceVersion += Sector->GetResourcePriceVersion(Resource);
+			Dependencies.WorldStatsVersion += WorldStatsVersions[Resource->Index];
+		}
+
+		if (FactoryDescription->IsShipyard())
+		{
+			Dependencies.ShipyardUsageRatio = GetShipyardUsageRatio();
+		}
+	}
+
+	// People needs
+	if (StationDescription->Capabilities.Contains(EFlareSpacecraftCapability::Consumer)
+	 || StationDescription->Capabilities.Contains(EFlareSpacecraftCapability::Maintenance))
+	{
+		const ConstructionSectorInputs* Inputs = ConstructionSectorInputsCache.Find(Sector);
+		Dependencies.SectorInputsVersion = (Inputs ? Inputs->Version : INDEX_NONE);
+	}
+
+	return Dependencies;
+}
+
+void UFlareCompanyAI::UpdateConstructionSectorInputs(UFlareSimulatedSector* Sector, const SectorVariation& Variation)
+{
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	const FFlareSectorSnapshot& SectorSnapshot = Game->GetGameWorld()->GetEconomySnapshot().GetSector(Sector);
+
+	ConstructionSectorInputs NewInputs;
+	NewInputs.BasePopulation = Sector->GetPeople()->GetBasePopulation();
+	NewInputs.Version = 0;
+
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCatalog->ConsumerResources.Num(); ResourceIndex++)
+	{
+		FFlareResourceDescription* Resource = &ResourceCatalog->ConsumerResources[ResourceIndex]->Data;
+		NewInputs.Consumptions.Add(SectorSnapshot.Consumption[Resource->Index]);
+		NewInputs.ConsumerMaxStocks.Add(Variation.ResourceVariations[Resource].ConsumerMaxStock);
+	}
+
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCatalog->MaintenanceResources.Num(); ResourceIndex++)
+	{
+		FFlareResourceDescription* Resource = &ResourceCatalog->MaintenanceResources[ResourceIndex]->Data;
+		NewInputs.MaintenanceMaxStocks.Add(Variation.ResourceVariations[Resource].MaintenanceMaxStock);
+	}
+
+	ConstructionSectorInputs* Inputs = ConstructionSectorInputsCache.Find(Sector);
+	if (!Inputs)
+	{
+		ConstructionSectorInputsCache.Add(Sector, NewInputs);
+	}
+	else if (Inputs->BasePopulation != NewInputs.BasePopulation
+		|| Inputs->Consumptions != NewInputs.Consumptions
+		|| Inputs->ConsumerMaxStocks != NewInputs.ConsumerMaxStocks
+		|| Inputs->MaintenanceMaxStocks != NewInputs.MaintenanceMaxStocks)
+	{
+		NewInputs.Version = Inputs->Version + 1;
+		*Inputs = NewInputs;
+	}
+}
+
 float UFlareCompanyAI::ComputeStationPrice(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, UFlareSimulatedSpacecraft* Station) const
 {
 	float StationPrice;
@@ -3883,6 +4249,10 @@ float UFlareCompanyAI::ComputeStationPrice(UFlareSimulatedSector* Sector, FFlare
 
 SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedSector* Sector) const
 {
+	const FFlareEconomySnapshot& EconomySnapshot = Game->GetGameWorld()->GetEconomySnapshot();
+	const FFlareSectorSnapshot& SectorSnapshot = EconomySnapshot.GetSector(Sector);
+	int32 ResourceCount = EconomySnapshot.GetResourceCount();
+
 	SectorVariation SectorVariation;
 	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 	{
@@ -3908,47 +4278,37 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 	int32 OwnedCustomerStation = 0;
 	int32 NotOwnedCustomerStation = 0;
 
-	for (int32 StationIndex = 0 ; StationIndex < Sector->GetSectorStations().Num(); StationIndex++)
+	for (int32 StationIndex = 0 ; StationIndex < SectorSnapshot.Stations.Num(); StationIndex++)
 	{
-		UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
-
+		const FFlareStationSnapshot& Station = SectorSnapshot.Stations[StationIndex];
 
-		if (Station->GetCompany()->GetWarState(Company) == EFlareHostility::Hostile)
+		if (Station.Company->GetWarState(Company) == EFlareHostility::Hostile)
 		{
 			continue;
 		}
 
-		int32 SlotCapacity = Station->GetCargoBay()->GetSlotCapacity();
+		int32 SlotCapacity = Station.SlotCapacity;
 
-		for (int32 FactoryIndex = 0; FactoryIndex < Station->GetFactories().Num(); FactoryIndex++)
+		for (int32 FlowIndex = Station.FirstFlow; FlowIndex < Station.FirstFlow + Station.FlowCount; FlowIndex++)
 		{
-			UFlareFactory* Factory = Station->GetFactories()[FactoryIndex];
-			if ((!Factory->IsActive() || !Factory->IsNeedProduction()))
-			{
-				// No resources needed
-				break;
-			}
+			const FFlareFactoryFlowSnapshot& FactoryFlow = SectorSnapshot.Flows[FlowIndex];
+			FFlareResourceDescription* Resource = FactoryFlow.Resource;
+			struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
+			int32 Flow = FactoryFlow.Flow;
 
 			// Input flow
-			for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetInputResourcesCount(); ResourceIndex++)
+			if (FactoryFlow.Input)
 			{
-				FFlareResourceDescription* Resource = Factory->GetInputResource(ResourceIndex);
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
-
-
-				int32 Flow = Factory->GetInputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
-
-				int32 CanBuyQuantity =  (int32) (Station->GetCompany()->GetMoney() / Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput));
-
+				int32 CanBuyQuantity =  (int32) (Station.Money / Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput));
 
 				if (Flow == 0)
 				{
 					continue;
 				}
 
-				if (Factory->IsProducing())
+				if (FactoryFlow.Producing)
 				{
-					if (Company == Station->GetCompany())
+					if (Company == Station.Company)
 					{
 						Variation->OwnedFlow += Flow;
 					}
@@ -3959,11 +4319,11 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 					}
 				}
 
-				int32 ResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Resource, Company);
+				int32 ResourceQuantity = SectorSnapshot.GetResourceQuantity(StationIndex, Resource, Company, ResourceCount);
 				int32 Capacity = SlotCapacity - ResourceQuantity;
 				if (ResourceQuantity < SlotCapacity)
 				{
-					if (Company == Station->GetCompany())
+					if (Company == Station.Company)
 					{
 
 						Variation->OwnedCapacity += Capacity;
@@ -3990,21 +4350,16 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 			}
 
 			// Ouput flow
-			for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetOutputResourcesCount(); ResourceIndex++)
+			else
 			{
-				FFlareResourceDescription* Resource = Factory->GetOutputResource(ResourceIndex);
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
-
-				int32 Flow = Factory->GetOutputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
-
 				if (Flow == 0)
 				{
 					continue;
 				}
 
-				if (Factory->IsProducing())
+				if (FactoryFlow.Producing)
 				{
-					if (Company == Station->GetCompany())
+					if (Company == Station.Company)
 					{
 						Variation->OwnedFlow -= Flow;
 					}
@@ -4014,8 +4369,8 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 					}
 				}
 
-				int32 Stock = Station->GetCargoBay()->GetResourceQuantity(Resource, Company);
-				if (Company == Station->GetCompany())
+				int32 Stock = SectorSnapshot.GetResourceQuantity(StationIndex, Resource, Company, ResourceCount);
+				if (Company == Station.Company)
 				{
 					Variation->OwnedStock += Stock;
 				}
@@ -4029,15 +4384,13 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 				Variation->OwnedStock -= SlotCapacity * AI_NERF_RATIO;
 			}
 
-
 			// TODO storage
-
 		}
 
 		// Customer flow
-		if (Station->HasCapability(EFlareSpacecraftCapability::Consumer))
+		if (Station.Consumer)
 		{
-			if (Company == Station->GetCompany())
+			if (Company == Station.Company)
 			{
 				OwnedCustomerStation++;
 			}
@@ -4051,12 +4404,12 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 				FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->ConsumerResources[ResourceIndex]->Data;
 				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
 
-				int32 ResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Resource, Company);
+				int32 ResourceQuantity = SectorSnapshot.GetResourceQuantity(StationIndex, Resource, Company, ResourceCount);
 				int32 Capacity = SlotCapacity - ResourceQuantity;
 				// Dept are allowed for sell to customers
 				if (ResourceQuantity < SlotCapacity)
 				{
-					if (Company == Station->GetCompany())
+					if (Company == Station.Company)
 					{
 						Variation->OwnedCapacity += Capacity;
 					}
@@ -4069,7 +4422,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 				// The AI don't let anything for the player : it's too hard
 				// Make the AI ignore the sector with not enought stock or to little capacity
 				Variation->OwnedCapacity -= SlotCapacity * AI_NERF_RATIO;
-				Variation->ConsumerMaxStock += Station->GetCargoBay()->GetSlotCapacity();
+				Variation->ConsumerMaxStock += SlotCapacity;
 
 				float EmptyRatio = (float) Capacity / (float) SlotCapacity;
 				if (EmptyRatio > AI_NERF_RATIO/2)
@@ -4081,22 +4434,22 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 		}
 
 		// Maintenance
-		if (Station->HasCapability(EFlareSpacecraftCapability::Maintenance))
+		if (Station.Maintenance)
 		{
 			for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->MaintenanceResources.Num(); ResourceIndex++)
 			{
 				FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->MaintenanceResources[ResourceIndex]->Data;
 				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
 
-				int32 ResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Resource, Company);
+				int32 ResourceQuantity = SectorSnapshot.GetResourceQuantity(StationIndex, Resource, Company, ResourceCount);
 
-				int32 CanBuyQuantity =  (int32) (Station->GetCompany()->GetMoney() / Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput));
+				int32 CanBuyQuantity =  (int32) (Station.Money / Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput));
 				int32 Capacity = SlotCapacity - ResourceQuantity;
 
 				if (ResourceQuantity < SlotCapacity)
 				{
 
-					if (Company == Station->GetCompany())
+					if (Company == Station.Company)
 					{
 						Variation->OwnedCapacity += Capacity;
 					}
@@ -4106,7 +4459,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 						Variation->FactoryCapacity += Capacity * Behavior->TradingSell;
 					}
 				}
-				Variation->MaintenanceMaxStock += Station->GetCargoBay()->GetSlotCapacity();
+				Variation->MaintenanceMaxStock += SlotCapacity;
 
 				// The AI don't let anything for the player : it's too hard
 				// Make the AI ignore the sector with not enought stock or to little capacity
@@ -4120,10 +4473,9 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 
 				// The owned resell its own FS
 
-				int32 Stock = Station->GetCargoBay()->GetResourceQuantity(Resource, Company);
-				if (Company == Station->GetCompany())
+				if (Company == Station.Company)
 				{
-					Variation->OwnedStock += Stock;
+					Variation->OwnedStock += ResourceQuantity;
 				}
 
 				// The AI don't let anything for the player : it's too hard
@@ -4132,17 +4484,6 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 
 			}
 		}
-
-		// Station construction incitation
-		/*if (ConstructionProjectSector == Sector)
-		{
-			for (int32 ResourceIndex = 0; ResourceIndex < ConstructionProjectStation->CycleCost.InputResources.Num() ; ResourceIndex++)
-			{
-				FFlareFactoryResource* Resource = &ConstructionProjectStation->CycleCost.InputResources[ResourceIndex];
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[&Resource->Resource->Data];
-				Variation->OwnedCapacity += Resource->Quantity;
-			}
-		}*/
 	}
 
 	if (OwnedCustomerStation || NotOwnedCustomerStation)
@@ -4155,79 +4496,39 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->ConsumerResources[ResourceIndex]->Data;
 			struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
 
-
-			int32 Consumption = Sector->GetPeople()->GetRessourceConsumption(Resource, false);
+			int32 Consumption = SectorSnapshot.Consumption[Resource->Index];
 
 			Variation->OwnedFlow = OwnedCustomerRatio * Consumption;
 			Variation->FactoryFlow = NotOwnedCustomerRatio * Consumption * Behavior->TradingSell;
 		}
 	}
 
-	// Compute incoming capacity and resources
-	SectorVariation.IncomingCapacity = 0;
-	for (int32 TravelIndex = 0; TravelIndex < Game->GetGameWorld()->GetTravels().Num(); TravelIndex++)
+	// Incoming capacity and resources
+	SectorVariation.IncomingCapacity = SectorSnapshot.IncomingCapacity;
+	for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 	{
-		UFlareTravel* Travel = Game->GetGameWorld()->GetTravels()[TravelIndex];
-		if (Travel->GetDestinationSector() != Sector)
-		{
-			continue;
-		}
-
-		int64 RemainingTravelDuration = FMath::Max((int64) 1, Travel->GetRemainingTravelDuration());
-
-		UFlareFleet* IncomingFleet = Travel->GetFleet();
+		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+		SectorVariation.ResourceVariations[Resource].IncomingResources = SectorSnapshot.IncomingResources[Resource->Index];
+	}
 
+	// Add damage fleet and repair to maintenance capacity
+	int32 MaintenanceCapacity = 0;
+	for (int CompanyIndex = 0; CompanyIndex < Game->GetGameWorld()->GetCompanies().Num(); CompanyIndex++)
+	{
+		UFlareCompany* OtherCompany = Game->GetGameWorld()->GetCompanies()[CompanyIndex];
 
-		for (int32 ShipIndex = 0; ShipIndex < IncomingFleet->GetShips().Num(); ShipIndex++)
+		if (OtherCompany->GetWarState(Company) == EFlareHostility::Hostile)
 		{
-			UFlareSimulatedSpacecraft* Ship = IncomingFleet->GetShips()[ShipIndex];
-
-			if (Ship->GetCargoBay()->GetSlotCapacity() == 0 && Ship->GetDamageSystem()->IsStranded())
-			{
-				continue;
-			}
-			SectorVariation.IncomingCapacity += Ship->GetCargoBay()->GetCapacity() / RemainingTravelDuration;
-
-			TArray<FFlareCargo>& CargoBaySlots = Ship->GetCargoBay()->GetSlots();
-			for (int32 CargoIndex = 0; CargoIndex < CargoBaySlots.Num(); CargoIndex++)
-			{
-				FFlareCargo& Cargo = CargoBaySlots[CargoIndex];
-
-				if (!Cargo.Resource)
-				{
-					continue;
-				}
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Cargo.Resource];
-
-				Variation->IncomingResources += Cargo.Quantity / (RemainingTravelDuration * 0.5);
-			}
+			continue;
 		}
+
+		MaintenanceCapacity += SectorSnapshot.FleetSupplyNeeds[CompanyIndex];
 	}
 
-	// Add damage fleet and repair to maintenance capacity
 	for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->MaintenanceResources.Num(); ResourceIndex++)
 	{
 		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->MaintenanceResources[ResourceIndex]->Data;
-		struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
-
-		for (int CompanyIndex = 0; CompanyIndex < Game->GetGameWorld()->GetCompanies().Num(); CompanyIndex++)
-		{
-			UFlareCompany* OtherCompany = Game->GetGameWorld()->GetCompanies()[CompanyIndex];
-
-			if (OtherCompany->GetWarState(Company) == EFlareHostility::Hostile)
-			{
-				continue;
-			}
-
-			int32 NeededFS;
-			int32 TotalNeededFS;
-
-			SectorHelper::GetRefillFleetSupplyNeeds(Sector, OtherCompany, NeededFS, TotalNeededFS);
-			Variation->MaintenanceCapacity += TotalNeededFS;
-
-			SectorHelper::GetRepairFleetSupplyNeeds(Sector, OtherCompany, NeededFS, TotalNeededFS);
-			Variation->MaintenanceCapacity += TotalNeededFS;
-		}
+		SectorVariation.ResourceVariations[Resource].MaintenanceCapacity += MaintenanceCapacity;
 	}
 
 	return SectorVariation;
@@ -4275,7 +4576,241 @@ void UFlareCompanyAI::DumpSectorResourceVariation(UFlareSimulatedSector* Sector,
 	}
 }
 
+void UFlareCompanyAI::BuildTradeDealIndex()
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareCompanyAI_BuildTradeDealIndex);
+
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	const TArray<UFlareSimulatedSector*>& KnownSectors = Company->GetKnownSectors();
+
+	TradeDealSources.SetNum(KnownSectors.Num());
+	TradeDealDestinations.SetNum(ResourceCatalog->Resources.Num());
+	for (int32 ResourceIndex = 0; ResourceIndex < TradeDealDestinations.Num(); ResourceIndex++)
+	{
+		TradeDealDestinations[ResourceIndex].Reset();
+	}
+	TradeDealSectorIndices.Empty(KnownSectors.Num());
+	TradeDealMaxSectorAffility = 0;
+	TradeDealIndexValid = true;
+
+	for (int32 SectorIndex = 0; SectorIndex < KnownSectors.Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = KnownSectors[SectorIndex];
+		SectorVariation* Variation = WorldResourceVariation.Find(Sector);
+		TradeDealSources[SectorIndex].Reset();
+		TradeDealSectorIndices.Add(Sector, SectorIndex);
+
+		// Score bounds assume the deal score has the sign of its money balance
+		float SectorAffility = Behavior->GetSectorAffility(Sector);
+		if (SectorAffility < 0 || !Variation)
+		{
+			TradeDealIndexValid = false;
+			return;
+		}
+		TradeDealMaxSectorAffility = FMath::Max(TradeDealMaxSectorAffility, SectorAffility);
+
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCatalog->Resources.Num(); ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &ResourceCatalog->Resources[ResourceIndex]->Data;
+			const struct ResourceVariation& ResourceVariation = Variation->ResourceVariations[Resource];
+
+			// Stock can only decrease during the day, so a sector out of the lists stays out
+			if (ResourceVariation.OwnedStock + ResourceVariation.FactoryStock + ResourceVariation.StorageStock > 0
+				|| ResourceVariation.OwnedFlow < 0
+				|| ResourceVariation.FactoryFlow < 0)
+			{
+				TradeDealSources[SectorIndex].Add(Resource);
+			}
+
+			// Same for capacity, the deal score lifts the sector capacity to its minimum station capacity
+			if (ResourceVariation.OwnedCapacity > 0
+				|| ResourceVariation.MinCapacity > 0
+				|| ResourceVariation.OwnedFlow > 0
+				|| ResourceVariation.FactoryCapacity > 0
+				|| ResourceVariation.FactoryFlow > 0
+				|| ResourceVariation.StorageCapacity > 0
+				|| ResourceVariation.MaintenanceCapacity > 0)
+			{
+				TradeDealDestination Destination;
+				Destination.Sector = Sector;
+				Destination.KnownSectorIndex = SectorIndex;
+				Destination.MaxSellPrice = FMath::Max(
+					FMath::Max(Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 2,
+						Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::MaintenanceConsumption)),
+					Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput));
+
+				TradeDealDestinations[Resource->Index].Add(Destination);
+			}
+		}
+	}
+
+	// Best paying destinations first
+	for (int32 ResourceIndex = 0; ResourceIndex < TradeDealDestinations.Num(); ResourceIndex++)
+	{
+		TradeDealDestinations[ResourceIndex].Sort([](const TradeDealDestination& A, const TradeDealDestination& B)
+		{
+			return A.MaxSellPrice > B.MaxSellPrice;
+		});
+	}
+}
+
 SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat)
+{
+	if (!UFlareGameTools::IndexedTradeDeals || !TradeDealIndexValid)
+	{
+		return FindBestDealForShipFromSectorExhaustive(Ship, SectorA, DealToBeat);
+	}
+
+	SectorDeal BestDeal = FindBestDealForShipFromIndex(Ship, SectorA, DealToBeat);
+
+	if (UFlareGameTools::CheckTradeDeals)
+	{
+		SectorDeal ExhaustiveDeal = FindBestDealForShipFromSectorExhaustive(Ship, SectorA, DealToBeat);
+
+		if (BestDeal.Resource != ExhaustiveDeal.Resource
+			|| BestDeal.SectorB != ExhaustiveDeal.SectorB
+			|| BestDeal.BuyQuantity != ExhaustiveDeal.BuyQuantity
+			|| BestDeal.Score != ExhaustiveDeal.Score)
+		{
+			INC_DWORD_STAT(STAT_FlareCompanyAI_TradeDealMismatches);
+			FLOGV("UFlareCompanyAI::FindBestDealForShipFromSector : %s mismatch for %s from %s : indexed %s to %s (%f), exhaustive %s to %s (%f)",
+				*Company->GetCompanyName().ToString(),
+				*Ship->GetImmatriculation().ToString(),
+				*SectorA->GetSectorName().ToString(),
+				(BestDeal.Resource ? *BestDeal.Resource->Name.ToString() : TEXT("none")),
+				(BestDeal.SectorB ? *BestDeal.SectorB->GetSectorName().ToString() : TEXT("none")),
+				BestDeal.Score,
+				(ExhaustiveDeal.Resource ? *ExhaustiveDeal.Resource->Name.ToString() : TEXT("none")),
+				(ExhaustiveDeal.SectorB ? *ExhaustiveDeal.SectorB->GetSectorName().ToString() : TEXT("none")),
+				ExhaustiveDeal.Score);
+
+			return ExhaustiveDeal;
+		}
+	}
+
+	return BestDeal;
+}
+
+SectorDeal UFlareCompanyAI::FindBestDealForShipFromIndex(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat)
+{
+	SectorDeal BestDeal;
+	BestDeal.Resource = NULL;
+	BestDeal.BuyQuantity = 0;
+	BestDeal.Score = DealToBeat->Score;
+	BestDeal.SectorA = NULL;
+	BestDeal.SectorB = NULL;
+
+	// Position of the best deal in the exhaustive search order, to break ties the same way
+	int32 BestDealOrder = INDEX_NONE;
+
+	if (IsSectorDangerous(SectorA))
+	{
+		return BestDeal;
+	}
+
+	// The exhaustive search stops at the first dangerous destination
+	const TArray<UFlareSimulatedSector*>& KnownSectors = Company->GetKnownSectors();
+	int32 DestinationLimit = KnownSectors.Num();
+	for (int32 SectorIndex = 0; SectorIndex < KnownSectors.Num(); SectorIndex++)
+	{
+		if (IsSectorDangerous(KnownSectors[SectorIndex]))
+		{
+			DestinationLimit = SectorIndex;
+			break;
+		}
+	}
+
+	int32* SectorAIndex = TradeDealSectorIndices.Find(SectorA);
+	if (!SectorAIndex)
+	{
+		return BestDeal;
+	}
+
+	int64 TravelTimeToA = 0;
+	if (Ship->GetCurrentSector() != SectorA)
+	{
+		TravelTimeToA = Game->GetGameWorld()->GetTravelDuration(Ship->GetCurrentSector(), SectorA);
+	}
+
+	// Resources available in A, and resources already in the ship
+	TArray<FFlareResourceDescription*> Resources = TradeDealSources[*SectorAIndex];
+	TArray<FFlareCargo>& ShipSlots = Ship->GetCargoBay()->GetSlots();
+	for (int32 CargoIndex = 0; CargoIndex < ShipSlots.Num(); CargoIndex++)
+	{
+		if (ShipSlots[CargoIndex].Resource && ShipSlots[CargoIndex].Quantity > 0)
+		{
+			Resources.AddUnique(ShipSlots[CargoIndex].Resource);
+		}
+	}
+
+	int32 ResourceCount = Game->GetResourceCatalog()->Resources.Num();
+	float SectorAAffility = Behavior->GetSectorAffility(SectorA);
+
+	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
+	{
+		FFlareResourceDescription* Resource = Resources[ResourceIndex];
+		const TArray<TradeDealDestination>& Destinations = TradeDealDestinations[Resource->Index];
+
+		// Upper bound of the money balance of a deal, for each unit of sell price in B
+		int32 MaxQuantity = Ship->GetCargoBay()->GetFreeSpaceForResource(Resource, Ship->GetCompany())
+			+ Ship->GetCargoBay()->GetResourceQuantity(Resource, Ship->GetCompany());
+		int64 MaxSpendGain = FMath::Max((int64) 0, -SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryOutput));
+		float ResourceAffility = Behavior->GetResourceAffility(Resource);
+		float ScoreFactor = ResourceAffility * ResourceAffility * AI_TRADE_DEAL_BOUND_MARGIN;
+
+		for (int32 DestinationIndex = 0; DestinationIndex < Destinations.Num(); DestinationIndex++)
+		{
+			const TradeDealDestination& Destination = Destinations[DestinationIndex];
+			float MaxBalance = MaxQuantity * (Destination.MaxSellPrice + MaxSpendGain) + 2;
+
+			// Destinations are sorted by price, the next ones can't do better
+			if (MaxBalance * ScoreFactor * (SectorAAffility + TradeDealMaxSectorAffility) / (TravelTimeToA + 1) < BestDeal.Score)
+			{
+				break;
+			}
+
+			if (Destination.KnownSectorIndex >= DestinationLimit)
+			{
+				continue;
+			}
+
+			int64 TravelTimeToB = 0;
+			if (Destination.Sector != SectorA)
+			{
+				TravelTimeToB = Game->GetGameWorld()->GetTravelDuration(SectorA, Destination.Sector);
+			}
+
+			// Too far to beat the best deal
+			float SectorBAffility = Behavior->GetSectorAffility(Destination.Sector);
+			if (MaxBalance * ScoreFactor * (SectorAAffility + SectorBAffility) / (TravelTimeToA + TravelTimeToB + 1) < BestDeal.Score)
+			{
+				continue;
+			}
+
+			float Score;
+			int32 BuyQuantity;
+			if (!ComputeDealScore(Ship, SectorA, Destination.Sector, Resource, TravelTimeToA, TravelTimeToB, Score, BuyQuantity))
+			{
+				continue;
+			}
+
+			int32 DealOrder = Destination.KnownSectorIndex * ResourceCount + Resource->Index;
+			if (Score > BestDeal.Score || (Score == BestDeal.Score && BestDealOrder != INDEX_NONE && DealOrder < BestDealOrder))
+			{
+				BestDeal.Score = Score;
+				BestDeal.SectorA = SectorA;
+				BestDeal.SectorB = Destination.Sector;
+				BestDeal.Resource = Resource;
+				BestDeal.BuyQuantity = BuyQuantity;
+				BestDealOrder = DealOrder;
+			}
+		}
+	}
+
+	return BestDeal;
+}
+
+SectorDeal UFlareCompanyAI::FindBestDealForShipFromSectorExhaustive(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat)
 {
 	SectorDeal BestDeal;
 	BestDeal.Resource = NULL;
@@ -4285,7 +4820,7 @@ SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecr
 	BestDeal.SectorA = NULL;
 	BestDeal.SectorB = NULL;
 
-	if (SectorA->GetSectorBattleState(Company).HasDanger)
+	if (IsSectorDangerous(SectorA))
 	{
 		return BestDeal;
 	}
@@ -4297,7 +4832,7 @@ SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecr
 		int64 TravelTimeToA;
 		int64 TravelTimeToB;
 
-		if (SectorB->GetSectorBattleState(Company).HasDanger)
+		if (IsSectorDangerous(SectorB))
 		{
 			return BestDeal;
 		}
@@ -4308,7 +4843,7 @@ SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecr
 		}
 		else
 		{
-			TravelTimeToA = UFlareTravel::ComputeTravelDuration(Game->GetGameWorld(), Ship->GetCurrentSector(), SectorA);
+			TravelTimeToA = Game->GetGameWorld()->GetTravelDuration(Ship->GetCurrentSector(), SectorA);
 		}
 
 		if (SectorA == SectorB)
@@ -4320,10 +4855,9 @@ SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecr
 		{
 			// Travel time
 
-			TravelTimeToB = UFlareTravel::ComputeTravelDuration(Game->GetGameWorld(), SectorA, SectorB);
+			TravelTimeToB = Game->GetGameWorld()->GetTravelDuration(SectorA, SectorB);
 
 		}
-		int64 TravelTime = TravelTimeToA + TravelTimeToB;
 
 
 #ifdef DEBUG_AI_TRADING
@@ -4335,212 +4869,22 @@ SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecr
 		if(Company->GetShortName() == DEBUG_AI_TRADING_COMPANY)
 		{
 			FLOGV("Travel %s -> %s -> %s : %lld days", *Ship->GetCurrentSector()->GetSectorName().ToString(),
-			*SectorA->GetSectorName().ToString(), *SectorB->GetSectorName().ToString(), TravelTime);
+			*SectorA->GetSectorName().ToString(), *SectorB->GetSectorName().ToString(), TravelTimeToA + TravelTimeToB);
 		}
 #endif
 
-		SectorVariation* SectorVariationA = &(WorldResourceVariation[SectorA]);
-		SectorVariation* SectorVariationB = &(WorldResourceVariation[SectorB]);
-
 		for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 		{
 			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-			struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[Resource];
-			struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[Resource];
 
-#ifdef DEBUG_AI_TRADING
-		if(Company->GetShortName() == DEBUG_AI_TRADING_COMPANY)
-		{
-			FLOGV("- Check for %s", *Resource->Name.ToString());
-		}
-
-		/*if(Resource->Identifier != "fuel")
-		{
-			continue;
-		}*/
-#endif
-
-
-			if (!VariationA->OwnedFlow &&
-				!VariationA->FactoryFlow &&
-				!VariationA->OwnedStock &&
-				!VariationA->FactoryStock &&
-				!VariationA->StorageStock &&
-				!VariationA->OwnedCapacity &&
-				!VariationA->FactoryCapacity &&
-				!VariationA->StorageCapacity &&
-				!VariationA->MaintenanceCapacity &&
-				!VariationB->OwnedFlow &&
-				!VariationB->FactoryFlow &&
-				!VariationB->OwnedStock &&
-				!VariationB->FactoryStock &&
-				!VariationB->StorageStock &&
-				!VariationB->OwnedCapacity &&
-				!VariationB->FactoryCapacity &&
-				!VariationB->StorageCapacity &&
-				!VariationB->MaintenanceCapacity)
-			{
-				continue;
-			}
-
-
-			int32 InitialQuantity = Ship->GetCargoBay()->GetResourceQuantity(Resource, Ship->GetCompany());
-			int32 FreeSpace = Ship->GetCargoBay()->GetFreeSpaceForResource(Resource, Ship->GetCompany());
-
-			int32 StockInAAfterTravel =
-				VariationA->OwnedStock
-				+ VariationA->FactoryStock
-				+ VariationA->StorageStock
-				- (VariationA->OwnedFlow * TravelTimeToA)
-				- (VariationA->FactoryFlow * TravelTimeToA);
-
-			if (StockInAAfterTravel <= 0 && InitialQuantity == 0)
+			float Score;
+			int32 BuyQuantity;
+			if (!ComputeDealScore(Ship, SectorA, SectorB, Resource, TravelTimeToA, TravelTimeToB, Score, BuyQuantity))
 			{
 				continue;
 			}
 
-			int32 CanBuyQuantity = FMath::Min(FreeSpace, StockInAAfterTravel);
-			CanBuyQuantity = FMath::Max(0, CanBuyQuantity);
-
-			// Affordable quantity
-			CanBuyQuantity = FMath::Min(CanBuyQuantity, (int32)(Company->GetMoney() / SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput)));
-
-			int32 TimeToGetB = TravelTime + (CanBuyQuantity > 0 ? 1 : 0); // If full, will not buy so no trade time in A
-
-			int32 LocalCapacity = VariationB->OwnedCapacity
-					+ VariationB->FactoryCapacity
-					+ VariationB->StorageCapacity
-					+ VariationB->MaintenanceCapacity;
-
-			if (VariationB->MinCapacity > 0)
-			{
-				// The nerf system make big capacity malus in whole sector if a big station is near full
-				// If there is an empty small station in the sector, this station will not get any resource
-				// as the sector will be avoided by trade ships
-				LocalCapacity = FMath::Max(LocalCapacity, VariationB->MinCapacity);
-			}
-
-			int32 CapacityInBAfterTravel =
-				LocalCapacity
-				+ VariationB->OwnedFlow * TimeToGetB
-				+ VariationB->FactoryFlow * TimeToGetB;
-			if (TimeToGetB > 0)
-			{
-				CapacityInBAfterTravel -= VariationB->IncomingResources;
-			}
-
-			int32 SellQuantity = FMath::Min(CapacityInBAfterTravel, CanBuyQuantity + InitialQuantity);
-			int32  BuyQuantity = FMath::Max(0, SellQuantity - InitialQuantity);
-
-			// Use price details
-
-			int32 MoneyGain = 0;
-			int32 QuantityToSell = SellQuantity;
-
-			int32 OwnedCapacity = FMath::Max(0, (int32)(VariationB->OwnedCapacity + VariationB->OwnedFlow * TravelTime));
-			int32 MaintenanceCapacity = VariationB->MaintenanceCapacity;
-			int32 FactoryCapacity = FMath::Max(0, (int32)(VariationB->FactoryCapacity + VariationB->FactoryFlow * TravelTime));
-			int32 StorageCapacity = VariationB->StorageCapacity;
-
-			int32 OwnedSellQuantity = FMath::Min(OwnedCapacity, QuantityToSell);
-			MoneyGain += OwnedSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 2;
-			QuantityToSell -= OwnedSellQuantity;
-
-			int32 MaintenanceSellQuantity = FMath::Min(MaintenanceCapacity, QuantityToSell);
-			MoneyGain += MaintenanceSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::MaintenanceConsumption);
-			QuantityToSell -= MaintenanceSellQuantity;
-
-			int32 FactorySellQuantity = FMath::Min(FactoryCapacity, QuantityToSell);
-			MoneyGain += FactorySellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput);
-			QuantityToSell -= FactorySellQuantity;
-
-			int32 StorageSellQuantity = FMath::Min(StorageCapacity, QuantityToSell);
-			MoneyGain += StorageSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
-			QuantityToSell -= StorageSellQuantity;
-
-			int32 MoneySpend = 0;
-			int32 QuantityToBuy = BuyQuantity;
-
-			int32 OwnedStock = FMath::Max(0, (int32)(VariationA->OwnedStock - VariationA->OwnedFlow * TravelTimeToA));
-			int32 FactoryStock = FMath::Max(0, (int32)(VariationA->FactoryStock - VariationA->FactoryFlow * TravelTimeToA));
-			int32 StorageStock = VariationA->StorageStock;
-
-
-			int32 OwnedBuyQuantity = FMath::Min(OwnedStock, QuantityToBuy);
-			MoneySpend += OwnedBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 0.5;
-			QuantityToBuy -= OwnedBuyQuantity;
-
-			int32 FactoryBuyQuantity = FMath::Min(FactoryStock, QuantityToBuy);
-			MoneySpend += FactoryBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryOutput);
-			QuantityToBuy -= FactoryBuyQuantity;
-
-			int32 StorageBuyQuantity = FMath::Min(StorageStock, QuantityToBuy);
-			MoneySpend += StorageBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
-			QuantityToBuy -= StorageBuyQuantity;
-
-
-			// TODO per station computation
-			// TODO prefer own transport
-
-			// Station construction incitation
-			/*if (SectorB == ConstructionProjectSector)
-			{
-			for (int32 ConstructionResourceIndex = 0; ConstructionResourceIndex < ConstructionProjectStation->CycleCost.InputResources.Num() ; ConstructionResourceIndex++)
-			{
-			FFlareFactoryResource* ConstructionResource = &ConstructionProjectStation->CycleCost.InputResources[ConstructionResourceIndex];
-
-			if (Resource == &ConstructionResource->Resource->Data)
-			{
-			MoneyGain *= STATION_CONSTRUCTION_PRICE_BONUS;
-			break;
-			}
-			}
-			}*/
-
-			int32 MoneyBalance = MoneyGain - MoneySpend;
-
-			float MoneyBalanceParDay = (float)MoneyBalance / (float)(TimeToGetB + 1); // 1 day to sell
-
-			bool Temporisation = false;
-			if (BuyQuantity == 0 && Ship->GetCurrentSector() != SectorA)
-			{
-				// If can't buy in A and A is not local, it's just a temporisation route. Better to do nothing.
-				// Accepting to be idle help to avoid building ships
-				Temporisation = true;
-			}
-
-			MoneyBalanceParDay *= Behavior->GetResourceAffility(Resource);
-
-			float Score = MoneyBalanceParDay
-					* Behavior->GetResourceAffility(Resource)
-					* (Behavior->GetSectorAffility(SectorA) + Behavior->GetSectorAffility(SectorB));
-
-#ifdef DEBUG_AI_TRADING
-			if(Company->GetShortName() == DEBUG_AI_TRADING_COMPANY)
-			{
-				FLOGV(" -> IncomingCapacity=%d", SectorVariationA->IncomingCapacity);
-				FLOGV(" -> IncomingResources=%d", VariationA->IncomingResources);
-				FLOGV(" -> InitialQuantity=%d", InitialQuantity);
-				FLOGV(" -> FreeSpace=%d", FreeSpace);
-				FLOGV(" -> StockInAAfterTravel=%d", StockInAAfterTravel);
-				FLOGV(" -> BuyQuantity=%d", BuyQuantity);
-				FLOGV(" -> CapacityInBAfterTravel=%d", CapacityInBAfterTravel);
-				FLOGV(" -> SellQuantity=%u", SellQuantity);
-				FLOGV(" -> MoneyGain=%f", MoneyGain/100.f);
-				FLOGV(" -> MoneySpend=%f", MoneySpend/100.f);
-				FLOGV("   -> OwnedBuyQuantity=%d", OwnedBuyQuantity);
-				FLOGV("   -> FactoryBuyQuantity=%d", FactoryBuyQuantity);
-				FLOGV("   -> StorageBuyQuantity=%d", StorageBuyQuantity);
-				FLOGV(" -> MoneyBalance=%f", MoneyBalance/100.f);
-				FLOGV(" -> MoneyBalanceParDay=%f", MoneyBalanceParDay/100.f);
-				FLOGV(" -> Resource affility=%f", Behavior->GetResourceAffility(Resource));
-				FLOGV(" -> SectorA affility=%f", Behavior->GetSectorAffility(SectorA));
-				FLOGV(" -> SectorB affility=%f", Behavior->GetSectorAffility(SectorB));
-				FLOGV(" -> Score=%f", Score);
-			}
-#endif
-
-			if (Score > BestDeal.Score && !Temporisation)
+			if (Score > BestDeal.Score)
 			{
 				BestDeal.Score = Score;
 				BestDeal.SectorA = SectorA;
@@ -4585,8 +4929,220 @@ SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecr
 	return BestDeal;
 }
 
+bool UFlareCompanyAI::ComputeDealScore(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, UFlareSimulatedSector* SectorB, FFlareResourceDescription* Resource,
+	int64 TravelTimeToA, int64 TravelTimeToB, float& DealScore, int32& DealBuyQuantity)
+{
+	int64 TravelTime = TravelTimeToA + TravelTimeToB;
+
+	SectorVariation* SectorVariationA = &(WorldResourceVariation[SectorA]);
+	SectorVariation* SectorVariationB = &(WorldResourceVariation[SectorB]);
+
+	struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[Resource];
+	struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[Resource];
+
+#ifdef DEBUG_AI_TRADING
+	if(Company->GetShortName() == DEBUG_AI_TRADING_COMPANY)
+	{
+		FLOGV("- Check for %s", *Resource->Name.ToString());
+	}
+
+	/*if(Resource->Identifier != "fuel")
+	{
+		return false;
+	}*/
+#endif
+
+
+	if (!VariationA->OwnedFlow &&
+		!VariationA->FactoryFlow &&
+		!VariationA->OwnedStock &&
+		!VariationA->FactoryStock &&
+		!VariationA->StorageStock &&
+		!VariationA->OwnedCapacity &&
+		!VariationA->FactoryCapacity &&
+		!VariationA->StorageCapacity &&
+		!VariationA->MaintenanceCapacity &&
+		!VariationB->OwnedFlow &&
+		!VariationB->FactoryFlow &&
+		!VariationB->OwnedStock &&
+		!VariationB->FactoryStock &&
+		!VariationB->StorageStock &&
+		!VariationB->OwnedCapacity &&
+		!VariationB->FactoryCapacity &&
+		!VariationB->StorageCapacity &&
+		!VariationB->MaintenanceCapacity)
+	{
+		return false;
+	}
+
+
+	int32 InitialQuantity = Ship->GetCargoBay()->GetResourceQuantity(Resource, Ship->GetCompany());
+	int32 FreeSpace = Ship->GetCargoBay()->GetFreeSpaceForResource(Resource, Ship->GetCompany());
+
+	int32 StockInAAfterTravel =
+		VariationA->OwnedStock
+		+ VariationA->FactoryStock
+		+ VariationA->StorageStock
+		- (VariationA->OwnedFlow * TravelTimeToA)
+		- (VariationA->FactoryFlow * TravelTimeToA);
+
+	if (StockInAAfterTravel <= 0 && InitialQuantity == 0)
+	{
+		return false;
+	}
+
+	int32 CanBuyQuantity = FMath::Min(FreeSpace, StockInAAfterTravel);
+	CanBuyQuantity = FMath::Max(0, CanBuyQuantity);
+
+	// Affordable quantity
+	int64 AvailableMoney = FMath::Max((int64) 0, Company->GetMoney() - PlannedTradeSpending);
+	CanBuyQuantity = FMath::Min(CanBuyQuantity, (int32)(AvailableMoney / SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput)));
+
+	int32 TimeToGetB = TravelTime + (CanBuyQuantity > 0 ? 1 : 0); // If full, will not buy so no trade time in A
+
+	int32 LocalCapacity = VariationB->OwnedCapacity
+			+ VariationB->FactoryCapacity
+			+ VariationB->StorageCapacity
+			+ VariationB->MaintenanceCapacity;
+
+	if (VariationB->MinCapacity > 0)
+	{
+		// The nerf system make big capacity malus in whole sector if a big station is near full
+		// If there is an empty small station in the sector, this station will not get any resource
+		// as the sector will be avoided by trade ships
+		LocalCapacity = FMath::Max(LocalCapacity, VariationB->MinCapacity);
+	}
+
+	int32 CapacityInBAfterTravel =
+		LocalCapacity
+		+ VariationB->OwnedFlow * TimeToGetB
+		+ VariationB->FactoryFlow * TimeToGetB;
+	if (TimeToGetB > 0)
+	{
+		CapacityInBAfterTravel -= VariationB->IncomingResources;
+	}
+
+	int32 SellQuantity = FMath::Min(CapacityInBAfterTravel, CanBuyQuantity + InitialQuantity);
+	int32  BuyQuantity = FMath::Max(0, SellQuantity - InitialQuantity);
+
+	// Use price details
+
+	int32 MoneyGain = 0;
+	int32 QuantityToSell = SellQuantity;
+
+	int32 OwnedCapacity = FMath::Max(0, (int32)(VariationB->OwnedCapacity + VariationB->OwnedFlow * TravelTime));
+	int32 MaintenanceCapacity = VariationB->MaintenanceCapacity;
+	int32 FactoryCapacity = FMath::Max(0, (int32)(VariationB->FactoryCapacity + VariationB->FactoryFlow * TravelTime));
+	int32 StorageCapacity = VariationB->StorageCapacity;
+
+	int32 OwnedSellQuantity = FMath::Min(OwnedCapacity, QuantityToSell);
+	MoneyGain += OwnedSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 2;
+	QuantityToSell -= OwnedSellQuantity;
+
+	int32 MaintenanceSellQuantity = FMath::Min(MaintenanceCapacity, QuantityToSell);
+	MoneyGain += MaintenanceSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::MaintenanceConsumption);
+	QuantityToSell -= MaintenanceSellQuantity;
+
+	int32 FactorySellQuantity = FMath::Min(FactoryCapacity, QuantityToSell);
+	MoneyGain += FactorySellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput);
+	QuantityToSell -= FactorySellQuantity;
+
+	int32 StorageSellQuantity = FMath::Min(StorageCapacity, QuantityToSell);
+	MoneyGain += StorageSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
+	QuantityToSell -= StorageSellQuantity;
+
+	int32 MoneySpend = 0;
+	int32 QuantityToBuy = BuyQuantity;
+
+	int32 OwnedStock = FMath::Max(0, (int32)(VariationA->OwnedStock - VariationA->OwnedFlow * TravelTimeToA));
+	int32 FactoryStock = FMath::Max(0, (int32)(VariationA->FactoryStock - VariationA->FactoryFlow * TravelTimeToA));
+	int32 StorageStock = VariationA->StorageStock;
+
+
+	int32 OwnedBuyQuantity = FMath::Min(OwnedStock, QuantityToBuy);
+	MoneySpend += OwnedBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 0.5;
+	QuantityToBuy -= OwnedBuyQuantity;
+
+	int32 FactoryBuyQuantity = FMath::Min(FactoryStock, QuantityToBuy);
+	MoneySpend += FactoryBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryOutput);
+	QuantityToBuy -= FactoryBuyQuantity;
+
+	int32 StorageBuyQuantity = FMath::Min(StorageStock, QuantityToBuy);
+	MoneySpend += StorageBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
+	QuantityToBuy -= StorageBuyQuantity;
+
+
+	// TODO per station computation
+	// TODO prefer own transport
+
+	// Station construction incitation
+	/*if (SectorB == ConstructionProjectSector)
+	{
+	for (int32 ConstructionResourceIndex = 0; ConstructionResourceIndex < ConstructionProjectStation->CycleCost.InputResources.Num() ; ConstructionResourceIndex++)
+	{
+	FFlareFactoryResource* ConstructionResource = &ConstructionProjectStation->CycleCost.InputResources[ConstructionResourceIndex];
+
+	if (Resource == &ConstructionResource->Resource->Data)
+	{
+	MoneyGain *= STATION_CONSTRUCTION_PRICE_BONUS;
+	break;
+	}
+	}
+	}*/
+
+	int32 MoneyBalance = MoneyGain - MoneySpend;
+
+	float MoneyBalanceParDay = (float)MoneyBalance / (float)(TimeToGetB + 1); // 1 day to sell
+
+	bool Temporisation = false;
+	if (BuyQuantity == 0 && Ship->GetCurrentSector() != SectorA)
+	{
+		// If can't buy in A and A is not local, it's just a temporisation route. Better to do nothing.
+		// Accepting to be idle help to avoid building ships
+		Temporisation = true;
+	}
+
+	MoneyBalanceParDay *= Behavior->GetResourceAffility(Resource);
+
+	float Score = MoneyBalanceParDay
+			* Behavior->GetResourceAffility(Resource)
+			* (Behavior->GetSectorAffility(SectorA) + Behavior->GetSectorAffility(SectorB));
+
+#ifdef DEBUG_AI_TRADING
+	if(Company->GetShortName() == DEBUG_AI_TRADING_COMPANY)
+	{
+		FLOGV(" -> IncomingCapacity=%d", SectorVariationA->IncomingCapacity);
+		FLOGV(" -> IncomingResources=%d", VariationA->IncomingResources);
+		FLOGV(" -> InitialQuantity=%d", InitialQuantity);
+		FLOGV(" -> FreeSpace=%d", FreeSpace);
+		FLOGV(" -> StockInAAfterTravel=%d", StockInAAfterTravel);
+		FLOGV(" -> BuyQuantity=%d", BuyQuantity);
+		FLOGV(" -> CapacityInBAfterTravel=%d", CapacityInBAfterTravel);
+		FLOGV(" -> SellQuantity=%u", SellQuantity);
+		FLOGV(" -> MoneyGain=%f", MoneyGain/100.f);
+		FLOGV(" -> MoneySpend=%f", MoneySpend/100.f);
+		FLOGV("   -> OwnedBuyQuantity=%d", OwnedBuyQuantity);
+		FLOGV("   -> FactoryBuyQuantity=%d", FactoryBuyQuantity);
+		FLOGV("   -> StorageBuyQuantity=%d", StorageBuyQuantity);
+		FLOGV(" -> MoneyBalance=%f", MoneyBalance/100.f);
+		FLOGV(" -> MoneyBalanceParDay=%f", MoneyBalanceParDay/100.f);
+		FLOGV(" -> Resource affility=%f", Behavior->GetResourceAffility(Resource));
+		FLOGV(" -> SectorA affility=%f", Behavior->GetSectorAffility(SectorA));
+		FLOGV(" -> SectorB affility=%f", Behavior->GetSectorAffility(SectorB));
+		FLOGV(" -> Score=%f", Score);
+	}
+#endif
+
+	DealScore = Score;
+	DealBuyQuantity = BuyQuantity;
+
+	return !Temporisation;
+}
+
 TMap<FFlareResourceDescription*, int32> UFlareCompanyAI::ComputeWorldResourceFlow() const
 {
+	const FFlareEconomySnapshot& EconomySnapshot = Game->GetGameWorld()->GetEconomySnapshot();
+
 	TMap<FFlareResourceDescription*, int32> WorldResourceFlow;
 	for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 	{
@@ -4597,52 +5153,28 @@ TMap<FFlareResourceDescription*, int32> UFlareCompanyAI::ComputeWorldResourceFlo
 
 	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
 	{
-		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
+		const FFlareSectorSnapshot& SectorSnapshot = EconomySnapshot.GetSector(Company->GetKnownSectors()[SectorIndex]);
 		int32 CustomerStation = 0;
 
-
-		for (int32 StationIndex = 0; StationIndex < Sector->GetSectorStations().Num(); StationIndex++)
+		for (int32 StationIndex = 0; StationIndex < SectorSnapshot.Stations.Num(); StationIndex++)
 		{
-			UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
-
+			const FFlareStationSnapshot& Station = SectorSnapshot.Stations[StationIndex];
 
-			if (Station->GetCompany()->GetWarState(Company) == EFlareHostility::Hostile)
+			if (Station.Company->GetWarState(Company) == EFlareHostility::Hostile)
 			{
 				continue;
 			}
 
-			if (Station->HasCapability(EFlareSpacecraftCapability::Consumer))
+			if (Station.Consumer)
 			{
 				CustomerStation++;
 			}
 
-			for (int32 FactoryIndex = 0; FactoryIndex < Station->GetFactories().Num(); FactoryIndex++)
+			// Input and output flows
+			for (int32 FlowIndex = Station.FirstFlow; FlowIndex < Station.FirstFlow + Station.FlowCount; FlowIndex++)
 			{
-				UFlareFactory* Factory = Station->GetFactories()[FactoryIndex];
-				if ((!Factory->IsActive() || !Factory->IsNeedProduction()))
-				{
-					// No resources needed
-					break;
-				}
-
-				// Input flow
-				for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetInputResourcesCount(); ResourceIndex++)
-				{
-					FFlareResourceDescription* Resource = Factory->GetInputResource(ResourceIndex);
-
-
-					int32 Flow = Factory->GetInputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
-					WorldResourceFlow[Resource] -= Flow;
-				}
-
-				// Ouput flow
-				for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetOutputResourcesCount(); ResourceIndex++)
-				{
-					FFlareResourceDescription* Resource = Factory->GetOutputResource(ResourceIndex);
-
-					int32 Flow = Factory->GetOutputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
-					WorldResourceFlow[Resource] += Flow;
-				}
+				const FFlareFactoryFlowSnapshot& Flow = SectorSnapshot.Flows[FlowIndex];
+				WorldResourceFlow[Flow.Resource] += (Flow.Input ? -Flow.Flow : Flow.Flow);
 			}
 		}
 
@@ -4651,9 +5183,7 @@ TMap<FFlareResourceDescription*, int32> UFlareCompanyAI::ComputeWorldResourceFlo
 			for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->ConsumerResources.Num(); ResourceIndex++)
 			{
 				FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->ConsumerResources[ResourceIndex]->Data;
-
-				int32 Consumption = Sector->GetPeople()->GetRessourceConsumption(Resource, false);
-				WorldResourceFlow[Resource] -= Consumption;
+				WorldResourceFlow[Resource] -= (int32) SectorSnapshot.Consumption[Resource->Index];
 			}
 		}
 
@@ -19,6 +19,90 @@ struct SectorDeal
 	int32 BuyQuantity;
 };
 
+/* Trade deal chosen for an idle cargo during the planning, applied at commit time */
+struct PlannedTradeDeal
+{
+	UFlareSimulatedSpacecraft* Ship;
+	SectorDeal Deal;
+};
+
+/* Sector that can absorb a resource, in the trade deal index */
+struct TradeDealDestination
+{
+	UFlareSimulatedSector* Sector;
+	int32 KnownSectorIndex;
+
+	/** Best unit price a ship can get by selling the resource in the sector */
+	int64 MaxSellPrice;
+};
+
+/* Construction or upgrade candidate, in the construction score cache */
+struct ConstructionScoreKey
+{
+	UFlareSimulatedSector* Sector;
+	FFlareSpacecraftDescription* StationDescription;
+	FFlareFactoryDescription* FactoryDescription;
+	UFlareSimulatedSpacecraft* Station;
+
+	bool operator==(const ConstructionScoreKey& Other) const
+	{
+		return Sector == Other.Sector
+			&& StationDescription == Other.StationDescription
+			&& FactoryDescription == Other.FactoryDescription
+			&& Station == Other.Station;
+	}
+
+	friend uint32 GetTypeHash(const ConstructionScoreKey& Key)
+	{
+		uint32 Hash = HashCombine(PointerHash(Key.Sector), PointerHash(Key.StationDescription));
+		Hash = HashCombine(Hash, PointerHash(Key.FactoryDescription));
+		return HashCombine(Hash, PointerHash(Key.Station));
+	}
+};
+
+/* World state a construction score was computed from. Versions only increase, so their sums change with any of them */
+struct ConstructionScoreDependencies
+{
+	int32 StationCount;
+	int32 StationLevel;
+	int64 PriceVersion;
+	int64 WorldStatsVersion;
+	int32 SectorInputsVersion;
+	float ShipyardUsageRatio;
+
+	bool operator==(const ConstructionScoreDependencies& Other) const
+	{
+		return StationCount == Other.StationCount
+			&& StationLevel == Other.StationLevel
+			&& PriceVersion == Other.PriceVersion
+			&& WorldStatsVersion == Other.WorldStatsVersion
+			&& SectorInputsVersion == Other.SectorInputsVersion
+			&& ShipyardUsageRatio == Other.ShipyardUsageRatio;
+	}
+};
+
+struct ConstructionScoreEntry
+{
+	ConstructionScoreDependencies Dependencies;
+	float Score;
+};
+
+/* Sector data used by the consumer and maintenance construction scores */
+struct ConstructionSectorInputs
+{
+	/** People consumption, by consumer resource index */
+	TArray<float> Consumptions;
+
+	/** Max stocks, by consumer and maintenance resource index */
+	TArray<int32> ConsumerMaxStocks;
+	TArray<int32> MaintenanceMaxStocks;
+
+	int32 BasePopulation;
+
+	/** Incremented each time one of the inputs changes */
+	int32 Version;
+};
+
 /* Resource flow */
 struct ResourceVariation
 {
@@ -117,12 +201,27 @@ public:
 	/** Real-time tick */
 	virtual void Tick();
 
-	/** Simulate a day */
-	virtual void Simulate();
+	/** Resolve battles and update diplomacy, on the game thread */
+	void PrepareSimulation();
+
+	/** Analyse the economy snapshot. Read-only on the world, can run in parallel with other companies */
+	void PlanSimulation();
+
+	/** Apply the company decisions to the world, on the game thread */
+	void CommitSimulation();
+
+	/** Seed the random stream used by the company decisions */
+	void SetSimulationSeed(int32 Seed);
+
+	/** Copy the danger state of the known sectors for the planning, on the game thread */
+	void CaptureBattleStates();
 
 	/** Destroy a spacecraft */
 	virtual void DestroySpacecraft(UFlareSimulatedSpacecraft* Spacecraft);
 
+	/** Forget the construction scores of a station */
+	void ClearConstructionScores(UFlareSimulatedSpacecraft* Station);
+
 
 	/*----------------------------------------------------
 		Behavior API
@@ -133,7 +232,7 @@ public:
 	/** Update diplomacy changes */
 	void UpdateDiplomacy();
 
-	/** Update trading for the company's fleet*/
+	/** Update trading for the company's fleet, from the planned deals */
 	void UpdateTrading();
 
 	/** Manage the construction of stations */
@@ -207,6 +306,9 @@ public:
 
 	TArray<DefenseSector> GenerateDefenseSectorList();
 
+	/** Move the fleets away from the targets they can't hold, and remove them from the defense sectors */
+	void RetreatFromWarTargets(TArray<WarTarget>& TargetList, TArray<DefenseSector>& DefenseSectorList);
+
 	void CheckBattleResolution();
 
 	void CheckBattleState();
@@ -244,6 +346,18 @@ protected:
 	/** Get a list of idle cargos */
 	TArray<UFlareSimulatedSpacecraft*> FindIdleCargos() const;
 
+	/** Check whether a ship is free to trade */
+	bool IsIdleCargo(UFlareSimulatedSpacecraft* Ship) const;
+
+	/** Check whether a sector was dangerous when the battle states were captured */
+	bool IsSectorDangerous(UFlareSimulatedSector* Sector) const
+	{
+		return PlanningDangerousSectors.Contains(Sector);
+	}
+
+	/** Count a ship in a defense sector, or remove it with a negative sign */
+	void AddDefenseShip(DefenseSector& Target, UFlareSimulatedSpacecraft* Ship, int64 ShipValue, int32 Sign);
+
 	int32 GetDamagedCargosCapacity();
 
 	/** Get a list of idle military */
@@ -254,6 +368,15 @@ protected:
 	/** Generate a score for ranking construction projects, version 2 */
 	float ComputeConstructionScoreForStation(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription, UFlareSimulatedSpacecraft* Station) const;
 
+	/** Get the construction score of a station, from the cache if its dependencies didn't change */
+	float GetConstructionScoreForStation(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription, UFlareSimulatedSpacecraft* Station);
+
+	/** Get the state of the world the construction score of a station depends on */
+	ConstructionScoreDependencies ComputeConstructionScoreDependencies(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription, UFlareSimulatedSpacecraft* Station) const;
+
+	/** Update the consumer and maintenance inputs of the construction scores of a sector */
+	void UpdateConstructionSectorInputs(UFlareSimulatedSector* Sector, const SectorVariation& Variation);
+
 	float ComputeStationPrice(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, UFlareSimulatedSpacecraft* Station) const;
 
 	/** Get the resource flow in this sector */
@@ -262,7 +385,24 @@ protected:
 	/** Print the resource flow */
 	void DumpSectorResourceVariation(UFlareSimulatedSector* Sector, TMap<FFlareResourceDescription*, struct ResourceVariation>* Variation) const;
 
+	/** Choose a deal for each idle cargo. Read-only on the world */
+	void PlanTrading();
+
+	/** Build the per-day lists of sectors that can supply or absorb each resource */
+	void BuildTradeDealIndex();
+
+	/** Find the best deal starting from SectorA, using the trade deal index when possible */
 	SectorDeal FindBestDealForShipFromSector(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat);
+
+	/** Find the best deal starting from SectorA, among the candidates of the trade deal index */
+	SectorDeal FindBestDealForShipFromIndex(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat);
+
+	/** Find the best deal starting from SectorA, checking all sectors and resources */
+	SectorDeal FindBestDealForShipFromSectorExhaustive(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat);
+
+	/** Compute the score of a deal, return false if there is no valid deal */
+	bool ComputeDealScore(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, UFlareSimulatedSector* SectorB, FFlareResourceDescription* Resource,
+		int64 TravelTimeToA, int64 TravelTimeToB, float& DealScore, int32& DealBuyQuantity);
 	
 	TMap<FFlareResourceDescription*, int32> ComputeWorldResourceFlow() const;
 
@@ -298,8 +438,34 @@ protected:
 
 	TArray<UFlareSimulatedSector*>            SectorWithBattle;
 
+	// Trade deal index, by known sector index and by resource index
+	TArray<TArray<FFlareResourceDescription*>> TradeDealSources;
+	TArray<TArray<TradeDealDestination>>       TradeDealDestinations;
+	TMap<UFlareSimulatedSector*, int32>        TradeDealSectorIndices;
+	float                                      TradeDealMaxSectorAffility;
+	bool                                       TradeDealIndexValid;
+
+	// Construction score cache
+	TMap<ConstructionScoreKey, ConstructionScoreEntry>             ConstructionScoreCache;
+	TMap<UFlareSimulatedSector*, ConstructionSectorInputs>         ConstructionSectorInputsCache;
+	TArray<int32>                                                  WorldStatsVersions;
+
 	int32 IdleCargoCapacity;
 
+	// Planning results, applied by the commit
+	TSet<UFlareSimulatedSector*>             PlanningDangerousSectors;
+	TArray<PlannedTradeDeal>                 PlannedTradeDeals;
+	int64                                    PlannedTradeSpending;
+	bool                                     WarMovementPlanned;
+	TArray<WarTarget>                        PlannedWarTargets;
+	TArray<DefenseSector>                    PlannedDefenseSectors;
+
+	// Strategic planning runs today
+	bool                                     PlanningDay;
+
+	/** Random stream for the company decisions, never shared between companies */
+	FRandomStream                            SimulationRandom;
+
 public:
 
 	TArray<EFlareBudget::Type> AllBudgets;
@@ -323,5 +489,11 @@ public:
 		return &AIData;
 	}
 
+	/** Check whether the expensive strategic planning (budgets, war movements) runs today */
+	bool IsPlanningDay() const
+	{
+		return PlanningDay;
+	}
+
 };
 
@@ -34,6 +34,9 @@ void UFlareCompany::Load(const FFlareCompanySave& Data)
 	CompanyData = Data;
 	CompanyData.Identifier = FName(*GetName());
 	CompanyDescription = NULL;
+	WorldIndex = INDEX_NONE;
+	CompanyValueCacheDate = -1;
+	StrandedShipCount = 0;
 
 	// Player description ID is -1
 	if (Data.CatalogIdentifier >= 0)
@@ -80,7 +83,12 @@ void UFlareCompany::PostLoad()
 {
 	VisitedSectors.Empty();
 	KnownSectors.Empty();
+	for (UFlareTradeRoute* TradeRoute : CompanyTradeRoutes)
+	{
+		Game->GetGameWorld()->UnindexTradeRoute(TradeRoute);
+	}
 	CompanyTradeRoutes.Empty();
+	CompanyTradeRoutesByIdentifier.Empty();
 
 	// Load all trade routes
 	for (int32 i = 0; i < CompanyData.TradeRoutes.Num(); i++)
@@ -176,11 +184,6 @@ FFlareCompanySave* UFlareCompany::Save()
 	Gameplay
 ----------------------------------------------------*/
 
-void UFlareCompany::SimulateAI()
-{
-	CompanyAI->Simulate();
-}
-
 void UFlareCompany::TickAI()
 {
 	CompanyAI->Tick();
@@ -204,7 +207,7 @@ EFlareHostility::Type UFlareCompany::GetHostility(const UFlareCompany* TargetCom
 	{
 		return EFlareHostility::Owned;
 	}
-	else if (TargetCompany && CompanyData.HostileCompanies.Contains(TargetCompany->GetIdentifier()))
+	else if (TargetCompany && Game->GetGameWorld()->IsCompanyHostile(this, TargetCompany))
 	{
 		return EFlareHostility::Hostile;
 	}
@@ -230,12 +233,12 @@ EFlareHostility::Type UFlareCompany::GetWarState(const UFlareCompany* TargetComp
 	{
 		return EFlareHostility::Owned;
 	}
-	else if (GetHostility(TargetCompany) == EFlareHostility::Hostile || TargetCompany->GetHostility(this) == EFlareHostility::Hostile)
+	else if (TargetCompany && Game->GetGameWorld()->IsCompanyAtWar(this, TargetCompany))
 	{
 		return EFlareHostility::Hostile;
 	}
 
-	return GetHostility(TargetCompany);
+	return EFlareHostility::Neutral;
 }
 
 void UFlareCompany::ClearLastWarDate()
@@ -266,6 +269,7 @@ void UFlareCompany::SetHostilityTo(UFlareCompany* TargetCompany, bool Hostile)
 		if (Hostile && !WasHostile)
 		{
 			CompanyData.HostileCompanies.AddUnique(TargetCompany->GetIdentifier());
+			Game->GetGameWorld()->SetCompanyHostility(this, TargetCompany, true);
 			TargetCompany->GiveReputation(this, -50, true);
 
 			UFlareCompany* PlayerCompany = Game->GetPC()->GetCompany();
@@ -307,6 +311,7 @@ void UFlareCompany::SetHostilityTo(UFlareCompany* TargetCompany, bool Hostile)
 		else if(!Hostile && WasHostile)
 		{
 			CompanyData.HostileCompanies.Remove(TargetCompany->GetIdentifier());
+			Game->GetGameWorld()->SetCompanyHostility(this, TargetCompany, false);
 
 			UFlareCompany* PlayerCompany = Game->GetPC()->GetCompany();
 
@@ -346,6 +351,33 @@ void UFlareCompany::SetHostilityTo(UFlareCompany* TargetCompany, bool Hostile)
 	}
 }
 
+void UFlareCompany::SetWorldIndex(int32 Index)
+{
+	WorldIndex = Index;
+}
+
+void UFlareCompany::InvalidateCompanyValue()
+{
+	CompanyValueRevision.Increment();
+}
+
+void UFlareCompany::OnSpacecraftDamageStateChanged(UFlareSimulatedSpacecraft* Spacecraft, int32 OldDamageState, int32 NewDamageState)
+{
+	// Ignore spacecrafts that are not counted anymore
+	if (FindSpacecraft(Spacecraft->GetImmatriculation()) != Spacecraft)
+	{
+		return;
+	}
+
+	bool WasStranded = (OldDamageState != INDEX_NONE && (OldDamageState & EFlareDamageState::Stranded));
+	bool IsStranded = (NewDamageState != INDEX_NONE && (NewDamageState & EFlareDamageState::Stranded));
+
+	if (IsStranded != WasStranded)
+	{
+		StrandedShipCount += (IsStranded ? 1 : -1);
+	}
+}
+
 FText UFlareCompany::GetShortInfoText()
 {
 	// Static text
@@ -432,6 +464,8 @@ UFlareFleet* UFlareCompany::LoadFleet(const FFlareFleetSave& FleetData)
 	Fleet = NewObject<UFlareFleet>(this, UFlareFleet::StaticClass());
 	Fleet->Load(FleetData);
 	CompanyFleets.AddUnique(Fleet);
+	CompanyFleetsByIdentifier.Add(Fleet->GetIdentifier(), Fleet);
+	Game->GetGameWorld()->IndexFleet(Fleet);
 
 	//FLOGV("UFlareWorld::LoadFleet : loaded fleet '%s'", *Fleet->GetFleetName().ToString());
 
@@ -441,6 +475,11 @@ UFlareFleet* UFlareCompany::LoadFleet(const FFlareFleetSave& FleetData)
 void UFlareCompany::RemoveFleet(UFlareFleet* Fleet)
 {
 	CompanyFleets.Remove(Fleet);
+	if (FindFleet(Fleet->GetIdentifier()) == Fleet)
+	{
+		CompanyFleetsByIdentifier.Remove(Fleet->GetIdentifier());
+	}
+	Game->GetGameWorld()->UnindexFleet(Fleet);
 }
 
 UFlareTradeRoute* UFlareCompany::CreateTradeRoute(FText TradeRouteName)
@@ -468,6 +507,8 @@ UFlareTradeRoute* UFlareCompany::LoadTradeRoute(const FFlareTradeRouteSave& Trad
 	TradeRoute = NewObject<UFlareTradeRoute>(this, UFlareTradeRoute::StaticClass());
 	TradeRoute->Load(TradeRouteData);
 	CompanyTradeRoutes.AddUnique(TradeRoute);
+	CompanyTradeRoutesByIdentifier.Add(TradeRoute->GetIdentifier(), TradeRoute);
+	Game->GetGameWorld()->IndexTradeRoute(TradeRoute);
 
 	//FLOGV("UFlareCompany::LoadTradeRoute : loaded trade route '%s'", *TradeRoute->GetTradeRouteName().ToString());
 
@@ -477,6 +518,11 @@ UFlareTradeRoute* UFlareCompany::LoadTradeRoute(const FFlareTradeRouteSave& Trad
 void UFlareCompany::RemoveTradeRoute(UFlareTradeRoute* TradeRoute)
 {
 	CompanyTradeRoutes.Remove(TradeRoute);
+	if (FindTradeRoute(TradeRoute->GetIdentifier()) == TradeRoute)
+	{
+		CompanyTradeRoutesByIdentifier.Remove(TradeRoute->GetIdentifier());
+	}
+	Game->GetGameWorld()->UnindexTradeRoute(TradeRoute);
 }
 
 UFlareSimulatedSpacecraft* UFlareCompany::LoadSpacecraft(const FFlareSpacecraftSave& SpacecraftData)
@@ -512,6 +558,9 @@ UFlareSimulatedSpacecraft* UFlareCompany::LoadSpacecraft(const FFlareSpacecraftS
 		}
 
 		CompanySpacecrafts.AddUnique((Spacecraft));
+		InvalidateCompanyValue();
+		CompanySpacecraftsByImmatriculation.Add(Spacecraft->GetImmatriculation(), Spacecraft);
+		Game->GetGameWorld()->IndexSpacecraft(Spacecraft);
 	}
 	else
 	{
@@ -525,9 +574,19 @@ void UFlareCompany::DestroySpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 {
 	FLOGV("UFlareCompany::DestroySpacecraft : Remove %s from company %s", *Spacecraft->GetImmatriculation().ToString(), *GetCompanyName().ToString());
 
+	// Stop counting the spacecraft state
+	Spacecraft->GetDamageSystem()->UpdateDamageState();
+	OnSpacecraftDamageStateChanged(Spacecraft, Spacecraft->GetDamageSystem()->GetDamageState(), INDEX_NONE);
+
 	CompanySpacecrafts.Remove(Spacecraft);
 	CompanyStations.Remove(Spacecraft);
 	CompanyShips.Remove(Spacecraft);
+	InvalidateCompanyValue();
+	if (FindSpacecraft(Spacecraft->GetImmatriculation()) == Spacecraft)
+	{
+		CompanySpacecraftsByImmatriculation.Remove(Spacecraft->GetImmatriculation());
+	}
+	Game->GetGameWorld()->UnindexSpacecraft(Spacecraft);
 	if (Spacecraft->GetCurrentFleet())
 	{
 		Spacecraft->GetCurrentFleet()->RemoveShip(Spacecraft, true);
@@ -539,6 +598,13 @@ void UFlareCompany::DestroySpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 	}
 	GetGame()->GetGameWorld()->ClearFactories(Spacecraft);
 	CompanyAI->DestroySpacecraft(Spacecraft);
+
+	// Any company may have scored the station
+	const TArray<UFlareCompany*>& Companies = GetGame()->GetGameWorld()->GetCompanies();
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		Companies[CompanyIndex]->GetAI()->ClearConstructionScores(Spacecraft);
+	}
 }
 
 void UFlareCompany::DiscoverSector(UFlareSimulatedSector* Sector)
@@ -1071,6 +1137,40 @@ const FSlateBrush* UFlareCompany::GetEmblem() const
 ----------------------------------------------------*/
 
 struct CompanyValue UFlareCompany::GetCompanyValue(UFlareSimulatedSector* SectorFilter, bool IncludeIncoming) const
+{
+	// Prices change every day, and spacecraft changes bump the revision
+	int64 Date = Game->GetGameWorld()->GetDate();
+	int32 Revision = CompanyValueRevision.GetValue();
+	if (CompanyValueCacheDate != Date || CompanyValueCacheRevision != Revision)
+	{
+		CompanyValueCache[0].Empty();
+		CompanyValueCache[1].Empty();
+		CompanyValueCacheDate = Date;
+		CompanyValueCacheRevision = Revision;
+	}
+
+	// Incoming spacecrafts only matter with a sector filter
+	int32 CacheIndex = (SectorFilter && !IncludeIncoming) ? 0 : 1;
+	struct CompanyValue Value;
+	const struct CompanyValue* CachedValue = CompanyValueCache[CacheIndex].Find(SectorFilter);
+	if (CachedValue)
+	{
+		Value = *CachedValue;
+	}
+	else
+	{
+		Value = ComputeCompanyValue(SectorFilter, IncludeIncoming);
+		CompanyValueCache[CacheIndex].Add(SectorFilter, Value);
+	}
+
+	// Money changes too often to be cached, and is cheap
+	Value.MoneyValue = GetMoney();
+	Value.TotalValue = Value.MoneyValue + Value.StockValue + Value.SpacecraftsValue;
+
+	return Value;
+}
+
+struct CompanyValue UFlareCompany::ComputeCompanyValue(UFlareSimulatedSector* SectorFilter, bool IncludeIncoming) const
 {
 	// Company value is the sum of :
 	// - money
@@ -1176,17 +1276,10 @@ struct CompanyValue UFlareCompany::GetCompanyValue(UFlareSimulatedSector* Sector
 	return Value;
 }
 
-UFlareSimulatedSpacecraft* UFlareCompany::FindSpacecraft(FName ShipImmatriculation)
+UFlareSimulatedSpacecraft* UFlareCompany::FindSpacecraft(FName ShipImmatriculation) const
 {
-	for (int i = 0; i < CompanySpacecrafts.Num(); i++)
-	{
-		if (CompanySpacecrafts[i]->GetImmatriculation() == ShipImmatriculation)
-		{
-			return CompanySpacecrafts[i];
-		}
-	}
-
-	return NULL;
+	UFlareSimulatedSpacecraft* const* Spacecraft = CompanySpacecraftsByImmatriculation.Find(ShipImmatriculation);
+	return Spacecraft ? *Spacecraft : NULL;
 }
 
 bool UFlareCompany::HasVisitedSector(const UFlareSimulatedSector* Sector) const
@@ -113,8 +113,6 @@ public:
 		Gameplay
 	----------------------------------------------------*/
 
-	virtual void SimulateAI();
-
 	virtual void TickAI();
 
 
@@ -139,6 +137,14 @@ public:
 	/** Set whether this company is hostile to an other company */
 	virtual void SetHostilityTo(UFlareCompany* TargetCompany, bool Hostile);
 
+	/** Set the index of this company in the world company list */
+	void SetWorldIndex(int32 Index);
+
+	/** A spacecraft was added, removed, moved, damaged or had its cargo changed. Thread safe */
+	void InvalidateCompanyValue();
+
+	/** The damage state of a company spacecraft changed, or the spacecraft was removed if NewDamageState is INDEX_NONE */
+	void OnSpacecraftDamageStateChanged(UFlareSimulatedSpacecraft* Spacecraft, int32 OldDamageState, int32 NewDamageState);
 
 	/** Get an info string for this company */
 	virtual FText GetShortInfoText();
@@ -249,9 +255,24 @@ protected:
 	FSlateBrush                             CompanyEmblemBrush;
 
 	AFlareGame*                             Game;
+	int32                                   WorldIndex;
+
+	/** Company value cache without money, indexed by [IncludeIncoming][SectorFilter] */
+	mutable TMap<UFlareSimulatedSector*, CompanyValue> CompanyValueCache[2];
+	mutable int64                           CompanyValueCacheDate;
+	mutable int32                           CompanyValueCacheRevision;
+	FThreadSafeCounter                      CompanyValueRevision;
+
+	/** Lookup indices, the arrays above keep the objects referenced */
+	TMap<FName, UFlareSimulatedSpacecraft*> CompanySpacecraftsByImmatriculation;
+	TMap<FName, UFlareFleet*>               CompanyFleetsByIdentifier;
+	TMap<FName, UFlareTradeRoute*>          CompanyTradeRoutesByIdentifier;
 	TArray<UFlareSimulatedSector*>          KnownSectors;
 	TArray<UFlareSimulatedSector*>          VisitedSectors;
 
+	/** Alive ships unable to travel, from the published damage states */
+	int32                                   StrandedShipCount;
+
 
 public:
 
@@ -272,6 +293,21 @@ public:
 		return CompanyData.Identifier;
 	}
 
+	inline int32 GetWorldIndex() const
+	{
+		return WorldIndex;
+	}
+
+	inline int32 GetStrandedShipCount() const
+	{
+		return StrandedShipCount;
+	}
+
+	inline const TArray<FName>& GetHostileCompanies() const
+	{
+		return CompanyData.HostileCompanies;
+	}
+
 	inline const FFlareCompanyDescription* GetDescription() const
 	{
 		return CompanyDescription;
@@ -324,8 +360,12 @@ public:
 		return CompanyData.Money;
 	}
 
+	/** Get the company value, cached for the current day */
 	struct CompanyValue GetCompanyValue(UFlareSimulatedSector* SectorFilter = NULL, bool IncludeIncoming = true) const;
 
+	/** Compute the company value without cache */
+	struct CompanyValue ComputeCompanyValue(UFlareSimulatedSector* SectorFilter = NULL, bool IncludeIncoming = true) const;
+
 	inline TArray<UFlareSimulatedSpacecraft*>& GetCompanyStations()
 	{
 		return CompanyStations;
@@ -363,29 +403,17 @@ public:
 
 	UFlareFleet* FindFleet(FName Identifier) const
 	{
-		for (int i = 0; i < CompanyFleets.Num(); i++)
-		{
-			if (CompanyFleets[i]->GetIdentifier() == Identifier)
-			{
-				return CompanyFleets[i];
-			}
-		}
-		return NULL;
+		UFlareFleet* const* Fleet = CompanyFleetsByIdentifier.Find(Identifier);
+		return Fleet ? *Fleet : NULL;
 	}
 
 	UFlareTradeRoute* FindTradeRoute(FName Identifier) const
 	{
-		for (int i = 0; i < CompanyTradeRoutes.Num(); i++)
-		{
-			if (CompanyTradeRoutes[i]->GetIdentifier() == Identifier)
-			{
-				return CompanyTradeRoutes[i];
-			}
-		}
-		return NULL;
+		UFlareTradeRoute* const* TradeRoute = CompanyTradeRoutesByIdentifier.Find(Identifier);
+		return TradeRoute ? *TradeRoute : NULL;
 	}
 
-	UFlareSimulatedSpacecraft* FindSpacecraft(FName ShipImmatriculation);
+	UFlareSimulatedSpacecraft* FindSpacecraft(FName ShipImmatriculation) const;
 
 	bool HasVisitedSector(const UFlareSimulatedSector* Sector) const;
 
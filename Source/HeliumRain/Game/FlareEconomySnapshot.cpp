@@ -0,0 +1,234 @@
+#include "../Flare.h"
+#include "FlareEconomySnapshot.h"
+#include "FlareGame.h"
+#include "FlareWorld.h"
+#include "FlareFleet.h"
+#include "FlareTravel.h"
+#include "FlareSectorHelper.h"
+#include "FlareSimulatedSector.h"
+#include "../Economy/FlareCargoBay.h"
+#include "../Economy/FlareFactory.h"
+#include "../Spacecrafts/FlareSimulatedSpacecraft.h"
+
+DECLARE_CYCLE_STAT(TEXT("FlareEconomySnapshot Build"), STAT_FlareEconomySnapshot_Build, STATGROUP_Flare);
+
+
+/*----------------------------------------------------
+	Sector
+----------------------------------------------------*/
+
+int32 FFlareSectorSnapshot::GetResourceQuantity(int32 StationIndex, FFlareResourceDescription* Resource, UFlareCompany* Company, int32 ResourceCount) const
+{
+	int32 Offset = StationIndex * ResourceCount + Resource->Index;
+	return (Company == Stations[StationIndex].Company) ? OwnerQuantities[Offset] : ClientQuantities[Offset];
+}
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+FFlareEconomySnapshot::FFlareEconomySnapshot()
+	: Built(false)
+	, ResourceCount(0)
+{
+}
+
+
+/*----------------------------------------------------
+	Build
+----------------------------------------------------*/
+
+void FFlareEconomySnapshot::Build(AFlareGame* Game)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareEconomySnapshot_Build);
+
+	UFlareWorld* World = Game->GetGameWorld();
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	ResourceCount = ResourceCatalog->Resources.Num();
+
+	// World stats
+	TMap<FFlareResourceDescription*, WorldHelper::FlareResourceStats> NewWorldStats = WorldHelper::ComputeWorldResourceStats(Game);
+	WorldStatsVersions.SetNumZeroed(ResourceCount);
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+	{
+		FFlareResourceDescription* Resource = &ResourceCatalog->Resources[ResourceIndex]->Data;
+		WorldHelper::FlareResourceStats* OldStats = WorldStats.Find(Resource);
+		WorldHelper::FlareResourceStats* NewStats = NewWorldStats.Find(Resource);
+
+		if (!OldStats || !NewStats
+			|| OldStats->Production != NewStats->Production
+			|| OldStats->Consumption != NewStats->Consumption
+			|| OldStats->Balance != NewStats->Balance
+			|| OldStats->Stock != NewStats->Stock)
+		{
+			WorldStatsVersions[Resource->Index]++;
+		}
+	}
+	WorldStats = MoveTemp(NewWorldStats);
+
+	Sectors.SetNum(World->GetSectors().Num());
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = World->GetSectors()[SectorIndex];
+		FFlareSectorSnapshot& Snapshot = Sectors[SectorIndex];
+		int32 StationCount = Sector->GetSectorStations().Num();
+
+		Snapshot.Sector = Sector;
+		Snapshot.Stations.Reset(StationCount);
+		Snapshot.Flows.Reset();
+		Snapshot.OwnerQuantities.Reset();
+		Snapshot.OwnerQuantities.SetNumZeroed(StationCount * ResourceCount);
+		Snapshot.ClientQuantities.Reset();
+		Snapshot.ClientQuantities.SetNumZeroed(StationCount * ResourceCount);
+
+		// Stations
+		for (int32 StationIndex = 0; StationIndex < StationCount; StationIndex++)
+		{
+			UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
+
+			FFlareStationSnapshot StationSnapshot;
+			StationSnapshot.Station = Station;
+			StationSnapshot.Company = Station->GetCompany();
+			StationSnapshot.Money = Station->GetCompany()->GetMoney();
+			StationSnapshot.SlotCapacity = Station->GetCargoBay()->GetSlotCapacity();
+			StationSnapshot.Consumer = Station->HasCapability(EFlareSpacecraftCapability::Consumer);
+			StationSnapshot.Maintenance = Station->HasCapability(EFlareSpacecraftCapability::Maintenance);
+			StationSnapshot.FirstFlow = Snapshot.Flows.Num();
+
+			for (int32 FactoryIndex = 0; FactoryIndex < Station->GetFactories().Num(); FactoryIndex++)
+			{
+				UFlareFactory* Factory = Station->GetFactories()[FactoryIndex];
+				if ((!Factory->IsActive() || !Factory->IsNeedProduction()))
+				{
+					// No resources needed
+					break;
+				}
+
+				for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetInputResourcesCount(); ResourceIndex++)
+				{
+					FFlareFactoryFlowSnapshot Flow;
+					Flow.Resource = Factory->GetInputResource(ResourceIndex);
+					Flow.Flow = Factory->GetInputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
+					Flow.Input = true;
+					Flow.Producing = Factory->IsProducing();
+					Snapshot.Flows.Add(Flow);
+				}
+
+				for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetOutputResourcesCount(); ResourceIndex++)
+				{
+					FFlareFactoryFlowSnapshot Flow;
+					Flow.Resource = Factory->GetOutputResource(ResourceIndex);
+					Flow.Flow = Factory->GetOutputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
+					Flow.Input = false;
+					Flow.Producing = Factory->IsProducing();
+					Snapshot.Flows.Add(Flow);
+				}
+			}
+
+			StationSnapshot.FlowCount = Snapshot.Flows.Num() - StationSnapshot.FirstFlow;
+			Snapshot.Stations.Add(StationSnapshot);
+
+			// Same restrictions as UFlareCargoBay::GetResourceQuantity
+			TArray<FFlareCargo>& CargoBaySlots = Station->GetCargoBay()->GetSlots();
+			for (int32 CargoIndex = 0; CargoIndex < CargoBaySlots.Num(); CargoIndex++)
+			{
+				FFlareCargo& Cargo = CargoBaySlots[CargoIndex];
+				if (!Cargo.Resource || Cargo.Restriction == EFlareResourceRestriction::Nobody)
+				{
+					continue;
+				}
+
+				int32 Offset = StationIndex * ResourceCount + Cargo.Resource->Index;
+				Snapshot.OwnerQuantities[Offset] += Cargo.Quantity;
+				if (Cargo.Restriction != EFlareResourceRestriction::OwnerOnly)
+				{
+					Snapshot.ClientQuantities[Offset] += Cargo.Quantity;
+				}
+			}
+		}
+
+		// People consumption
+		Snapshot.Consumption.Reset();
+		Snapshot.Consumption.SetNumZeroed(ResourceCount);
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCatalog->ConsumerResources.Num(); ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &ResourceCatalog->ConsumerResources[ResourceIndex]->Data;
+			Snapshot.Consumption[Resource->Index] = Sector->GetPeople()->GetRessourceConsumption(Resource, false);
+		}
+
+		// Incoming fleets
+		Snapshot.IncomingCapacity = 0;
+		Snapshot.IncomingResources.Reset();
+		Snapshot.IncomingResources.SetNumZeroed(ResourceCount);
+		for (int32 TravelIndex = 0; TravelIndex < World->GetTravels().Num(); TravelIndex++)
+		{
+			UFlareTravel* Travel = World->GetTravels()[TravelIndex];
+			if (Travel->GetDestinationSector() != Sector)
+			{
+				continue;
+			}
+
+			int64 RemainingTravelDuration = FMath::Max((int64) 1, Travel->GetRemainingTravelDuration());
+			UFlareFleet* IncomingFleet = Travel->GetFleet();
+
+			for (int32 ShipIndex = 0; ShipIndex < IncomingFleet->GetShips().Num(); ShipIndex++)
+			{
+				UFlareSimulatedSpacecraft* Ship = IncomingFleet->GetShips()[ShipIndex];
+
+				if (Ship->GetCargoBay()->GetSlotCapacity() == 0 && Ship->GetDamageSystem()->IsStranded())
+				{
+					continue;
+				}
+				Snapshot.IncomingCapacity += Ship->GetCargoBay()->GetCapacity() / RemainingTravelDuration;
+
+				TArray<FFlareCargo>& CargoBaySlots = Ship->GetCargoBay()->GetSlots();
+				for (int32 CargoIndex = 0; CargoIndex < CargoBaySlots.Num(); CargoIndex++)
+				{
+					FFlareCargo& Cargo = CargoBaySlots[CargoIndex];
+					if (!Cargo.Resource)
+					{
+						continue;
+					}
+
+					Snapshot.IncomingResources[Cargo.Resource->Index] += Cargo.Quantity / (RemainingTravelDuration * 0.5);
+				}
+			}
+		}
+
+		// Fleet supply needs
+		Snapshot.FleetSupplyNeeds.Reset();
+		Snapshot.FleetSupplyNeeds.SetNumZeroed(World->GetCompanies().Num());
+		for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num(); CompanyIndex++)
+		{
+			UFlareCompany* Company = World->GetCompanies()[CompanyIndex];
+			int32 NeededFS;
+			int32 TotalNeededFS;
+
+			SectorHelper::GetRefillFleetSupplyNeeds(Sector, Company, NeededFS, TotalNeededFS);
+			Snapshot.FleetSupplyNeeds[CompanyIndex] += TotalNeededFS;
+
+			SectorHelper::GetRepairFleetSupplyNeeds(Sector, Company, NeededFS, TotalNeededFS);
+			Snapshot.FleetSupplyNeeds[CompanyIndex] += TotalNeededFS;
+		}
+	}
+
+	Built = true;
+}
+
+void FFlareEconomySnapshot::Reset()
+{
+	Built = false;
+}
+
+
+/*----------------------------------------------------
+	Getters
+----------------------------------------------------*/
+
+const FFlareSectorSnapshot& FFlareEconomySnapshot::GetSector(UFlareSimulatedSector* Sector) const
+{
+	FCHECK(Built);
+	FCHECK(Sectors.IsValidIndex(Sector->GetWorldIndex()));
+	return Sectors[Sector->GetWorldIndex()];
+}
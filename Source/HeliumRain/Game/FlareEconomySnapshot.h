@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Engine.h"
+#include "FlareWorldHelper.h"
+
+class AFlareGame;
+class UFlareCompany;
+class UFlareSimulatedSector;
+class UFlareSimulatedSpacecraft;
+struct FFlareResourceDescription;
+
+
+/** Resource flow of an active factory */
+struct FFlareFactoryFlowSnapshot
+{
+	FFlareResourceDescription* Resource;
+
+	/** Quantity per day */
+	int32 Flow;
+
+	bool Input;
+
+	/** The factory is currently producing */
+	bool Producing;
+};
+
+/** Economy data of a station */
+struct FFlareStationSnapshot
+{
+	UFlareSimulatedSpacecraft* Station;
+	UFlareCompany* Company;
+
+	/** Money of the station company */
+	int64 Money;
+
+	int32 SlotCapacity;
+	bool Consumer;
+	bool Maintenance;
+
+	/** Range of the station factory flows in the sector flow list */
+	int32 FirstFlow;
+	int32 FlowCount;
+};
+
+/** Economy data of a sector, independent of the company looking at it */
+struct FFlareSectorSnapshot
+{
+	UFlareSimulatedSector* Sector;
+
+	TArray<FFlareStationSnapshot> Stations;
+	TArray<FFlareFactoryFlowSnapshot> Flows;
+
+	/** Resource quantities of each station as seen by its owner and by other companies, indexed by [StationIndex * ResourceCount + ResourceIndex] */
+	TArray<int32> OwnerQuantities;
+	TArray<int32> ClientQuantities;
+
+	/** People consumption of each resource, by resource index */
+	TArray<float> Consumption;
+
+	/** Capacity and resources of the fleets travelling to the sector */
+	int32 IncomingCapacity;
+	TArray<int32> IncomingResources;
+
+	/** Fleet supply needed to refill and repair the ships of each company, by company world index */
+	TArray<int32> FleetSupplyNeeds;
+
+	/** Get the quantity of a resource in a station, as seen by a company */
+	int32 GetResourceQuantity(int32 StationIndex, FFlareResourceDescription* Resource, UFlareCompany* Company, int32 ResourceCount) const;
+};
+
+
+/** State of the world economy computed once at the start of the AI phase, shared by all companies */
+class FFlareEconomySnapshot
+{
+public:
+
+	FFlareEconomySnapshot();
+
+	/*----------------------------------------------------
+		Build
+	----------------------------------------------------*/
+
+	/** Scan the stations, travels and factories of the world */
+	void Build(AFlareGame* Game);
+
+	/** Forget the snapshot, it will be rebuilt when needed */
+	void Reset();
+
+	inline bool IsBuilt() const
+	{
+		return Built;
+	}
+
+
+	/*----------------------------------------------------
+		Getters
+	----------------------------------------------------*/
+
+	/** Get the data of a world sector */
+	const FFlareSectorSnapshot& GetSector(UFlareSimulatedSector* Sector) const;
+
+	inline const TMap<FFlareResourceDescription*, WorldHelper::FlareResourceStats>& GetWorldStats() const
+	{
+		return WorldStats;
+	}
+
+	/** Get a counter that changes each time the world stats of a resource change */
+	inline int32 GetWorldStatsVersion(FFlareResourceDescription* Resource) const
+	{
+		return WorldStatsVersions[Resource->Index];
+	}
+
+	inline int32 GetResourceCount() const
+	{
+		return ResourceCount;
+	}
+
+
+protected:
+
+	/*----------------------------------------------------
+		Data
+	----------------------------------------------------*/
+
+	bool                                 Built;
+	int32                                ResourceCount;
+
+	/** World sectors, by sector world index */
+	TArray<FFlareSectorSnapshot>         Sectors;
+
+	/** World-wide production, consumption and stock */
+	TMap<FFlareResourceDescription*, WorldHelper::FlareResourceStats> WorldStats;
+
+	/** Incremented when the world stats of a resource differ from the previous build, by resource index */
+	TArray<int32>                        WorldStatsVersions;
+
+};
+
@@ -370,8 +370,16 @@ void AFlareGame::Tick(float DeltaSeconds)
 		QuestManager->OnTick(DeltaSeconds);
 	}
 
+	// Publish the damage states once for all damages of the frame
+	if (World)
+	{
+		World->FlushDamageStates();
+	}
+
 	if(GetActiveSector() != NULL)
 	{
+		GetActiveSector()->TickShells(DeltaSeconds);
+
 		for (int CompanyIndex = 0; CompanyIndex < GetGameWorld()->GetCompanies().Num(); CompanyIndex++)
 		{
 			GetGameWorld()->GetCompanies()[CompanyIndex]->TickAI();
@@ -739,18 +747,11 @@ bool AFlareGame::SaveGame(AFlarePlayerController* PC, bool Async)
 	}
 
 	FLOGV("AFlareGame::SaveGame : saving to slot %d", CurrentSaveIndex);
-	UFlareSaveGame* Save = Cast<UFlareSaveGame>(UGameplayStatics::CreateSaveGameObject(UFlareSaveGame::StaticClass()));
+	UFlareSaveGame* Save = CreateSaveData(PC);
 	
 	// Save process
-	if (PC && Save)
+	if (Save)
 	{
-		// Save the player
-		PC->Save(Save->PlayerData, Save->PlayerCompanyDescription);
-		Save->WorldData = *World->Save();
-		Save->CurrentImmatriculationIndex = CurrentImmatriculationIndex;
-		Save->CurrentIdentifierIndex = CurrentIdentifierIndex;
-		Save->PlayerData.QuestData = *QuestManager->Save();
-
 		FLOGV("AFlareGame::SaveGame date=%lld", Save->WorldData.Date);
 		// Save
 		FString SaveName = "SaveSlot" + FString::FromInt(CurrentSaveIndex);
@@ -779,6 +780,24 @@ bool AFlareGame::SaveGame(AFlarePlayerController* PC, bool Async)
 	}
 }
 
+UFlareSaveGame* AFlareGame::CreateSaveData(AFlarePlayerController* PC)
+{
+	UFlareSaveGame* Save = Cast<UFlareSaveGame>(UGameplayStatics::CreateSaveGameObject(UFlareSaveGame::StaticClass()));
+
+	if (PC && Save)
+	{
+		// Save the player
+		PC->Save(Save->PlayerData, Save->PlayerCompanyDescription);
+		Save->WorldData = *World->Save();
+		Save->CurrentImmatriculationIndex = CurrentImmatriculationIndex;
+		Save->CurrentIdentifierIndex = CurrentIdentifierIndex;
+		Save->PlayerData.QuestData = *QuestManager->Save();
+		return Save;
+	}
+
+	return NULL;
+}
+
 void AFlareGame::UnloadGame()
 {
 	FLOG("AFlareGame::UnloadGame");
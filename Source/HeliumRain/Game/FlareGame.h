@@ -126,6 +126,9 @@ public:
 	/** Save the world to this save file */
 	virtual bool SaveGame(AFlarePlayerController* PC, bool Async);
 
+	/** Build the save data of the current game */
+	UFlareSaveGame* CreateSaveData(AFlarePlayerController* PC);
+
 	/** Unload the game*/
 	virtual void UnloadGame();
 	
@@ -293,6 +296,9 @@ protected:
 	UPROPERTY()
 	TArray<FFlareSaveSlotInfo>                 SaveSlots;
 
+	/** Damage state changes of all spacecrafts */
+	FFlareDamageStateChanged                   DamageStateChanged;
+
 
 public:
 	
@@ -342,6 +348,11 @@ public:
 		return QuestManager;
 	}
 
+	UFlareSaveGameSystem* GetSaveGameSystem() const
+	{
+		return SaveGameSystem;
+	}
+
 	inline const FFlareCompanyDescription* GetCompanyDescription(int32 Index) const
 	{
 		return (CompanyCatalog ? &CompanyCatalog->Companies[Index] : NULL);
@@ -446,5 +457,11 @@ public:
 		return IsLoadingStreamingLevel;
 	}
 
+	/** Event broadcast when a spacecraft is destroyed, disarmed, stranded or becomes uncontrollable, or recovers */
+	FFlareDamageStateChanged& OnDamageStateChanged()
+	{
+		return DamageStateChanged;
+	}
+
 
 };
@@ -6,10 +6,22 @@
 #include "../Player/FlarePlayerController.h"
 #include "FlareCompany.h"
 #include "FlareSectorHelper.h"
+#include "Save/FlareSaveGameSystem.h"
+#include "Log/FlareLogWriter.h"
 
 #define LOCTEXT_NAMESPACE "FlareGameTools"
 
 bool UFlareGameTools::FastFastForward = false;
+bool UFlareGameTools::ParallelSimulation = true;
+bool UFlareGameTools::DeterministicSimulation = false;
+bool UFlareGameTools::BinarySaveGames = false;
+bool UFlareGameTools::CompressSaveGames = true;
+bool UFlareGameTools::BinaryLogs = false;
+int32 UFlareGameTools::PilotDecisionBudget = 2000;
+bool UFlareGameTools::ParallelPilots = false;
+bool UFlareGameTools::IndexedTradeDeals = false;
+bool UFlareGameTools::CheckTradeDeals = false;
+int32 UFlareGameTools::AIPlanningPeriod = 1;
 
 /*----------------------------------------------------
 	Constructor
@@ -433,6 +445,243 @@ void UFlareGameTools::SetFastFastForward(bool FFF)
 	FastFastForward = FFF;
 }
 
+void UFlareGameTools::SetParallelSimulation(bool Parallel)
+{
+	ParallelSimulation = Parallel;
+}
+
+void UFlareGameTools::SetDeterministicSimulation(bool Deterministic)
+{
+	DeterministicSimulation = Deterministic;
+}
+
+void UFlareGameTools::SetBinarySaveGames(bool Binary)
+{
+	BinarySaveGames = Binary;
+}
+
+void UFlareGameTools::SetCompressSaveGames(bool Compress)
+{
+	CompressSaveGames = Compress;
+}
+
+void UFlareGameTools::SetBinaryLogs(bool Binary)
+{
+	BinaryLogs = Binary;
+}
+
+void UFlareGameTools::ConvertBinaryLog(FString FileName)
+{
+	FString BinaryFileName = FString::Printf(TEXT("%s/SaveGames/%s"), *FPaths::GameSavedDir(), *FileName);
+	FFlareLogWriter::ConvertBinaryLog(BinaryFileName, FPaths::ChangeExtension(BinaryFileName, TEXT("txt")));
+}
+
+void UFlareGameTools::SetParallelPilots(bool Parallel)
+{
+	ParallelPilots = Parallel;
+}
+
+void UFlareGameTools::SetIndexedTradeDeals(bool Indexed)
+{
+	IndexedTradeDeals = Indexed;
+}
+
+void UFlareGameTools::SetCheckTradeDeals(bool Check)
+{
+	CheckTradeDeals = Check;
+}
+
+void UFlareGameTools::SetPilotDecisionBudget(int32 Microseconds)
+{
+	PilotDecisionBudget = Microseconds;
+}
+
+void UFlareGameTools::SetAIPlanningPeriod(int32 Days)
+{
+	AIPlanningPeriod = FMath::Max(1, Days);
+}
+
+void UFlareGameTools::BenchmarkSaveFormats(int32 Days, int32 ScenarioIndex)
+{
+	// The benchmark world replaces the loaded game, which could then be saved over the player slot
+	if (GetGame()->IsLoadedOrCreated())
+	{
+		FLOG("AFlareGame::BenchmarkSaveFormats failed: a game is loaded, run it from the main menu");
+		return;
+	}
+
+	// Generate a new world
+	GetGame()->CreateGame(GetPC(), LOCTEXT("BenchmarkCompany", "Benchmark"), ScenarioIndex, false);
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::BenchmarkSaveFormats failed: can't create the world");
+		return;
+	}
+
+	// Grow the world
+	FLOGV("AFlareGame::BenchmarkSaveFormats : simulating %d days of scenario %d", Days, ScenarioIndex);
+	GetGame()->DeactivateSector();
+	for (int32 Day = 0; Day < Days; Day++)
+	{
+		GetGameWorld()->Simulate();
+	}
+	GetGame()->ActivateCurrentSector();
+
+	UFlareSaveGame* Save = GetGame()->CreateSaveData(GetPC());
+	if (Save)
+	{
+		GetGame()->GetSaveGameSystem()->BenchmarkSaveFormats(Save);
+	}
+
+	// Don't leave the benchmark world loaded
+	GetGame()->UnloadGame();
+}
+
+void UFlareGameTools::BenchmarkSimulation(int32 Days, int32 SaveSlot, int32 ScenarioIndex)
+{
+	if (Days <= 0)
+	{
+		FLOG("UFlareGameTools::BenchmarkSimulation failed: invalid day count");
+		return;
+	}
+
+	if (GetActiveSector())
+	{
+		FLOG("UFlareGameTools::BenchmarkSimulation failed: a sector is active");
+		return;
+	}
+
+	// Load the world to simulate
+	if (SaveSlot > 0)
+	{
+		GetGame()->SetCurrentSlot(SaveSlot);
+		if (!GetGame()->LoadGame(GetPC()))
+		{
+			FLOGV("UFlareGameTools::BenchmarkSimulation failed: can't load slot %d", SaveSlot);
+			return;
+		}
+	}
+	else if (SaveSlot == 0)
+	{
+		GetGame()->CreateGame(GetPC(), LOCTEXT("BenchmarkCompany", "Benchmark"), ScenarioIndex, false);
+	}
+
+	UFlareWorld* World = GetGameWorld();
+	if (!World)
+	{
+		FLOG("UFlareGameTools::BenchmarkSimulation failed: no loaded world");
+		return;
+	}
+
+	const TArray<UFlareCompany*>& Companies = World->GetCompanies();
+	int64 StartDate = World->GetDate();
+	FLOGV("UFlareGameTools::BenchmarkSimulation : simulating %d days from day %lld (parallel %d, deterministic %d)",
+		Days, StartDate, ParallelSimulation, DeterministicSimulation);
+
+	// CSV header
+	FString Csv = "Day,Total,Battles,AI,Factories,People,TradeRoutes,Travels,Prices,Other,WorldMoney,WorldPopulation";
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		Csv += FString::Printf(TEXT(",AI_%s"), *Companies[CompanyIndex]->GetShortName().ToString());
+	}
+	Csv += LINE_TERMINATOR;
+
+	FFlareWorldSimulationTimings TotalTimings;
+	TotalTimings.CompanyAI.Init(0, Companies.Num());
+
+	// Simulate
+	for (int32 Day = 0; Day < Days; Day++)
+	{
+		World->Simulate();
+
+		const FFlareWorldSimulationTimings& Timings = World->GetSimulationTimings();
+		double OtherTime = Timings.Total - Timings.Battles - Timings.AI - Timings.Factories - Timings.People
+			- Timings.TradeRoutes - Timings.Travels - Timings.Prices;
+
+		Csv += FString::Printf(TEXT("%lld,%f,%f,%f,%f,%f,%f,%f,%f,%f,%lld,%u"),
+			World->GetDate(), Timings.Total, Timings.Battles, Timings.AI, Timings.Factories, Timings.People,
+			Timings.TradeRoutes, Timings.Travels, Timings.Prices, OtherTime,
+			World->GetWorldMoney(), World->GetWorldPopulation());
+
+		for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+		{
+			double CompanyTime = Timings.CompanyAI.IsValidIndex(CompanyIndex) ? Timings.CompanyAI[CompanyIndex] : 0;
+			TotalTimings.CompanyAI[CompanyIndex] += CompanyTime;
+			Csv += FString::Printf(TEXT(",%f"), CompanyTime);
+		}
+		Csv += LINE_TERMINATOR;
+
+		TotalTimings.Battles += Timings.Battles;
+		TotalTimings.AI += Timings.AI;
+		TotalTimings.Factories += Timings.Factories;
+		TotalTimings.People += Timings.People;
+		TotalTimings.TradeRoutes += Timings.TradeRoutes;
+		TotalTimings.Travels += Timings.Travels;
+		TotalTimings.Prices += Timings.Prices;
+		TotalTimings.Total += Timings.Total;
+	}
+
+	// Checksums, to compare the outcome of two runs
+	uint32 MoneyChecksum = 0;
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		MoneyChecksum = HashCombine(MoneyChecksum, GetTypeHash(Companies[CompanyIndex]->GetMoney()));
+	}
+
+	uint32 PopulationChecksum = 0;
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		UFlarePeople* People = World->GetSectors()[SectorIndex]->GetPeople();
+		MoneyChecksum = HashCombine(MoneyChecksum, GetTypeHash(People->GetMoney()));
+		PopulationChecksum = HashCombine(PopulationChecksum, GetTypeHash(People->GetPopulation()));
+	}
+
+	// Summary
+	TSharedRef<FJsonObject> Summary = MakeShareable(new FJsonObject());
+	Summary->SetNumberField("StartDate", StartDate);
+	Summary->SetNumberField("Days", Days);
+	Summary->SetBoolField("ParallelSimulation", ParallelSimulation);
+	Summary->SetBoolField("DeterministicSimulation", DeterministicSimulation);
+	Summary->SetNumberField("TotalTime", TotalTimings.Total);
+	Summary->SetNumberField("DayTime", TotalTimings.Total / Days);
+
+	TSharedRef<FJsonObject> Phases = MakeShareable(new FJsonObject());
+	Phases->SetNumberField("Battles", TotalTimings.Battles);
+	Phases->SetNumberField("AI", TotalTimings.AI);
+	Phases->SetNumberField("Factories", TotalTimings.Factories);
+	Phases->SetNumberField("People", TotalTimings.People);
+	Phases->SetNumberField("TradeRoutes", TotalTimings.TradeRoutes);
+	Phases->SetNumberField("Travels", TotalTimings.Travels);
+	Phases->SetNumberField("Prices", TotalTimings.Prices);
+	Summary->SetObjectField("Phases", Phases);
+
+	TSharedRef<FJsonObject> CompanyAI = MakeShareable(new FJsonObject());
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		CompanyAI->SetNumberField(Companies[CompanyIndex]->GetShortName().ToString(), TotalTimings.CompanyAI[CompanyIndex]);
+	}
+	Summary->SetObjectField("CompanyAI", CompanyAI);
+
+	Summary->SetNumberField("WorldMoney", World->GetWorldMoney());
+	Summary->SetNumberField("WorldPopulation", World->GetWorldPopulation());
+	Summary->SetStringField("MoneyChecksum", FString::Printf(TEXT("%08x"), MoneyChecksum));
+	Summary->SetStringField("PopulationChecksum", FString::Printf(TEXT("%08x"), PopulationChecksum));
+
+	FString Json;
+	TSharedRef< TJsonWriter<> > JsonWriter = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Summary, JsonWriter);
+	JsonWriter->Close();
+
+	// Write results
+	FString BasePath = FString::Printf(TEXT("%s/Benchmarks/Simulation-%s"), *FPaths::GameSavedDir(), *FDateTime::Now().ToString());
+	FFileHelper::SaveStringToFile(Csv, *(BasePath + ".csv"));
+	FFileHelper::SaveStringToFile(Json, *(BasePath + ".json"));
+
+	FLOGV("UFlareGameTools::BenchmarkSimulation : %d days in %.3fs (%.6fs per day), money %lld (%08x), population %u (%08x), results in %s",
+		Days, TotalTimings.Total, TotalTimings.Total / Days,
+		World->GetWorldMoney(), MoneyChecksum, World->GetWorldPopulation(), PopulationChecksum, *BasePath);
+}
+
 /*----------------------------------------------------
 	Company tools
 ----------------------------------------------------*/
@@ -75,6 +75,59 @@ public:
 	UFUNCTION(exec)
 	void SetFastFastForward(bool FFF);
 
+	/** Run sector-local simulation phases on worker threads */
+	UFUNCTION(exec)
+	void SetParallelSimulation(bool Parallel);
+
+	/** Seed sector random streams from the date so that a day always simulates the same way */
+	UFUNCTION(exec)
+	void SetDeterministicSimulation(bool Deterministic);
+
+	/** Save games in the binary format instead of json */
+	UFUNCTION(exec)
+	void SetBinarySaveGames(bool Binary);
+
+	/** Compress binary save games */
+	UFUNCTION(exec)
+	void SetCompressSaveGames(bool Compress);
+
+	/** Write game and combat logs in the binary format, from the next loaded game */
+	UFUNCTION(exec)
+	void SetBinaryLogs(bool Binary);
+
+	/** Convert a binary log from Saved/SaveGames to a text log next to it */
+	UFUNCTION(exec)
+	void ConvertBinaryLog(FString FileName);
+
+	/** Compute AI ship pilot decisions on worker threads from a snapshot of the sector */
+	UFUNCTION(exec)
+	void SetParallelPilots(bool Parallel);
+
+	/** Set the per-frame time budget of AI pilot decisions in microseconds, 0 to run every decision immediately */
+	UFUNCTION(exec)
+	void SetPilotDecisionBudget(int32 Microseconds);
+
+	/** Search AI trade deals in the per-day trade deal index instead of checking every sector pair */
+	UFUNCTION(exec)
+	void SetIndexedTradeDeals(bool Indexed);
+
+	/** Check each indexed AI trade deal against the exhaustive search, and log mismatches */
+	UFUNCTION(exec)
+	void SetCheckTradeDeals(bool Check);
+
+	/** Run AI strategic planning every N days, staggered across companies, 1 to plan every day */
+	UFUNCTION(exec)
+	void SetAIPlanningPeriod(int32 Days);
+
+	/** From the main menu, generate a new world from a scenario and simulate it to grow it, then measure save and load of the json and binary save formats */
+	UFUNCTION(exec)
+	void BenchmarkSaveFormats(int32 Days, int32 ScenarioIndex);
+
+	/** Simulate a world duration from a save slot (SaveSlot > 0), a new scenario (SaveSlot = 0) or the current world (SaveSlot < 0),
+	    then write per-phase timings and world checksums to Saved/Benchmarks */
+	UFUNCTION(exec)
+	void BenchmarkSimulation(int32 Days, int32 SaveSlot, int32 ScenarioIndex);
+
 	/*----------------------------------------------------
 		Company tools
 	----------------------------------------------------*/
@@ -287,4 +340,24 @@ public:
 
 	static bool FastFastForward;
 
+	static bool ParallelSimulation;
+
+	static bool DeterministicSimulation;
+
+	static bool BinarySaveGames;
+
+	static bool CompressSaveGames;
+
+	static bool BinaryLogs;
+
+	static int32 PilotDecisionBudget;
+
+	static bool ParallelPilots;
+
+	static bool IndexedTradeDeals;
+
+	static bool CheckTradeDeals;
+
+	static int32 AIPlanningPeriod;
+
 };
@@ -0,0 +1,165 @@
+
+#include "../Flare.h"
+#include "FlarePilotScheduler.h"
+#include "FlareGameTools.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("PilotScheduler Decisions"), STAT_FlarePilotScheduler_Decisions, STATGROUP_Flare);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PilotScheduler Deferred"), STAT_FlarePilotScheduler_Deferred, STATGROUP_Flare);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("PilotScheduler Budget overruns"), STAT_FlarePilotScheduler_Overruns, STATGROUP_Flare);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("PilotScheduler Decision time (us)"), STAT_FlarePilotScheduler_DecisionTime, STATGROUP_Flare);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("PilotScheduler Max latency (ms)"), STAT_FlarePilotScheduler_MaxLatency, STATGROUP_Flare);
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+FFlarePilotScheduler::FFlarePilotScheduler()
+	: BucketCount(4)
+	, MaxDecisionLatency(1.0f)
+	, NextBucket(0)
+{
+	Reset();
+}
+
+
+/*----------------------------------------------------
+	Scheduling
+----------------------------------------------------*/
+
+void FFlarePilotScheduler::Reset()
+{
+	Frame = 0;
+	FrameDecisionTime = 0;
+	DecisionStartTime = 0;
+	Batching = false;
+	BatchDecisionCount = 0;
+	EstimatedDecisionTime = 0.00002;
+	OverrunCount = 0;
+	MaxLatency = 0;
+}
+
+bool FFlarePilotScheduler::RequestDecision(FFlarePilotDecisionState& State, float Time)
+{
+	UpdateFrame();
+
+	if (State.Bucket == INDEX_NONE)
+	{
+		State.Bucket = NextBucket;
+		NextBucket = (NextBucket + 1) % BucketCount;
+	}
+
+	if (!State.Pending)
+	{
+		State.Pending = true;
+		State.RequestTime = Time;
+	}
+
+	// No budget means no scheduling
+	double Budget = UFlareGameTools::PilotDecisionBudget / 1000000.0;
+	float Latency = Time - State.RequestTime;
+	bool Granted = false;
+
+	if (Budget <= 0 || Latency >= MaxDecisionLatency)
+	{
+		Granted = true;
+	}
+	else if ((Frame % BucketCount) == State.Bucket || State.MissedSlice)
+	{
+		if (FrameDecisionTime < Budget)
+		{
+			Granted = true;
+		}
+		else
+		{
+			State.MissedSlice = true;
+		}
+	}
+
+	if (!Granted)
+	{
+		INC_DWORD_STAT(STAT_FlarePilotScheduler_Deferred);
+		return false;
+	}
+
+	State.Pending = false;
+	State.MissedSlice = false;
+	State.LastLatency = Latency;
+
+	if (Latency > MaxLatency)
+	{
+		MaxLatency = Latency;
+		SET_FLOAT_STAT(STAT_FlarePilotScheduler_MaxLatency, MaxLatency * 1000);
+	}
+
+	INC_DWORD_STAT(STAT_FlarePilotScheduler_Decisions);
+
+	// Batched decisions run later, charge their estimated cost now so that the budget applies
+	if (Batching)
+	{
+		FrameDecisionTime += EstimatedDecisionTime;
+		BatchDecisionCount++;
+	}
+
+	DecisionStartTime = FPlatformTime::Seconds();
+	return true;
+}
+
+void FFlarePilotScheduler::EndDecision()
+{
+	AddDecisionTime(FPlatformTime::Seconds() - DecisionStartTime);
+}
+
+void FFlarePilotScheduler::AddDecisionTime(double DecisionTime)
+{
+	FrameDecisionTime += DecisionTime;
+	INC_FLOAT_STAT_BY(STAT_FlarePilotScheduler_DecisionTime, DecisionTime * 1000000);
+}
+
+void FFlarePilotScheduler::BeginBatch()
+{
+	UpdateFrame();
+
+	Batching = true;
+	BatchDecisionCount = 0;
+}
+
+void FFlarePilotScheduler::EndBatch(double BatchTime)
+{
+	FCHECK(Batching);
+
+	FrameDecisionTime -= BatchDecisionCount * EstimatedDecisionTime;
+	AddDecisionTime(BatchTime);
+
+	if (BatchDecisionCount > 0)
+	{
+		EstimatedDecisionTime = 0.8 * EstimatedDecisionTime + 0.2 * (BatchTime / BatchDecisionCount);
+	}
+
+	Batching = false;
+	BatchDecisionCount = 0;
+}
+
+
+/*----------------------------------------------------
+	Internal
+----------------------------------------------------*/
+
+void FFlarePilotScheduler::UpdateFrame()
+{
+	if (Frame == GFrameCounter)
+	{
+		return;
+	}
+
+	// Close the previous frame
+	double Budget = UFlareGameTools::PilotDecisionBudget / 1000000.0;
+	if (Budget > 0 && FrameDecisionTime > Budget)
+	{
+		OverrunCount++;
+		INC_DWORD_STAT(STAT_FlarePilotScheduler_Overruns);
+	}
+
+	Frame = GFrameCounter;
+	FrameDecisionTime = 0;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Engine.h"
+#include "../Spacecrafts/FlareSpacecraftTypes.h"
+
+class AFlareSpacecraft;
+class UFlareCompany;
+
+
+/** Scheduling state of a pilot, owned by the pilot */
+struct FFlarePilotDecisionState
+{
+	/** Frame slice in which this pilot decides, INDEX_NONE until the first request */
+	int32 Bucket;
+
+	/** A decision was requested and not granted yet */
+	bool Pending;
+
+	/** The pilot slice was skipped because the budget was spent */
+	bool MissedSlice;
+
+	/** Game time of the pending request */
+	float RequestTime;
+
+	/** Time between the request and the grant of the last decision, in seconds */
+	float LastLatency;
+
+	FFlarePilotDecisionState()
+		: Bucket(INDEX_NONE)
+		, Pending(false)
+		, MissedSlice(false)
+		, RequestTime(0)
+		, LastLatency(0)
+	{}
+};
+
+
+/** Copy of the state of a spacecraft taken once per frame, read by pilot decisions on worker threads */
+struct FFlarePilotShipState
+{
+	AFlareSpacecraft*                    Ship;
+	UFlareCompany*                       Company;
+
+	/** Target of the ship pilot */
+	AFlareSpacecraft*                    PilotTarget;
+
+	FVector                              Location;
+	FVector                              Velocity;
+	float                                MeshScale;
+	EFlarePartSize::Type                 Size;
+
+	bool                                 Alive;
+	bool                                 Station;
+	bool                                 Military;
+	bool                                 Dangerous;
+	bool                                 Stranded;
+	bool                                 Uncontrollable;
+	bool                                 Disarmed;
+	bool                                 Harpooned;
+};
+
+
+/** Spread the decision logic of AI pilots over frames, within a per-frame time budget */
+class FFlarePilotScheduler
+{
+public:
+
+	FFlarePilotScheduler();
+
+	/*----------------------------------------------------
+		Scheduling
+	----------------------------------------------------*/
+
+	/** Forget the current frame and statistics */
+	void Reset();
+
+	/** Ask to run the decision logic of a pilot this frame. If true is returned, EndDecision must be called when the decision is done */
+	bool RequestDecision(FFlarePilotDecisionState& State, float Time);
+
+	/** Account the time spent in the decision granted by the last RequestDecision */
+	void EndDecision();
+
+	/** Account the time spent in decisions that were run together */
+	void AddDecisionTime(double DecisionTime);
+
+	/** Start granting decisions that will run together : each grant is charged an estimated cost until EndBatch */
+	void BeginBatch();
+
+	/** Replace the estimated cost of the batch by its real duration, and update the estimate */
+	void EndBatch(double BatchTime);
+
+
+	/*----------------------------------------------------
+		Getters
+	----------------------------------------------------*/
+
+	/** Number of frames whose decisions took longer than the budget */
+	inline int32 GetOverrunCount() const
+	{
+		return OverrunCount;
+	}
+
+	/** Highest decision latency since the last reset, in seconds */
+	inline float GetMaxLatency() const
+	{
+		return MaxLatency;
+	}
+
+
+protected:
+
+	/*----------------------------------------------------
+		Internal
+	----------------------------------------------------*/
+
+	/** Close the previous frame if a new one started */
+	void UpdateFrame();
+
+
+	/*----------------------------------------------------
+		Data
+	----------------------------------------------------*/
+
+	/** Number of frame slices pilots are spread on */
+	int32                                BucketCount;
+
+	/** Decisions delayed longer than this are run regardless of the budget, in seconds */
+	float                                MaxDecisionLatency;
+
+	/** Bucket of the next new pilot */
+	int32                                NextBucket;
+
+	/** Current frame */
+	uint64                               Frame;
+	double                               FrameDecisionTime;
+
+	/** Start of the running decision */
+	double                               DecisionStartTime;
+
+	/** Decisions granted in the running batch */
+	bool                                 Batching;
+	int32                                BatchDecisionCount;
+
+	/** Moving average of the cost of a decision in a batch, in seconds */
+	double                               EstimatedDecisionTime;
+
+	// Statistics
+	int32                                OverrunCount;
+	float                                MaxLatency;
+
+};
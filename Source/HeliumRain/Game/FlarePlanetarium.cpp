@@ -105,20 +105,21 @@ void AFlarePlanetarium::Tick(float DeltaSeconds)
 			do
 			{
 
-				Sun = World->GetPlanerarium()->GetSnapShot(LocalTime, SmoothTime);
+				const FFlarePlanetariumSnapshot& Snapshot = World->GetPlanerarium()->GetSnapShot(LocalTime, SmoothTime);
 
 				// Draw Player
 				FFlareSectorOrbitParameters* PlayerOrbit = GetGame()->GetActiveSector()->GetSimulatedSector()->GetOrbitParameters();
 
 
-				FFlareCelestialBody* CurrentParent = World->GetPlanerarium()->FindCelestialBody(PlayerOrbit->CelestialBodyIdentifier);
-				if (CurrentParent)
+				int32 CurrentParentIndex = Snapshot.FindBodyIndex(PlayerOrbit->CelestialBodyIdentifier);
+				if (CurrentParentIndex != INDEX_NONE)
 				{
-					FPreciseVector ParentLocation = CurrentParent->AbsoluteLocation;
+					const FFlareCelestialBody* CurrentParent = Snapshot.Bodies[CurrentParentIndex].Body;
+					FPreciseVector ParentLocation = Snapshot.Bodies[CurrentParentIndex].AbsoluteLocation;
 
 					double DistanceToParentCenter = CurrentParent->Radius + PlayerOrbit->Altitude;
 					FPreciseVector PlayerLocation =  ParentLocation + World->GetPlanerarium()->GetRelativeLocation(CurrentParent, LocalTime, SmoothTime, DistanceToParentCenter, 0, PlayerOrbit->Phase);
-					/*FLOGV("Parent location = %s", *CurrentParent->AbsoluteLocation.ToString());
+					/*FLOGV("Parent location = %s", *ParentLocation.ToString());
 					FLOGV("PlayerLocation = %s", *PlayerLocation.ToString());*/
 #ifdef PLANETARIUM_DEBUG
 					DrawDebugLine(GetWorld(), FVector(1000, 0 ,0), FVector(- 1000, 0 ,0), FColor::Red, false);
@@ -127,7 +128,7 @@ void AFlarePlanetarium::Tick(float DeltaSeconds)
 					DrawDebugLine(GetWorld(), FVector(0, 0, 900), FVector(0, 0, 1000), FColor::Cyan, false);
 #endif
 					FPreciseVector DeltaLocation = ParentLocation - PlayerLocation;
-					FPreciseVector SunDeltaLocation = Sun.AbsoluteLocation - PlayerLocation;
+					FPreciseVector SunDeltaLocation = Snapshot.Bodies[0].AbsoluteLocation - PlayerLocation;
 
 					float AngleOffset =  90 + FMath::RadiansToDegrees(FMath::Atan2(DeltaLocation.Z,DeltaLocation.X));
 					/*FLOGV("DeltaLocation = %s", *DeltaLocation.ToString());
@@ -140,7 +141,10 @@ void AFlarePlanetarium::Tick(float DeltaSeconds)
 					MinDistance = DistanceToParentCenter;
 
 					BodyPositions.Empty();
-					PrepareCelestialBody(&Sun, -PlayerLocation, AngleOffset);
+					for (int32 BodyIndex = 0; BodyIndex < Snapshot.Bodies.Num(); BodyIndex++)
+					{
+						PrepareCelestialBody(Snapshot.Bodies[BodyIndex], -PlayerLocation, AngleOffset);
+					}
 					SetupCelestialBodies();
 
 					// Try to find night
@@ -314,13 +318,13 @@ void AFlarePlanetarium::SetupCelestialBody(CelestialBodyPosition* BodyPosition,
 	}
 
 	// Sun also rotates to track direction
-	if (BodyPosition->Body == &Sun)
+	if (BodyPosition->IsSun)
 	{
 		BodyPosition->BodyComponent->SetRelativeRotation(SunDirection.ToVector().Rotation());
 	}
 
 	// Compute sun occlusion
-	if (BodyPosition->Body != &Sun)
+	if (!BodyPosition->IsSun)
 	{
 		double OcclusionAngle = FPreciseMath::Asin(BodyPosition->Radius / BodyPosition->Distance);
 
@@ -384,16 +388,18 @@ void AFlarePlanetarium::SetupCelestialBody(CelestialBodyPosition* BodyPosition,
 
 }
 
-void AFlarePlanetarium::PrepareCelestialBody(FFlareCelestialBody* Body, FPreciseVector Offset, double AngleOffset)
+void AFlarePlanetarium::PrepareCelestialBody(const FFlareCelestialBodyState& BodyState, FPreciseVector Offset, double AngleOffset)
 {
 	CelestialBodyPosition BodyPosition;
+	const FFlareCelestialBody* Body = BodyState.Body;
 
 	BodyPosition.Body = Body;
-	FPreciseVector Location = Offset + Body->AbsoluteLocation;
+	BodyPosition.IsSun = (BodyState.ParentIndex == INDEX_NONE);
+	FPreciseVector Location = Offset + BodyState.AbsoluteLocation;
 	BodyPosition.AlignedLocation = Location.RotateAngleAxis(AngleOffset, FPreciseVector(0,1,0));
 	BodyPosition.Radius = Body->Radius;
 	BodyPosition.Distance = BodyPosition.AlignedLocation.Size();
-	BodyPosition.TotalRotation = Body->RotationAngle + AngleOffset;
+	BodyPosition.TotalRotation = BodyState.RotationAngle + AngleOffset;
 
 	// Find the celestial body component
 	UStaticMeshComponent* BodyComponent = NULL;
@@ -419,17 +425,11 @@ void AFlarePlanetarium::PrepareCelestialBody(FFlareCelestialBody* Body, FPrecise
 	}
 
 
-	if (Body == &Sun)
+	if (BodyPosition.IsSun)
 	{
 		SunOcclusionAngle = FPreciseMath::Asin(BodyPosition.Radius / BodyPosition.Distance);
 		SunPhase = FMath::UnwindRadians(FMath::Atan2(BodyPosition.AlignedLocation.Z, BodyPosition.AlignedLocation.X));
 	}
-
-	for (int SatteliteIndex = 0; SatteliteIndex < Body->Sattelites.Num(); SatteliteIndex++)
-	{
-		FFlareCelestialBody* CelestialBody = &Body->Sattelites[SatteliteIndex];
-		PrepareCelestialBody(CelestialBody, Offset, AngleOffset);
-	}
 }
 
 void AFlarePlanetarium::ResetTime()
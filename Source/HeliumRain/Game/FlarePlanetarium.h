@@ -8,7 +8,8 @@
 struct CelestialBodyPosition
 {
 	UStaticMeshComponent* BodyComponent;
-	FFlareCelestialBody* Body;
+	const FFlareCelestialBody* Body;
+	bool IsSun;
 	double Distance;
 	double Radius;
 	double TotalRotation;
@@ -34,7 +35,7 @@ public:
 	void BeginPlay() override;
 
 	/** Prepare a celestial body to future setup */
-	void PrepareCelestialBody(FFlareCelestialBody* Body, FPreciseVector Offset, double AngleOffset);
+	void PrepareCelestialBody(const FFlareCelestialBodyState& BodyState, FPreciseVector Offset, double AngleOffset);
 
 	void SetupCelestialBodies();
 
@@ -85,8 +86,6 @@ protected:
 
 	FName CurrentSector;
 
-	FFlareCelestialBody Sun;
-
 	double SunOcclusion;
 	double MinDistance;
 
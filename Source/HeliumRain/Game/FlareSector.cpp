@@ -5,7 +5,12 @@
 #include "FlareCollider.h"
 #include "../Spacecrafts/FlareShell.h"
 #include "../Spacecrafts/FlareSpacecraft.h"
+#include "../Spacecrafts/FlareShipPilot.h"
+#include "../Spacecrafts/FlarePilotHelper.h"
 #include "../Player/FlarePlayerController.h"
+#include "FlareGameTools.h"
+
+DECLARE_CYCLE_STAT(TEXT("FlareSector PilotDecisions"), STAT_FlareSector_PilotDecisions, STATGROUP_Flare);
 
 
 /*----------------------------------------------------
@@ -17,6 +22,8 @@ UFlareSector::UFlareSector(const FObjectInitializer& ObjectInitializer)
 {
 	SectorRepartitionCache = false;
 	IsDestroyingSector = false;
+	SpatialIndexFrame = MAX_uint64;
+	PilotDecisionFrame = MAX_uint64;
 }
 
 /*----------------------------------------------------
@@ -29,6 +36,9 @@ void UFlareSector::Load(UFlareSimulatedSector* Parent)
 	ParentSector = Parent;
 	LocalTime = Parent->GetData()->LocalTime;
 
+	// Colliders are part of the sector level, which is loaded before the sector
+	UGameplayStatics::GetAllActorsOfClass(GetGame()->GetWorld(), AFlareCollider::StaticClass(), SectorColliders);
+
 	// Load asteroids
 	for (int i = 0 ; i < ParentSector->GetData()->AsteroidData.Num(); i++)
 	{
@@ -118,12 +128,23 @@ void UFlareSector::DestroySector()
 		SectorShells[ShellIndex]->Destroy();
 	}
 
+	for (int ShellIndex = 0 ; ShellIndex < FreeShells.Num(); ShellIndex++)
+	{
+		FreeShells[ShellIndex]->Destroy();
+	}
+
 	SectorSpacecrafts.Empty();
 	SectorShips.Empty();
 	SectorStations.Empty();
 	SectorBombs.Empty();
 	SectorAsteroids.Empty();
 	SectorShells.Empty();
+	FreeShells.Empty();
+	SectorColliders.Empty();
+	SpatialIndex.Reset();
+	PilotSnapshot.Empty();
+	InvalidateSpatialIndex();
+	PilotScheduler.Reset();
 
 	IsDestroyingSector = false;
 }
@@ -144,6 +165,7 @@ AFlareAsteroid* UFlareSector::LoadAsteroid(const FFlareAsteroidSave& AsteroidDat
 
 	// TODO Check double add
 	SectorAsteroids.Add(Asteroid);
+	InvalidateSpatialIndex();
     return Asteroid;
 }
 
@@ -173,6 +195,7 @@ AFlareSpacecraft* UFlareSector::LoadSpacecraft(UFlareSimulatedSpacecraft* Parent
 			SectorShips.Add(Spacecraft);
 		}
 		SectorSpacecrafts.Add(Spacecraft);
+		InvalidateSpatialIndex();
 
 		switch (ParentSpacecraft->GetData().SpawnMode)
 		{
@@ -396,16 +419,59 @@ void UFlareSector::UnregisterBomb(AFlareBomb* Bomb)
 	}
 }
 
-void UFlareSector::RegisterShell(AFlareShell* Shell)
+AFlareShell* UFlareSector::AcquireShell(FVector Location, const FActorSpawnParameters& SpawnParams)
+{
+	AFlareShell* Shell = NULL;
+
+	if (FreeShells.Num())
+	{
+		Shell = FreeShells.Pop(false);
+		Shell->SetActorLocationAndRotation(Location, FRotator::ZeroRotator);
+		Shell->Instigator = SpawnParams.Instigator;
+		Shell->CustomTimeDilation = 1.0f;
+		Shell->SetActorHiddenInGame(false);
+	}
+	else
+	{
+		Shell = GetGame()->GetWorld()->SpawnActor<AFlareShell>(AFlareShell::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+	}
+
+	if (Shell)
+	{
+		SectorShells.Add(Shell);
+	}
+	return Shell;
+}
+
+void UFlareSector::ReleaseShell(AFlareShell* Shell)
 {
-	SectorShells.AddUnique(Shell);
+	if (Shell->IsShellActive())
+	{
+		Shell->Deactivate();
+		SectorShells.RemoveSingleSwap(Shell);
+		FreeShells.Add(Shell);
+	}
 }
 
 void UFlareSector::UnregisterShell(AFlareShell* Shell)
 {
 	if (!IsDestroyingSector)
 	{
-		SectorShells.Remove(Shell);
+		SectorShells.RemoveSingleSwap(Shell);
+		FreeShells.RemoveSingleSwap(Shell);
+	}
+}
+
+void UFlareSector::TickShells(float DeltaSeconds)
+{
+	// Released shells are swapped with shells that were already moved, so iterate backwards
+	for (int32 ShellIndex = SectorShells.Num() - 1; ShellIndex >= 0; ShellIndex--)
+	{
+		if (ShellIndex < SectorShells.Num())
+		{
+			AFlareShell* Shell = SectorShells[ShellIndex];
+			Shell->TickShell(DeltaSeconds * Shell->CustomTimeDilation);
+		}
 	}
 }
 
@@ -435,53 +501,120 @@ void UFlareSector::SetPause(bool Pause)
 
 AActor* UFlareSector::GetNearestBody(FVector Location, float* NearestDistance, bool IncludeSize, AActor* ActorToIgnore)
 {
-	AActor* NearestCandidateActor = NULL;
-	float NearestCandidateActorDistance = 0;
+	const FFlareSpatialEntry* Nearest = GetSpatialIndex().FindNearest(Location, EFlareSpatialBody::All, true, [=](const FFlareSpatialEntry& Entry)
+	{
+		return Entry.Actor != ActorToIgnore;
+	}, NearestDistance);
+
+	return Nearest ? Nearest->Actor : NULL;
+}
+
+void UFlareSector::UpdateSpatialIndex()
+{
+	SpatialIndex.Reset();
+	PilotSnapshot.SetNum(SectorSpacecrafts.Num(), false);
 
 	for (int32 SpacecraftIndex = 0; SpacecraftIndex < SectorSpacecrafts.Num(); SpacecraftIndex++)
 	{
-		AFlareSpacecraft* SpacecraftCandidate = GetSpacecrafts()[SpacecraftIndex];
-		float Distance = FVector::Dist(SpacecraftCandidate->GetActorLocation(), Location) - SpacecraftCandidate->GetMeshScale();
-		if (SpacecraftCandidate != ActorToIgnore && (!NearestCandidateActor || NearestCandidateActorDistance > Distance))
-		{
-			NearestCandidateActor = SpacecraftCandidate;
-			NearestCandidateActorDistance = Distance;
-		}
+		AFlareSpacecraft* Spacecraft = SectorSpacecrafts[SpacecraftIndex];
+		SpatialIndex.Add(Spacecraft, Spacecraft, Spacecraft->GetActorLocation(), Spacecraft->GetMeshScale(), EFlareSpatialBody::Spacecraft, SpacecraftIndex);
+
+		// Pilot decisions read this copy instead of the spacecraft
+		UFlareSimulatedSpacecraftDamageSystem* DamageSystem = Spacecraft->GetParent()->GetDamageSystem();
+		FFlarePilotShipState& State = PilotSnapshot[SpacecraftIndex];
+		State.Ship = Spacecraft;
+		State.Company = Spacecraft->GetCompany();
+		State.PilotTarget = Spacecraft->GetPilot()->GetTargetShip();
+		State.Location = Spacecraft->GetActorLocation();
+		State.Velocity = Spacecraft->GetLinearVelocity();
+		State.MeshScale = Spacecraft->GetMeshScale();
+		State.Size = Spacecraft->GetParent()->GetSize();
+		State.Alive = DamageSystem->IsAlive();
+		State.Station = Spacecraft->GetParent()->IsStation();
+		State.Military = Spacecraft->GetParent()->IsMilitary();
+		State.Dangerous = PilotHelper::IsShipDangerous(Spacecraft);
+		State.Stranded = DamageSystem->IsStranded();
+		State.Uncontrollable = DamageSystem->IsUncontrollable();
+		State.Disarmed = DamageSystem->IsDisarmed();
+		State.Harpooned = Spacecraft->GetParent()->IsHarpooned();
+	}
+
+	for (int32 AsteroidIndex = 0; AsteroidIndex < SectorAsteroids.Num(); AsteroidIndex++)
+	{
+		AFlareAsteroid* Asteroid = SectorAsteroids[AsteroidIndex];
+		FBox AsteroidBox = Asteroid->GetComponentsBoundingBox();
+		float AsteroidSize = FMath::Max(AsteroidBox.GetExtent().Size(), 1.0f);
+		SpatialIndex.Add(Asteroid, NULL, Asteroid->GetActorLocation(), AsteroidSize, EFlareSpatialBody::Asteroid, AsteroidIndex);
 	}
 
-	for (int32 AsteroidIndex = 0; AsteroidIndex < GetAsteroids().Num(); AsteroidIndex++)
+	for (int32 ColliderIndex = 0; ColliderIndex < SectorColliders.Num(); ColliderIndex++)
 	{
-		AFlareAsteroid* AsteroidCandidate = GetAsteroids()[AsteroidIndex];
+		AActor* Collider = SectorColliders[ColliderIndex];
+		float ColliderSize = Cast<UStaticMeshComponent>(Collider->GetRootComponent())->Bounds.SphereRadius;
+		SpatialIndex.Add(Collider, NULL, Collider->GetActorLocation(), ColliderSize, EFlareSpatialBody::Collider, ColliderIndex);
+	}
 
-		FBox CandidateBox = AsteroidCandidate->GetComponentsBoundingBox();
-		float CandidateSize = FMath::Max(CandidateBox.GetExtent().Size(), 1.0f);
+	SpatialIndex.Build();
+	SpatialIndexFrame = GFrameCounter;
+}
 
-		float Distance = FVector::Dist(AsteroidCandidate->GetActorLocation(), Location) - CandidateSize;
-		if (AsteroidCandidate != ActorToIgnore && (!NearestCandidateActor || NearestCandidateActorDistance > Distance))
-		{
-			NearestCandidateActor = AsteroidCandidate;
-			NearestCandidateActorDistance = Distance;
-		}
+void UFlareSector::InvalidateSpatialIndex()
+{
+	SpatialIndexFrame = MAX_uint64;
+}
+
+void UFlareSector::UpdatePilotDecisions()
+{
+	if (PilotDecisionFrame == GFrameCounter)
+	{
+		return;
 	}
+	PilotDecisionFrame = GFrameCounter;
+
+	SCOPE_CYCLE_COUNTER(STAT_FlareSector_PilotDecisions);
+	double StartTime = FPlatformTime::Seconds();
 
-	TArray<AActor*> ColliderActorList;
-	UGameplayStatics::GetAllActorsOfClass(GetGame()->GetWorld(), AFlareCollider::StaticClass(), ColliderActorList);
-	for (int32 ColliderIndex = 0; ColliderIndex < ColliderActorList.Num(); ColliderIndex++)
+	// Worker threads only read the snapshot and the spatial index, make sure they are up to date
+	GetSpatialIndex();
+
+	// Collect the pilots that may decide this frame, within the scheduler budget
+	PilotScheduler.BeginBatch();
+	TArray<UFlareShipPilot*> Pilots;
+	TArray<FFlarePilotDecision> Decisions;
+
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < SectorSpacecrafts.Num(); SpacecraftIndex++)
 	{
-		AActor* ColliderCandidate = ColliderActorList[ColliderIndex];
+		AFlareSpacecraft* Spacecraft = SectorSpacecrafts[SpacecraftIndex];
 
-		float CandidateSize = Cast<UStaticMeshComponent>(ColliderCandidate->GetRootComponent())->Bounds.SphereRadius;
+		if (Spacecraft->IsStation()
+		 || Spacecraft->IsPresentationMode()
+		 || !Spacecraft->GetStateManager()->IsPilotMode()
+		 || !PilotSnapshot[SpacecraftIndex].Alive)
+		{
+			continue;
+		}
 
-		float Distance = FVector::Dist(ColliderCandidate->GetActorLocation(), Location) - CandidateSize;
-		if (ColliderCandidate != ActorToIgnore && (!NearestCandidateActor || NearestCandidateActorDistance > Distance))
+		FFlarePilotDecision Decision;
+		if (Spacecraft->GetPilot()->BeginDecision(Decision))
 		{
-			NearestCandidateActor = ColliderCandidate;
-			NearestCandidateActorDistance = Distance;
+			Pilots.Add(Spacecraft->GetPilot());
+			Decisions.Add(Decision);
 		}
 	}
 
-	*NearestDistance = NearestCandidateActorDistance;
-	return NearestCandidateActor;
+	// Decide
+	ParallelFor(Pilots.Num(), [&](int32 PilotIndex)
+	{
+		Pilots[PilotIndex]->ComputeDecision(Decisions[PilotIndex]);
+	});
+
+	// Apply the decisions in a fixed order
+	for (int32 PilotIndex = 0; PilotIndex < Pilots.Num(); PilotIndex++)
+	{
+		Pilots[PilotIndex]->ApplyDecision(Decisions[PilotIndex]);
+	}
+
+	PilotScheduler.EndBatch(FPlatformTime::Seconds() - StartTime);
 }
 
 void UFlareSector::PlaceSpacecraft(AFlareSpacecraft* Spacecraft, FVector Location)
@@ -509,6 +642,7 @@ void UFlareSector::PlaceSpacecraft(AFlareSpacecraft* Spacecraft, FVector Locatio
 	while (EffectiveDistance <= 0 && RandomLocationRadius < RandomLocationRadiusIncrement * 1000);
 
 	Spacecraft->SetActorLocation(Location);
+	InvalidateSpatialIndex();
 }
 
 /*----------------------------------------------------
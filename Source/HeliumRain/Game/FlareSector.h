@@ -5,6 +5,8 @@
 #include "../Spacecrafts/FlareBomb.h"
 #include "FlareAsteroid.h"
 #include "FlareSimulatedSector.h"
+#include "FlareSpatialIndex.h"
+#include "FlarePilotScheduler.h"
 #include "FlareSector.generated.h"
 
 class UFlareSimulatedSector;
@@ -46,14 +48,30 @@ public:
 
 	void UnregisterBomb(AFlareBomb* Bomb);
 
-	void RegisterShell(AFlareShell* Shell);
+	/** Get a shell from the pool, or spawn a new one */
+	AFlareShell* AcquireShell(FVector Location, const FActorSpawnParameters& SpawnParams);
+
+	/** Stop a shell and return it to the pool */
+	void ReleaseShell(AFlareShell* Shell);
 
 	void UnregisterShell(AFlareShell* Shell);
 
+	/** Move all active shells */
+	void TickShells(float DeltaSeconds);
+
 	virtual void SetPause(bool Pause);
 
 	AActor* GetNearestBody(FVector Location, float* NearestDistance, bool IncludeSize = true, AActor* ActorToIgnore = NULL);
 
+	/** Rebuild the spatial index from the current body locations */
+	void UpdateSpatialIndex();
+
+	/** Force a spatial index rebuild on the next query */
+	void InvalidateSpatialIndex();
+
+	/** Run the due AI ship pilot decisions on worker threads, once per frame */
+	void UpdatePilotDecisions();
+
 	void PlaceSpacecraft(AFlareSpacecraft* Spacecraft, FVector Location);
 
 protected:
@@ -79,6 +97,21 @@ protected:
 	TArray<AFlareBomb*>            SectorBombs;
 	UPROPERTY()
 	TArray<AFlareShell*>           SectorShells;
+	UPROPERTY()
+	TArray<AFlareShell*>           FreeShells;
+	UPROPERTY()
+	TArray<AActor*>                SectorColliders;
+
+	/** Spatial index of spacecrafts, asteroids and colliders, rebuilt once per frame */
+	FFlareSpatialIndex             SpatialIndex;
+	uint64                         SpatialIndexFrame;
+
+	/** Time slicing of AI pilot decisions */
+	FFlarePilotScheduler           PilotScheduler;
+	uint64                         PilotDecisionFrame;
+
+	/** State of SectorSpacecrafts for pilot decisions, rebuilt with the spatial index */
+	TArray<FFlarePilotShipState>   PilotSnapshot;
 
 	int64						   LocalTime;
 	bool						   SectorRepartitionCache;
@@ -149,6 +182,33 @@ public:
 		return SectorBombs;
 	}
 
+	inline TArray<AActor*>& GetColliders()
+	{
+		return SectorColliders;
+	}
+
+	/** Get the spatial index, rebuilt on the first query of each frame */
+	inline const FFlareSpatialIndex& GetSpatialIndex()
+	{
+		if (SpatialIndexFrame != GFrameCounter)
+		{
+			UpdateSpatialIndex();
+		}
+		return SpatialIndex;
+	}
+
+	inline FFlarePilotScheduler& GetPilotScheduler()
+	{
+		return PilotScheduler;
+	}
+
+	/** Get the pilot snapshot, in GetSpacecrafts order */
+	inline const TArray<FFlarePilotShipState>& GetPilotSnapshot()
+	{
+		GetSpatialIndex();
+		return PilotSnapshot;
+	}
+
 	inline int64 GetLocalTime()
 	{
 		return LocalTime;
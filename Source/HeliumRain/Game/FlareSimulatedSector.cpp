@@ -42,10 +42,12 @@ void UFlareSimulatedSector::Load(const FFlareSectorDescription* Description, con
 	SectorData = Data;
 	SectorDescription = Description;
 	SectorOrbitParameters = OrbitParameters;
+	WorldIndex = INDEX_NONE;
 	SectorShips.Empty();
 	SectorStations.Empty();
 	SectorSpacecrafts.Empty();
 	SectorFleets.Empty();
+	InvalidateBattleState();
 
 	FFlareCelestialBody* Body = Game->GetGameWorld()->GetPlanerarium()->FindCelestialBody(SectorOrbitParameters.CelestialBodyIdentifier);
 	if (Body)
@@ -356,6 +358,7 @@ UFlareSimulatedSpacecraft* UFlareSimulatedSector::CreateSpacecraft(FFlareSpacecr
 		SectorShips.Add(Spacecraft);
 	}
 	SectorSpacecrafts.Add(Spacecraft);
+	InvalidateBattleState();
 
 	Spacecraft->SetCurrentSector(this);
 
@@ -411,6 +414,8 @@ void UFlareSimulatedSector::AddFleet(UFlareFleet* Fleet)
 		SectorShips.AddUnique(Fleet->GetShips()[ShipIndex]);
 		SectorSpacecrafts.AddUnique(Fleet->GetShips()[ShipIndex]);
 	}
+
+	InvalidateBattleState();
 }
 
 void UFlareSimulatedSector::DisbandFleet(UFlareFleet* Fleet)
@@ -445,6 +450,8 @@ void UFlareSimulatedSector::RetireFleet(UFlareFleet* Fleet)
 
 int UFlareSimulatedSector::RemoveSpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 {
+	InvalidateBattleState();
+
 	SectorStations.Remove(Spacecraft);
 	SectorShips.Remove(Spacecraft);
 	return SectorSpacecrafts.Remove(Spacecraft);
@@ -461,48 +468,82 @@ FText UFlareSimulatedSector::GetSectorDescription() const
 }
 
 bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, TArray<FText>& OutReasons, bool IgnoreCost)
+{
+	return CheckBuildStation(StationDescription, Company, &OutReasons, IgnoreCost);
+}
+
+bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, bool IgnoreCost)
+{
+	return CheckBuildStation(StationDescription, Company, NULL, IgnoreCost);
+}
+
+bool UFlareSimulatedSector::CheckBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, TArray<FText>* OutReasons, bool IgnoreCost)
 {
 	bool Result = true;
 
 	// Too many stations
 	if (SectorStations.Num() >= GetMaxStationsInSector())
 	{
-		OutReasons.Add(LOCTEXT("BuildTooManyStations", "There are too many stations in the sector"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildTooManyStations", "There are too many stations in the sector"));
 		Result = false;
 	}
 
 	// Does it needs sun
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::SunExposure) && SectorDescription->IsSolarPoor)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresSun", "This station can't be built near debris or dust"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresSun", "This station can't be built near debris or dust"));
 		Result = false;
 	}
 
 	// Does it needs not icy sector
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::HideOnIce) &&SectorDescription->IsIcy)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresNoIcy", "This station can only be built in non-icy sectors"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresNoIcy", "This station can only be built in non-icy sectors"));
 		Result = false;
 	}
 
 	// Does it needs icy sector
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::HideOnNoIce) && !SectorDescription->IsIcy)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresIcy", "This station can only be built in icy sectors"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresIcy", "This station can only be built in icy sectors"));
 		Result = false;
 	}
 
 	// Does it needs an geostationary orbit ?
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::GeostationaryOrbit) && !SectorDescription->IsGeostationary)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresGeo", "This station can only be built in geostationary sectors"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresGeo", "This station can only be built in geostationary sectors"));
 		Result = false;
 	}
 
 	// Does it needs an asteroid ?
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::FreeAsteroid) && SectorData.AsteroidData.Num() == 0)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresAsteroid", "This station can only be built on an asteroid"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresAsteroid", "This station can only be built on an asteroid"));
 		Result = false;
 	}
 
@@ -514,7 +555,11 @@ bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* Station
 	// Check money cost
 	if (Company->GetMoney() < GetStationConstructionFee(StationDescription->CycleCost.ProductionCost))
 	{
-		OutReasons.Add(FText::Format(LOCTEXT("BuildRequiresMoney", "Not enough credits ({0} / {1})"),
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(FText::Format(LOCTEXT("BuildRequiresMoney", "Not enough credits ({0} / {1})"),
 			FText::AsNumber(UFlareGameTools::DisplayMoney(Company->GetMoney())),
 			FText::AsNumber(UFlareGameTools::DisplayMoney(GetStationConstructionFee(StationDescription->CycleCost.ProductionCost)))));
 		Result = false;
@@ -542,18 +587,22 @@ bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* Station
 	}
 	if (!HasFreeCargo)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresCargo", "No cargo with free space"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresCargo", "No cargo with free space"));
 		Result = false;
 	}
 	
-	// Compute total available resources in company ships
-	TArray<FFlareCargo> AvailableResources;
+	// Compute total available resources in company ships, by resource index
+	TArray<uint32> AvailableResources;
+	AvailableResources.SetNumZeroed(Game->GetResourceCatalog()->Resources.Num());
 
 	for (int SpacecraftIndex = 0; SpacecraftIndex < SectorShips.Num(); SpacecraftIndex++)
 	{
 		UFlareSimulatedSpacecraft* Spacecraft = SectorShips[SpacecraftIndex];
 
-
 		if (Spacecraft->GetCompany() != Company)
 		{
 			continue;
@@ -561,34 +610,10 @@ bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* Station
 
 		UFlareCargoBay* CargoBay = Spacecraft->GetCargoBay();
 
-
 		for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 		{
 			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-
-			uint32 AvailableQuantity = CargoBay->GetResourceQuantity(Resource, Company);
-
-			bool NewResource = true;
-
-
-			for (int AvailableResourceIndex = 0; AvailableResourceIndex < AvailableResources.Num(); AvailableResourceIndex++)
-			{
-				if (AvailableResources[AvailableResourceIndex].Resource == Resource)
-				{
-					AvailableResources[AvailableResourceIndex].Quantity += AvailableQuantity;
-					NewResource = false;
-
-					break;
-				}
-			}
-
-			if (NewResource)
-			{
-				FFlareCargo NewResourceCargo;
-				NewResourceCargo.Resource = Resource;
-				NewResourceCargo.Quantity = AvailableQuantity;
-				AvailableResources.Add(NewResourceCargo);
-			}
+			AvailableResources[Resource->Index] += CargoBay->GetResourceQuantity(Resource, Company);
 		}
 	}
 
@@ -596,24 +621,16 @@ bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* Station
 	for (int32 ResourceIndex = 0; ResourceIndex < StationDescription->CycleCost.InputResources.Num(); ResourceIndex++)
 	{
 		FFlareFactoryResource* FactoryResource = &StationDescription->CycleCost.InputResources[ResourceIndex];
-		bool ResourceFound = false;
-		uint32 AvailableQuantity = 0;
+		uint32 AvailableQuantity = AvailableResources[FactoryResource->Resource->Data.Index];
+		bool ResourceFound = (AvailableQuantity >= FactoryResource->Quantity);
 
-		for (int AvailableResourceIndex = 0; AvailableResourceIndex < AvailableResources.Num(); AvailableResourceIndex++)
+		if (!ResourceFound)
 		{
-			if (AvailableResources[AvailableResourceIndex].Resource == &(FactoryResource->Resource->Data))
+			if (!OutReasons)
 			{
-				AvailableQuantity = AvailableResources[AvailableResourceIndex].Quantity;
-				if (AvailableQuantity >= FactoryResource->Quantity)
-				{
-					ResourceFound = true;
-				}
-				break;
+				return false;
 			}
-		}
-		if (!ResourceFound)
-		{
-			OutReasons.Add(FText::Format(LOCTEXT("BuildRequiresResources", "Not enough {0} ({1} / {2})"),
+			OutReasons->Add(FText::Format(LOCTEXT("BuildRequiresResources", "Not enough {0} ({1} / {2})"),
 					FactoryResource->Resource->Data.Name,
 					FText::AsNumber(AvailableQuantity),
 					FText::AsNumber(FactoryResource->Quantity)));
@@ -1036,7 +1053,7 @@ void UFlareSimulatedSector::SimulatePriceVariation(FFlareResourceDescription* Re
 				continue;
 			}
 
-			int64 TravelDuration = UFlareTravel::ComputeTravelDuration(GetGame()->GetGameWorld(), this, SectorCandidate);
+			int64 TravelDuration = GetGame()->GetGameWorld()->GetTravelDuration(this, SectorCandidate);
 
 
 			if (MinTravelDuration == -1 || MinTravelDuration > TravelDuration)
@@ -1068,6 +1085,68 @@ void UFlareSimulatedSector::ClearBombs()
 	SectorData.BombData.Empty();
 }
 
+void UFlareSimulatedSector::SetSimulationSeed(int32 Seed)
+{
+	SimulationRandom.Initialize(Seed);
+}
+
+void UFlareSimulatedSector::SetWorldIndex(int32 Index)
+{
+	WorldIndex = Index;
+}
+
+void UFlareSimulatedSector::InvalidateBattleState()
+{
+	CompanyForcesDirty = true;
+	BattleStates.Empty();
+}
+
+void UFlareSimulatedSector::InvalidateHostilities()
+{
+	BattleStates.Empty();
+}
+
+void UFlareSimulatedSector::SetDamageStateDirty(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	DamageStatePending.Add(Spacecraft);
+}
+
+void UFlareSimulatedSector::FlushDamageStates()
+{
+	if (DamageStatePending.Num() == 0)
+	{
+		return;
+	}
+
+	// A spacecraft can be pending in several sectors if it moved : only the first flush publishes
+	TArray<UFlareSimulatedSpacecraft*> Pending = MoveTemp(DamageStatePending);
+	DamageStatePending.Reset();
+
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Pending.Num(); SpacecraftIndex++)
+	{
+		Pending[SpacecraftIndex]->GetDamageSystem()->UpdateDamageState();
+	}
+}
+
+void UFlareSimulatedSector::OnSpacecraftDamageStateChanged(UFlareSimulatedSpacecraft* Spacecraft, int32 OldDamageState, int32 NewDamageState)
+{
+	if (!CompanyForcesDirty)
+	{
+		AddCompanyForces(Spacecraft, OldDamageState, -1);
+		AddCompanyForces(Spacecraft, NewDamageState, 1);
+	}
+
+	// Only the flags used by the forces change the battle states
+	int32 BattleMask = EFlareDamageState::Alive | EFlareDamageState::Stranded | EFlareDamageState::Disarmed;
+	int32 OldBattleFlags = (OldDamageState == INDEX_NONE ? 0 : OldDamageState & BattleMask);
+	int32 NewBattleFlags = NewDamageState & BattleMask;
+
+	if (OldBattleFlags != NewBattleFlags)
+	{
+		BattleStates.Empty();
+	}
+}
+
 void UFlareSimulatedSector::GetSectorBalance(UFlareCompany* Company, int32& PlayerShips, int32& EnemyShips, int32& NeutralShips, bool ActiveOnly)
 {
 	PlayerShips = 0;
@@ -1151,17 +1230,45 @@ uint32 UFlareSimulatedSector::GetResourceCount(UFlareCompany* Company, FFlareRes
 
 void UFlareSimulatedSector::LoadResourcePrices()
 {
-	ResourcePrices.Empty();
-	LastResourcePrices.Empty();
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	int32 ResourceCount = ResourceCatalog->Resources.Num();
+
+	ResourcePrices.SetNumUninitialized(ResourceCount);
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+	{
+		FFlareResourceDescription* Resource = &ResourceCatalog->Resources[ResourceIndex]->Data;
+		ResourcePrices[Resource->Index] = GetDefaultResourcePrice(Resource);
+	}
+
+	PriceHistory.Empty();
+	PriceHistory.SetNumZeroed(ResourceCount * SECTOR_PRICE_HISTORY);
+	PriceHistoryCounts.Empty();
+	PriceHistoryCounts.SetNumZeroed(ResourceCount);
+	PriceHistoryWriteIndex = 0;
+	ResourcePriceVersions.Empty();
+	ResourcePriceVersions.SetNumZeroed(ResourceCount);
+
 	for (int PriceIndex = 0; PriceIndex < SectorData.ResourcePrices.Num(); PriceIndex++)
 	{
 		FFFlareResourcePrice* ResourcePrice = &SectorData.ResourcePrices[PriceIndex];
-		FFlareResourceDescription* Resource = Game->GetResourceCatalog()->Get(ResourcePrice->ResourceIdentifier);
-		float Price = ResourcePrice->Price;
-		ResourcePrices.Add(Resource, Price);
+		FFlareResourceDescription* Resource = ResourceCatalog->Get(ResourcePrice->ResourceIdentifier);
+		if (!Resource)
+		{
+			FLOGV("UFlareSimulatedSector::LoadResourcePrices : Unknown resource '%s'", *ResourcePrice->ResourceIdentifier.ToString());
+			continue;
+		}
+
+		ResourcePrices[Resource->Index] = ResourcePrice->Price;
+
+		// The last day goes in the slot before the write index
 		FFlareFloatBuffer* Prices = &ResourcePrice->Prices;
-		Prices->Resize(50);
-		LastResourcePrices.Add(Resource, *Prices);
+		int32 Count = FMath::Min(Prices->Values.Num(), SECTOR_PRICE_HISTORY);
+		float* History = &PriceHistory[Resource->Index * SECTOR_PRICE_HISTORY];
+		for (int32 Age = 0; Age < Count; Age++)
+		{
+			History[SECTOR_PRICE_HISTORY - 1 - Age] = Prices->GetValue(Age);
+		}
+		PriceHistoryCounts[Resource->Index] = Count;
 	}
 }
 
@@ -1172,17 +1279,17 @@ void UFlareSimulatedSector::SaveResourcePrices()
 	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 	{
 		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-		if (ResourcePrices.Contains(Resource))
+
+		FFFlareResourcePrice Price;
+		Price.ResourceIdentifier = Resource->Identifier;
+		Price.Price = ResourcePrices[Resource->Index];
+		Price.Prices.Init(SECTOR_PRICE_HISTORY);
+		for (int32 Age = PriceHistoryCounts[Resource->Index] - 1; Age >= 0; Age--)
 		{
-			FFFlareResourcePrice Price;
-			Price.ResourceIdentifier = Resource->Identifier;
-			Price.Price = ResourcePrices[Resource];
-			if (LastResourcePrices.Contains(Resource))
-			{
-				Price.Prices = LastResourcePrices[Resource];
-				SectorData.ResourcePrices.Add(Price);
-			}
+			Price.Prices.Append(GetPriceHistoryValue(Resource->Index, Age));
 		}
+
+		SectorData.ResourcePrices.Add(Price);
 	}
 }
 
@@ -1249,87 +1356,121 @@ FFlareSectorBattleState UFlareSimulatedSector::GetSectorBattleState(UFlareCompan
 {
 	SCOPE_CYCLE_COUNTER(STAT_FlareSector_GetSectorBattleState);
 
-	FFlareSectorBattleState BattleState;
-	BattleState.Init();
+	FlushDamageStates();
 
+	FFlareSectorBattleState* CachedBattleState = BattleStates.Find(Company);
+	if (CachedBattleState)
+	{
+		return *CachedBattleState;
+	}
 
-	if (GetSectorShips().Num() == 0)
+	FFlareSectorBattleState BattleState = ComputeSectorBattleState(Company);
+	BattleStates.Add(Company, BattleState);
+	return BattleState;
+}
+
+FFlareSectorCompanyForces UFlareSimulatedSector::GetCompanyForces(UFlareCompany* Company)
+{
+	FlushDamageStates();
+
+	if (CompanyForcesDirty)
 	{
-		return BattleState;
+		UpdateCompanyForces();
 	}
 
-	int HostileSpacecraftCount = 0;
-	int DangerousHostileSpacecraftCount = 0;
-	int DangerousHostileActiveSpacecraftCount = 0;
+	FFlareSectorCompanyForces* Forces = CompanyForces.Find(Company);
+	return Forces ? *Forces : FFlareSectorCompanyForces();
+}
 
+void UFlareSimulatedSector::UpdateCompanyForces()
+{
+	FlushDamageStates();
+	CompanyForces.Empty();
 
-	int FriendlySpacecraftCount = 0;
-	int DangerousFriendlySpacecraftCount = 0;
-	int DangerousFriendlyActiveSpacecraftCount = 0;
-	int CrippledFriendlySpacecraftCount = 0;
+	// Count the published states, kept up to date by OnSpacecraftDamageStateChanged
+	for (int SpacecraftIndex = 0 ; SpacecraftIndex < GetSectorSpacecrafts().Num(); SpacecraftIndex++)
+	{
+		UFlareSimulatedSpacecraft* Spacecraft = GetSectorSpacecrafts()[SpacecraftIndex];
+		AddCompanyForces(Spacecraft, Spacecraft->GetDamageSystem()->GetDamageState(), 1);
+	}
 
-	for (int SpacecraftIndex = 0 ; SpacecraftIndex < GetSectorShips().Num(); SpacecraftIndex++)
+	CompanyForcesDirty = false;
+}
+
+void UFlareSimulatedSector::AddCompanyForces(UFlareSimulatedSpacecraft* Spacecraft, int32 DamageState, int32 Sign)
+{
+	if (DamageState == INDEX_NONE || !(DamageState & EFlareDamageState::Alive))
 	{
+		return;
+	}
 
-		UFlareSimulatedSpacecraft* Spacecraft = GetSectorShips()[SpacecraftIndex];
+	FFlareSectorCompanyForces& Forces = CompanyForces.FindOrAdd(Spacecraft->GetCompany());
+	Forces.SpacecraftCount += Sign;
 
-		UFlareCompany* OtherCompany = Spacecraft->GetCompany();
+	if (Spacecraft->IsStation())
+	{
+		Forces.CrippledSpacecraftCount += Sign;
+		return;
+	}
 
-		if (!Spacecraft->GetDamageSystem()->IsAlive())
+	if (!(DamageState & EFlareDamageState::Disarmed))
+	{
+		Forces.DangerousShipCount += Sign;
+		if(!Spacecraft->IsReserve())
 		{
-			continue;
+			Forces.DangerousActiveShipCount += Sign;
 		}
+	}
 
-		if (OtherCompany == Company)
-		{
-			FriendlySpacecraftCount++;
-			if (!Spacecraft->GetDamageSystem()->IsDisarmed())
-			{
-				DangerousFriendlySpacecraftCount++;
-				if(!Spacecraft->IsReserve())
-				{
-					DangerousFriendlyActiveSpacecraftCount++;
-				}
-			}
+	if (DamageState & EFlareDamageState::Stranded)
+	{
+		Forces.CrippledSpacecraftCount += Sign;
+	}
+}
 
-			if (Spacecraft->GetDamageSystem()->IsStranded())
-			{
-				CrippledFriendlySpacecraftCount++;
-			}
-		}
-		else if (OtherCompany->GetWarState(Company) == EFlareHostility::Hostile)
-		{
-			HostileSpacecraftCount++;
-			if (!Spacecraft->GetDamageSystem()->IsDisarmed())
-			{
-				DangerousHostileSpacecraftCount++;
-				if(!Spacecraft->IsReserve())
-				{
-					DangerousHostileActiveSpacecraftCount++;
-				}
-			}
-		}
+FFlareSectorBattleState UFlareSimulatedSector::ComputeSectorBattleState(UFlareCompany* Company)
+{
+	FFlareSectorBattleState BattleState;
+	BattleState.Init();
+
+
+	if (GetSectorShips().Num() == 0)
+	{
+		return BattleState;
 	}
 
-	for (int SpacecraftIndex = 0 ; SpacecraftIndex < GetSectorStations().Num(); SpacecraftIndex++)
+	if (CompanyForcesDirty)
 	{
+		UpdateCompanyForces();
+	}
 
-		UFlareSimulatedSpacecraft* Spacecraft = GetSectorStations()[SpacecraftIndex];
-		UFlareCompany* OtherCompany = Spacecraft->GetCompany();
+	int HostileSpacecraftCount = 0;
+	int DangerousHostileSpacecraftCount = 0;
+	int DangerousHostileActiveSpacecraftCount = 0;
 
-		if (!Spacecraft->GetDamageSystem()->IsAlive())
-		{
-			continue;
-		}
+
+	int FriendlySpacecraftCount = 0;
+	int DangerousFriendlySpacecraftCount = 0;
+	int DangerousFriendlyActiveSpacecraftCount = 0;
+	int CrippledFriendlySpacecraftCount = 0;
+
+	for (auto& CompanyForcesEntry : CompanyForces)
+	{
+		UFlareCompany* OtherCompany = CompanyForcesEntry.Key;
+		const FFlareSectorCompanyForces& Forces = CompanyForcesEntry.Value;
 
 		if (OtherCompany == Company)
 		{
-			FriendlySpacecraftCount++;
-			CrippledFriendlySpacecraftCount++;
+			FriendlySpacecraftCount += Forces.SpacecraftCount;
+			DangerousFriendlySpacecraftCount += Forces.DangerousShipCount;
+			DangerousFriendlyActiveSpacecraftCount += Forces.DangerousActiveShipCount;
+			CrippledFriendlySpacecraftCount += Forces.CrippledSpacecraftCount;
 		}
 		else if (OtherCompany->GetWarState(Company) == EFlareHostility::Hostile)
 		{
-			HostileSpacecraftCount++;
+			HostileSpacecraftCount += Forces.SpacecraftCount;
+			DangerousHostileSpacecraftCount += Forces.DangerousShipCount;
+			DangerousHostileActiveSpacecraftCount += Forces.DangerousActiveShipCount;
 		}
 	}
 
@@ -1492,57 +1633,58 @@ FLinearColor UFlareSimulatedSector::GetSectorFriendlynessColor(UFlareCompany* Co
 }
 
 
-float UFlareSimulatedSector::GetPreciseResourcePrice(FFlareResourceDescription* Resource, int32 Age)
+float UFlareSimulatedSector::GetPreciseResourcePrice(FFlareResourceDescription* Resource, int32 Age) const
 {
 	if(Age == 0)
 	{
-
-		if (!ResourcePrices.Contains(Resource))
-		{
-			ResourcePrices.Add(Resource, GetDefaultResourcePrice(Resource));
-		}
-
-		return ResourcePrices[Resource];
+		return ResourcePrices[Resource->Index];
 	}
 	else
 	{
-		if (!LastResourcePrices.Contains(Resource))
-		{
-			FFlareFloatBuffer Prices;
-			Prices.Init(50);
-			Prices.Append(GetPreciseResourcePrice(Resource, 0));
-			LastResourcePrices.Add(Resource, Prices);
-		}
+		return GetPriceHistoryValue(Resource->Index, Age);
+	}
+}
 
-		return LastResourcePrices[Resource].GetValue(Age);
+float UFlareSimulatedSector::GetPriceHistoryValue(int32 ResourceIndex, int32 Age) const
+{
+	int32 Count = PriceHistoryCounts[ResourceIndex];
+	if (Count == 0)
+	{
+		return ResourcePrices[ResourceIndex];
 	}
 
+	int32 ReadIndex = PriceHistoryWriteIndex - 1 - FMath::Clamp(Age, 0, Count - 1);
+	if (ReadIndex < 0)
+	{
+		ReadIndex += SECTOR_PRICE_HISTORY;
+	}
+
+	return PriceHistory[ResourceIndex * SECTOR_PRICE_HISTORY + ReadIndex];
 }
 
 void UFlareSimulatedSector::SwapPrices()
 {
-	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+	for(int32 ResourceIndex = 0; ResourceIndex < ResourcePrices.Num(); ResourceIndex++)
 	{
-		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-
-		if (!LastResourcePrices.Contains(Resource))
-		{
-			FFlareFloatBuffer Prices;
-			Prices.Init(50);
-			LastResourcePrices.Add(Resource, Prices);
-		}
-
-		LastResourcePrices[Resource].Append(GetPreciseResourcePrice(Resource, 0));
+		PriceHistory[ResourceIndex * SECTOR_PRICE_HISTORY + PriceHistoryWriteIndex] = ResourcePrices[ResourceIndex];
+		PriceHistoryCounts[ResourceIndex] = FMath::Min(PriceHistoryCounts[ResourceIndex] + 1, SECTOR_PRICE_HISTORY);
 	}
+
+	PriceHistoryWriteIndex = (PriceHistoryWriteIndex + 1) % SECTOR_PRICE_HISTORY;
 }
 
 void UFlareSimulatedSector::SetPreciseResourcePrice(FFlareResourceDescription* Resource, float NewPrice)
 {
-	ResourcePrices[Resource] = FMath::Clamp(NewPrice, (float) Resource->MinPrice, (float) Resource->MaxPrice);
+	float ClampedPrice = FMath::Clamp(NewPrice, (float) Resource->MinPrice, (float) Resource->MaxPrice);
+	if (ResourcePrices[Resource->Index] != ClampedPrice)
+	{
+		ResourcePrices[Resource->Index] = ClampedPrice;
+		ResourcePriceVersions[Resource->Index]++;
+	}
 }
 
 
-static bool ReserveShipComparator (UFlareSimulatedSpacecraft& Ship1, UFlareSimulatedSpacecraft& Ship2)
+static bool ReserveShipComparator (UFlareSimulatedSpacecraft& Ship1, UFlareSimulatedSpacecraft& Ship2, FRandomStream& Random)
 {
 	bool SELECT_SHIP1 = true;
 	bool SELECT_SHIP2 = false;
@@ -1604,7 +1746,7 @@ static bool ReserveShipComparator (UFlareSimulatedSpacecraft& Ship1, UFlareSimul
 		return Ship1.GetCargoBay()->GetUsedCargoSpace() > Ship2.GetCargoBay()->GetUsedCargoSpace();
 	}
 
-	return FMath::RandBool();
+	return (Random.RandRange(0, 1) == 1);
 }
 
 static const int32 MIN_SPAWN = 1;
@@ -1689,6 +1831,11 @@ void UFlareSimulatedSector::UpdateReserveShips()
 	float MilitaryProportion = (GetSectorBattleState(Game->GetPC()->GetCompany()).InBattle ? 0.75f : 0.25);
 	float CargoProportion = 1.f-MilitaryProportion;
 
+	auto SortReserveShips = [this](UFlareSimulatedSpacecraft& Ship1, UFlareSimulatedSpacecraft& Ship2)
+	{
+		return ReserveShipComparator(Ship1, Ship2, SimulationRandom);
+	};
+
 	for (int32 CompanyIndex = 0; CompanyIndex < GetGame()->GetGameWorld()->GetCompanies().Num(); CompanyIndex++)
 	{
 		UFlareCompany* Company = GetGame()->GetGameWorld()->GetCompanies()[CompanyIndex];
@@ -1701,7 +1848,7 @@ void UFlareSimulatedSector::UpdateReserveShips()
 			AllowedShipCount += MIN_SPAWN;
 			FLOGV("Allow %d/%d cargo for %s", AllowedShipCount, CargoCompanyShipCount, *Company->GetCompanyName().ToString());
 
-			CargoShipListByCompanies[CompanyIndex].Sort(&ReserveShipComparator);
+			CargoShipListByCompanies[CompanyIndex].Sort(SortReserveShips);
 			for (int32 ShipIndex = AllowedShipCount; ShipIndex < CargoCompanyShipCount; ShipIndex++)
 			{
 				UFlareSimulatedSpacecraft* Ship = CargoShipListByCompanies[CompanyIndex][ShipIndex];
@@ -1717,7 +1864,7 @@ void UFlareSimulatedSector::UpdateReserveShips()
 			AllowedShipCount += MIN_SPAWN;
 			FLOGV("Allow %d/%d military for %s", AllowedShipCount, MilitaryCompanyShipCount, *Company->GetCompanyName().ToString());
 
-			MilitaryShipListByCompanies[CompanyIndex].Sort(&ReserveShipComparator);
+			MilitaryShipListByCompanies[CompanyIndex].Sort(SortReserveShips);
 			for (int32 ShipIndex = AllowedShipCount; ShipIndex < MilitaryCompanyShipCount; ShipIndex++)
 			{
 				UFlareSimulatedSpacecraft* Ship = MilitaryShipListByCompanies[CompanyIndex][ShipIndex];
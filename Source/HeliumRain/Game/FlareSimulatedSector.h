@@ -16,6 +16,9 @@ class AFlareGame;
 struct FFlarePlayerSave;
 struct FFlareResourceDescription;
 
+/** Days of price history kept by a sector */
+#define SECTOR_PRICE_HISTORY 50
+
 /** Factory action type values */
 UENUM()
 namespace EFlareTransportLimitType
@@ -112,6 +115,29 @@ struct FFlareSectorBattleState
 	}
 };
 
+/** Alive spacecraft counts of a company in a sector, used to compute battle states */
+struct FFlareSectorCompanyForces
+{
+	/** Ships and stations */
+	int32 SpacecraftCount;
+
+	/** Armed ships */
+	int32 DangerousShipCount;
+
+	/** Armed ships not in reserve */
+	int32 DangerousActiveShipCount;
+
+	/** Stranded ships and stations */
+	int32 CrippledSpacecraftCount;
+
+	FFlareSectorCompanyForces()
+		: SpacecraftCount(0)
+		, DangerousShipCount(0)
+		, DangerousActiveShipCount(0)
+		, CrippledSpacecraftCount(0)
+	{}
+};
+
 /** Debris field settings */
 USTRUCT()
 struct FFlareDebrisFieldInfo
@@ -372,6 +398,9 @@ public:
 	/** Check whether we can build a station, understand why if not */
 	bool CanBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, TArray<FText>& OutReason, bool IgnoreCost = false);
 
+	/** Check whether we can build a station, without building the reasons */
+	bool CanBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, bool IgnoreCost = false);
+
 	UFlareSimulatedSpacecraft* BuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company);
 
 	bool CanUpgrade(UFlareCompany* Company);
@@ -391,6 +420,27 @@ public:
 
 	void ClearBombs();
 
+	/** Seed the random stream used by the sector-local simulation phases */
+	void SetSimulationSeed(int32 Seed);
+
+	/** Set the index of this sector in the world sector list */
+	void SetWorldIndex(int32 Index);
+
+	/** A spacecraft was added, removed or put in reserve : battle states must be recomputed */
+	void InvalidateBattleState();
+
+	/** The damage state of a spacecraft in this sector must be published at the next flush */
+	void SetDamageStateDirty(UFlareSimulatedSpacecraft* Spacecraft);
+
+	/** Publish the damage states of the spacecrafts damaged since the last flush. Must not run on worker threads */
+	void FlushDamageStates();
+
+	/** The damage state of a spacecraft in this sector changed : update the forces in place */
+	void OnSpacecraftDamageStateChanged(UFlareSimulatedSpacecraft* Spacecraft, int32 OldDamageState, int32 NewDamageState);
+
+	/** Hostilities changed : battle states must be recomputed from the current forces */
+	void InvalidateHostilities();
+
 	/** Get the balance of forces in the sector */
 	void GetSectorBalance(UFlareCompany* Company, int32& PlayerShips, int32& EnemyShips, int32& NeutralShips, bool ActiveOnly);
 
@@ -400,6 +450,9 @@ public:
 
 protected:
 
+	/** Check whether we can build a station. Reasons are only built if OutReasons is set, otherwise the check stops at the first failure */
+	bool CheckBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, TArray<FText>* OutReasons, bool IgnoreCost);
+
     /*----------------------------------------------------
         Protected data
     ----------------------------------------------------*/
@@ -423,8 +476,41 @@ protected:
 	UPROPERTY()
 	FFlareSectorOrbitParameters             SectorOrbitParameters;
 	const FFlareSectorDescription*          SectorDescription;
-	TMap<FFlareResourceDescription*, float> ResourcePrices;
-	TMap<FFlareResourceDescription*, FFlareFloatBuffer> LastResourcePrices;
+
+	/** Current price of each resource, indexed by resource catalog index */
+	TArray<float>                           ResourcePrices;
+
+	/** Price history of all resources in one ring of SECTOR_PRICE_HISTORY days per resource */
+	TArray<float>                           PriceHistory;
+	TArray<int32>                           PriceHistoryCounts;
+	int32                                   PriceHistoryWriteIndex;
+
+	/** Incremented each time the current price of a resource changes, indexed by resource catalog index */
+	TArray<int32>                           ResourcePriceVersions;
+
+	/** Random stream for sector-local simulation, never shared between sectors */
+	FRandomStream                           SimulationRandom;
+
+	/** Index in the world sector list, INDEX_NONE for travel sectors */
+	int32                                   WorldIndex;
+
+	// Battle state cache
+	TMap<UFlareCompany*, FFlareSectorCompanyForces> CompanyForces;
+	TMap<UFlareCompany*, FFlareSectorBattleState>   BattleStates;
+	bool                                    CompanyForcesDirty;
+
+	/** Spacecrafts whose damage state was not published yet */
+	UPROPERTY()
+	TArray<UFlareSimulatedSpacecraft*>      DamageStatePending;
+
+	/** Count the forces of each company present in the sector */
+	void UpdateCompanyForces();
+
+	/** Add or remove the contribution of a spacecraft in a given damage state to the forces of its company */
+	void AddCompanyForces(UFlareSimulatedSpacecraft* Spacecraft, int32 DamageState, int32 Sign);
+
+	/** Compute the battle status of a company from the current forces */
+	FFlareSectorBattleState ComputeSectorBattleState(UFlareCompany* Company);
 
 public:
 
@@ -495,6 +581,16 @@ public:
 		return SectorData.IsTravelSector;
 	}
 
+	inline FRandomStream& GetSimulationRandom()
+	{
+		return SimulationRandom;
+	}
+
+	inline int32 GetWorldIndex() const
+	{
+		return WorldIndex;
+	}
+
 
 	int64 GetStationConstructionFee(int64 BasePrice);
 
@@ -507,7 +603,7 @@ public:
 
 	int64 GetResourcePrice(FFlareResourceDescription* Resource, EFlareResourcePriceContext::Type PriceContext, int32 Age = 0);
 
-	float GetPreciseResourcePrice(FFlareResourceDescription* Resource, int32 Age = 0);
+	float GetPreciseResourcePrice(FFlareResourceDescription* Resource, int32 Age = 0) const;
 
 	void SwapPrices();
 
@@ -517,6 +613,15 @@ public:
 
 	static float GetDefaultResourcePrice(FFlareResourceDescription* Resource);
 
+	/** Get a price from the history, Age 0 being the last day. Resources without history have their current price */
+	float GetPriceHistoryValue(int32 ResourceIndex, int32 Age) const;
+
+	/** Get a counter that changes each time the current price of a resource changes */
+	inline int32 GetResourcePriceVersion(FFlareResourceDescription* Resource) const
+	{
+		return ResourcePriceVersions[Resource->Index];
+	}
+
 	uint32 GetTransfertResourcePrice(UFlareSimulatedSpacecraft* SourceSpacecraft, UFlareSimulatedSpacecraft* DestinationSpacecraft, FFlareResourceDescription* Resource);
 
 	inline FFlareSectorOrbitParameters* GetOrbitParameters()
@@ -535,6 +640,9 @@ public:
 	/** Get the current battle status of a company */
 	FFlareSectorBattleState GetSectorBattleState(UFlareCompany* Company);
 
+	/** Get the alive spacecraft counts of a company in this sector */
+	FFlareSectorCompanyForces GetCompanyForces(UFlareCompany* Company);
+
 	/** Get the current battle status text */
 	FText GetSectorBattleStateText(UFlareCompany* Company);
 
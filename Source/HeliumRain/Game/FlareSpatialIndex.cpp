@@ -0,0 +1,219 @@
+
+#include "../Flare.h"
+#include "FlareSpatialIndex.h"
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+FFlareSpatialIndex::FFlareSpatialIndex()
+	: CellSize(100000) // 1km
+{
+}
+
+
+/*----------------------------------------------------
+	Build
+----------------------------------------------------*/
+
+void FFlareSpatialIndex::Reset()
+{
+	Entries.Reset();
+	LargeEntries.Reset();
+	CellEntries.Reset();
+	Cells.Reset();
+}
+
+void FFlareSpatialIndex::Add(AActor* Actor, AFlareSpacecraft* Spacecraft, FVector Location, float Radius, EFlareSpatialBody::Type Type, int32 Index)
+{
+	FFlareSpatialEntry Entry;
+	Entry.Actor = Actor;
+	Entry.Spacecraft = Spacecraft;
+	Entry.Location = Location;
+	Entry.Radius = FMath::Max(Radius, 0.f);
+	Entry.Type = Type;
+	Entry.Index = Index;
+	Entries.Add(Entry);
+}
+
+void FFlareSpatialIndex::Build()
+{
+	LargeEntries.Reset();
+	CellEntries.Reset();
+	Cells.Reset();
+
+	// Add each body to every cell its bounding box overlaps
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++)
+	{
+		const FFlareSpatialEntry& Entry = Entries[EntryIndex];
+
+		if (Entry.Radius > CellSize)
+		{
+			LargeEntries.Add(EntryIndex);
+			continue;
+		}
+
+		FIntVector MinCell = GetCell(Entry.Location - FVector(Entry.Radius));
+		FIntVector MaxCell = GetCell(Entry.Location + FVector(Entry.Radius));
+
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+				{
+					CellEntries.Add(TPair<uint64, int32>(GetCellKey(X, Y, Z), EntryIndex));
+				}
+			}
+		}
+	}
+
+	// Group by cell
+	CellEntries.Sort([](const TPair<uint64, int32>& A, const TPair<uint64, int32>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	for (int32 Index = 0; Index < CellEntries.Num(); Index++)
+	{
+		FIntPoint* Range = Cells.Find(CellEntries[Index].Key);
+		if (Range)
+		{
+			Range->Y++;
+		}
+		else
+		{
+			Cells.Add(CellEntries[Index].Key, FIntPoint(Index, 1));
+		}
+	}
+}
+
+
+/*----------------------------------------------------
+	Queries
+----------------------------------------------------*/
+
+void FFlareSpatialIndex::QuerySphere(FVector Center, float Radius, int32 TypeMask, TArray<const FFlareSpatialEntry*>& Results) const
+{
+	VisitBox(Center, Radius, TypeMask, [&](const FFlareSpatialEntry& Entry)
+	{
+		if (FVector::Dist(Entry.Location, Center) < Radius + Entry.Radius)
+		{
+			Results.Add(&Entry);
+		}
+	});
+}
+
+void FFlareSpatialIndex::QuerySegment(FVector Start, FVector End, float Radius, int32 TypeMask, TArray<const FFlareSpatialEntry*>& Results) const
+{
+	FVector Center = (Start + End) / 2;
+	float Extent = (End - Start).GetAbsMax() / 2 + Radius;
+
+	VisitBox(Center, Extent, TypeMask, [&](const FFlareSpatialEntry& Entry)
+	{
+		if (FMath::PointDistToSegment(Entry.Location, Start, End) < Radius + Entry.Radius)
+		{
+			Results.Add(&Entry);
+		}
+	});
+}
+
+const FFlareSpatialEntry* FFlareSpatialIndex::FindNearest(FVector Location, int32 TypeMask, bool IncludeSize, TFunctionRef<bool(const FFlareSpatialEntry&)> Filter, float* NearestDistance) const
+{
+	const FFlareSpatialEntry* Nearest = NULL;
+	float NearestCandidateDistance = 0;
+	float SearchRadius = CellSize;
+
+	// Grow the search box until the nearest body is known to be inside
+	while (true)
+	{
+		bool Exhaustive = VisitBox(Location, SearchRadius, TypeMask, [&](const FFlareSpatialEntry& Entry)
+		{
+			float Distance = FVector::Dist(Entry.Location, Location) - (IncludeSize ? Entry.Radius : 0);
+			if ((!Nearest || Distance < NearestCandidateDistance) && Filter(Entry))
+			{
+				Nearest = &Entry;
+				NearestCandidateDistance = Distance;
+			}
+		});
+
+		if (Exhaustive || (Nearest && NearestCandidateDistance < SearchRadius))
+		{
+			break;
+		}
+
+		Nearest = NULL;
+		SearchRadius *= 4;
+	}
+
+	if (NearestDistance)
+	{
+		*NearestDistance = NearestCandidateDistance;
+	}
+	return Nearest;
+}
+
+
+/*----------------------------------------------------
+	Internal
+----------------------------------------------------*/
+
+bool FFlareSpatialIndex::VisitBox(FVector Center, float Extent, int32 TypeMask, TFunctionRef<void(const FFlareSpatialEntry&)> Visitor) const
+{
+	FIntVector MinCell = GetCell(Center - FVector(Extent));
+	FIntVector MaxCell = GetCell(Center + FVector(Extent));
+	int64 CellCount = (int64) (MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+
+	// Large boxes are cheaper to process as a full scan
+	if (CellCount >= Entries.Num())
+	{
+		for (const FFlareSpatialEntry& Entry : Entries)
+		{
+			if (Entry.Type & TypeMask)
+			{
+				Visitor(Entry);
+			}
+		}
+		return true;
+	}
+
+	// Bodies can be in several cells, visit them once
+	TBitArray<TInlineAllocator<32>> Visited(false, Entries.Num());
+
+	for (int32 EntryIndex : LargeEntries)
+	{
+		if (Entries[EntryIndex].Type & TypeMask)
+		{
+			Visited[EntryIndex] = true;
+			Visitor(Entries[EntryIndex]);
+		}
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				const FIntPoint* Range = Cells.Find(GetCellKey(X, Y, Z));
+				if (!Range)
+				{
+					continue;
+				}
+
+				for (int32 Index = Range->X; Index < Range->X + Range->Y; Index++)
+				{
+					int32 EntryIndex = CellEntries[Index].Value;
+					if (!Visited[EntryIndex] && (Entries[EntryIndex].Type & TypeMask))
+					{
+						Visited[EntryIndex] = true;
+						Visitor(Entries[EntryIndex]);
+					}
+				}
+			}
+		}
+	}
+
+	return false;
+}
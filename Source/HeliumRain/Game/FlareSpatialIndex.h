@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Engine.h"
+
+class AFlareSpacecraft;
+
+
+/** Kind of body in the spatial index, used as query masks */
+namespace EFlareSpatialBody
+{
+	enum Type
+	{
+		Spacecraft = 1,
+		Asteroid = 2,
+		Collider = 4,
+		All = Spacecraft | Asteroid | Collider
+	};
+}
+
+/** Body in the spatial index */
+struct FFlareSpatialEntry
+{
+	/** Indexed actor */
+	AActor* Actor;
+
+	/** Indexed actor if it is a spacecraft, NULL otherwise */
+	AFlareSpacecraft* Spacecraft;
+
+	/** Location when the index was built */
+	FVector Location;
+
+	/** Bounding radius */
+	float Radius;
+
+	/** EFlareSpatialBody type */
+	int32 Type;
+
+	/** Index of the body in its sector list */
+	int32 Index;
+};
+
+
+/** Uniform grid of the bodies of the active sector */
+class FFlareSpatialIndex
+{
+public:
+
+	FFlareSpatialIndex();
+
+	/*----------------------------------------------------
+		Build
+	----------------------------------------------------*/
+
+	/** Remove all bodies, keeping allocations */
+	void Reset();
+
+	/** Add a body. Build must be called after the last body is added */
+	void Add(AActor* Actor, AFlareSpacecraft* Spacecraft, FVector Location, float Radius, EFlareSpatialBody::Type Type, int32 Index);
+
+	/** Sort the bodies into grid cells */
+	void Build();
+
+
+	/*----------------------------------------------------
+		Queries
+	----------------------------------------------------*/
+
+	/** Get the bodies whose bounding sphere intersects a sphere */
+	void QuerySphere(FVector Center, float Radius, int32 TypeMask, TArray<const FFlareSpatialEntry*>& Results) const;
+
+	/** Get the bodies whose bounding sphere is closer than Radius from a segment */
+	void QuerySegment(FVector Start, FVector End, float Radius, int32 TypeMask, TArray<const FFlareSpatialEntry*>& Results) const;
+
+	/** Get the nearest body accepted by Filter. If IncludeSize is set, the distance is measured to the body bounding sphere */
+	const FFlareSpatialEntry* FindNearest(FVector Location, int32 TypeMask, bool IncludeSize, TFunctionRef<bool(const FFlareSpatialEntry&)> Filter, float* NearestDistance = NULL) const;
+
+	inline int32 Num() const
+	{
+		return Entries.Num();
+	}
+
+	inline const TArray<FFlareSpatialEntry>& GetEntries() const
+	{
+		return Entries;
+	}
+
+
+protected:
+
+	/*----------------------------------------------------
+		Internal
+	----------------------------------------------------*/
+
+	inline FIntVector GetCell(FVector Location) const
+	{
+		return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+	}
+
+	static inline uint64 GetCellKey(int32 X, int32 Y, int32 Z)
+	{
+		return ((uint64) (X & 0x1FFFFF) << 42) | ((uint64) (Y & 0x1FFFFF) << 21) | (uint64) (Z & 0x1FFFFF);
+	}
+
+	/** Call Visitor once for each body that may intersect the box around Center, return true if all bodies were visited */
+	bool VisitBox(FVector Center, float Extent, int32 TypeMask, TFunctionRef<void(const FFlareSpatialEntry&)> Visitor) const;
+
+
+	/*----------------------------------------------------
+		Data
+	----------------------------------------------------*/
+
+	/** Cell size in cm */
+	float                                CellSize;
+
+	/** All bodies */
+	TArray<FFlareSpatialEntry>           Entries;
+
+	/** Bodies larger than a cell, tested by every query */
+	TArray<int32>                        LargeEntries;
+
+	/** Cell key and body index, sorted by cell key */
+	TArray<TPair<uint64, int32>>         CellEntries;
+
+	/** Range of each non empty cell in CellEntries */
+	TMap<uint64, FIntPoint>              Cells;
+
+};
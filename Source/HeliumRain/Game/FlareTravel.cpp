@@ -217,6 +217,11 @@ void UFlareTravel::GenerateTravelDuration()
 }
 
 int64 UFlareTravel::ComputeTravelDuration(UFlareWorld* World, UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector)
+{
+	return World->GetTravelDuration(OriginSector, DestinationSector);
+}
+
+int64 UFlareTravel::ComputeOrbitalTravelDuration(UFlareWorld* World, UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector)
 {
 	int64 TravelDuration = 0;
 
@@ -78,8 +78,12 @@ public:
 
 	FFlareSectorOrbitParameters ComputeCurrentTravelLocation();
 
+	/** Get the travel duration between two sectors, in days. Uses the world travel duration table when possible */
 	static int64 ComputeTravelDuration(UFlareWorld* World, UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector);
 
+	/** Compute the travel duration between two sectors from their orbits, in days */
+	static int64 ComputeOrbitalTravelDuration(UFlareWorld* World, UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector);
+
 	static int64 ComputePhaseTravelDuration(UFlareWorld* World, FFlareCelestialBody* CelestialBody, double Altitude, double OriginPhase, double DestinationPhase);
 
 	static int64 ComputeAltitudeTravelDuration(UFlareWorld* World, FFlareCelestialBody* OriginCelestialBody, double OriginAltitude, FFlareCelestialBody* DestinationCelestialBody, double DestinationAltitude);
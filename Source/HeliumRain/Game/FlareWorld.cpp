@@ -7,6 +7,9 @@
 #include "FlareTravel.h"
 #include "FlareFleet.h"
 #include "FlareBattle.h"
+#include "FlareGameTools.h"
+
+#include "Async/ParallelFor.h"
 
 #include "../Data/FlareSectorCatalogEntry.h"
 #include "../Player/FlarePlayerController.h"
@@ -15,6 +18,8 @@
 
 #define FLEET_SUPPLY_CONSUMPTION_STATS 365
 
+//#define DEBUG_AI_TIMINGS
+
 /*----------------------------------------------------
     Constructor
 ----------------------------------------------------*/
@@ -96,6 +101,9 @@ void UFlareWorld::Load(const FFlareWorldSave& Data)
 		LoadSector(SectorDescription, *SectorSave, OrbitParameters);
 	}
 
+	// Sector orbits are static, travel durations can be computed once
+	UpdateTravelDurations();
+
 	// Load all travels
 	for (int32 i = 0; i < WorldData.TravelData.Num(); i++)
 	{
@@ -126,7 +134,9 @@ UFlareCompany* UFlareWorld::LoadCompany(const FFlareCompanySave& CompanyData)
     // Create the new company
 	Company = NewObject<UFlareCompany>(this, UFlareCompany::StaticClass(), CompanyData.Identifier);
     Company->Load(CompanyData);
-    Companies.AddUnique(Company);
+    Company->SetWorldIndex(Companies.AddUnique(Company));
+	CompaniesByIdentifier.Add(Company->GetIdentifier(), Company);
+	UpdateCompanyHostilities();
 
 	//FLOGV("UFlareWorld::LoadCompany : loaded '%s'", *Company->GetCompanyName().ToString());
 
@@ -141,7 +151,8 @@ UFlareSimulatedSector* UFlareWorld::LoadSector(const FFlareSectorDescription* De
 	// Create the new sector
 	Sector = NewObject<UFlareSimulatedSector>(this, UFlareSimulatedSector::StaticClass(), SectorData.Identifier);
 	Sector->Load(Description, SectorData, OrbitParameters);
-	Sectors.AddUnique(Sector);
+	Sector->SetWorldIndex(Sectors.AddUnique(Sector));
+	SectorsByIdentifier.Add(Sector->GetIdentifier(), Sector);
 
 	//FLOGV("UFlareWorld::LoadSector : loaded '%s'", *Sector->GetSectorName().ToString());
 
@@ -406,14 +417,24 @@ bool UFlareWorld::CheckIntegrity()
 			}
 		}
 	}
+
+	// Check lookup indices
+	if (!CheckIndexIntegrity())
+	{
+		Integrity = false;
+	}
+
 	return Integrity;
 }
 
 void UFlareWorld::Simulate()
 {
 	double StartTs = FPlatformTime::Seconds();
+	double PhaseTs = StartTs;
 	UFlareCompany* PlayerCompany = Game->GetPC()->GetCompany();
 
+	SimulationTimings.CompanyAI.Init(0, Companies.Num());
+
 	/**
 	 *  End previous day
 	 */
@@ -478,16 +499,117 @@ void UFlareWorld::Simulate()
 		}
 	}
 
+	// Companies see the outcome of the battles
+	FlushDamageStates();
+
+	SimulationTimings.Battles = FPlatformTime::Seconds() - PhaseTs;
+	PhaseTs = FPlatformTime::Seconds();
+
 	FLOG("* Simulate > AI");
-	// AI. Play them in random order
+	// All companies plan against the same economy state
+	EconomySnapshot.Build(Game);
+
+	// AI. Play them in random order, the same for every step
+	FRandomStream OrderStream(UFlareGameTools::DeterministicSimulation ? GetTypeHash(WorldData.Date) : FMath::Rand());
 	TArray<UFlareCompany*> CompaniesToSimulateAI = Companies;
+	TArray<UFlareCompany*> AIOrder;
 	while(CompaniesToSimulateAI.Num())
 	{
-		int32 Index = FMath::RandRange(0, CompaniesToSimulateAI.Num() - 1);
-		CompaniesToSimulateAI[Index]->SimulateAI();
+		int32 Index = OrderStream.RandRange(0, CompaniesToSimulateAI.Num() - 1);
+		AIOrder.Add(CompaniesToSimulateAI[Index]);
 		CompaniesToSimulateAI.RemoveAt(Index);
 	}
 
+	// Each company draws from its own stream, so that decisions don't depend on the AI order
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		int32 Seed;
+
+		if (UFlareGameTools::DeterministicSimulation)
+		{
+			Seed = HashCombine(GetTypeHash(WorldData.Date), GetTypeHash(CompanyIndex));
+		}
+		else
+		{
+			Seed = FMath::Rand();
+		}
+
+		Companies[CompanyIndex]->GetAI()->SetSimulationSeed(Seed);
+	}
+
+	// Battle resolution and diplomacy change the world : game thread
+	TArray<double> CompanyAITimes;
+	TArray<double> CompanyPlanTimes;
+	CompanyAITimes.Init(0, Companies.Num());
+	CompanyPlanTimes.Init(0, Companies.Num());
+	for (int32 OrderIndex = 0; OrderIndex < AIOrder.Num(); OrderIndex++)
+	{
+		double CompanyTs = FPlatformTime::Seconds();
+		AIOrder[OrderIndex]->GetAI()->PrepareSimulation();
+		CompanyAITimes[OrderIndex] += FPlatformTime::Seconds() - CompanyTs;
+	}
+
+	// Reading a battle state flushes it, so capture them for the planning once diplomacy is done
+	for (int32 OrderIndex = 0; OrderIndex < AIOrder.Num(); OrderIndex++)
+	{
+		double CompanyTs = FPlatformTime::Seconds();
+		AIOrder[OrderIndex]->GetAI()->CaptureBattleStates();
+		CompanyAITimes[OrderIndex] += FPlatformTime::Seconds() - CompanyTs;
+	}
+
+	// Planning only reads the world and the snapshot, and writes to its own company AI
+	ParallelFor(AIOrder.Num(), [&AIOrder, &CompanyAITimes, &CompanyPlanTimes](int32 OrderIndex)
+	{
+		double CompanyTs = FPlatformTime::Seconds();
+		AIOrder[OrderIndex]->GetAI()->PlanSimulation();
+		CompanyPlanTimes[OrderIndex] = FPlatformTime::Seconds() - CompanyTs;
+		CompanyAITimes[OrderIndex] += CompanyPlanTimes[OrderIndex];
+	}, !UFlareGameTools::ParallelSimulation);
+
+	// Decisions are applied in order, against the live world state
+	for (int32 OrderIndex = 0; OrderIndex < AIOrder.Num(); OrderIndex++)
+	{
+		double CompanyTs = FPlatformTime::Seconds();
+		AIOrder[OrderIndex]->GetAI()->CommitSimulation();
+		CompanyAITimes[OrderIndex] += FPlatformTime::Seconds() - CompanyTs;
+
+		int32 CompanyIndex = AIOrder[OrderIndex]->GetWorldIndex();
+		if (SimulationTimings.CompanyAI.IsValidIndex(CompanyIndex))
+		{
+			SimulationTimings.CompanyAI[CompanyIndex] = CompanyAITimes[OrderIndex];
+		}
+	}
+	EconomySnapshot.Reset();
+
+	// Per-company AI time, planning companies are marked with a star
+	FString CompanyTimings;
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		if (!SimulationTimings.CompanyAI.IsValidIndex(CompanyIndex))
+		{
+			continue;
+		}
+
+		CompanyTimings += FString::Printf(TEXT(" %s%s=%.6fs"),
+			*Companies[CompanyIndex]->GetShortName().ToString(),
+			(Companies[CompanyIndex]->GetAI()->IsPlanningDay() ? TEXT("*") : TEXT("")),
+			SimulationTimings.CompanyAI[CompanyIndex]);
+	}
+	FLOGV("* Simulate > AI timings :%s", *CompanyTimings);
+
+#ifdef DEBUG_AI_TIMINGS
+	// Time of the parallel planning step, in AI order
+	for (int32 OrderIndex = 0; OrderIndex < AIOrder.Num(); OrderIndex++)
+	{
+		FLOGV("* Simulate > AI timings : %s planned in %.6fs, prepared and committed in %.6fs",
+			*AIOrder[OrderIndex]->GetShortName().ToString(),
+			CompanyPlanTimes[OrderIndex],
+			CompanyAITimes[OrderIndex] - CompanyPlanTimes[OrderIndex]);
+	}
+#endif
+
+	SimulationTimings.AI = FPlatformTime::Seconds() - PhaseTs;
+
 	// Clear bombs
 	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
 	{
@@ -530,20 +652,38 @@ void UFlareWorld::Simulate()
 	ProcessShipCapture();
 	ProcessStationCapture();
 
+	// Sector random streams, seeded on the game thread before any sector-local phase
+	SeedSectorSimulation();
+
 	// Factories
 	FLOG("* Simulate > Factories");
+	PhaseTs = FPlatformTime::Seconds();
 	for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
 	{
 		Factories[FactoryIndex]->Simulate();
 	}
+	SimulationTimings.Factories = FPlatformTime::Seconds() - PhaseTs;
+	PhaseTs = FPlatformTime::Seconds();
 
-	// Peoples
+	// Peoples. Company payments are deferred and merged in sector order
 	FLOG("* Simulate > Peoples");
 	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		Sectors[SectorIndex]->GetPeople()->BeginDeferredMoney();
+	}
+
+	ParallelFor(Sectors.Num(), [this](int32 SectorIndex)
 	{
 		Sectors[SectorIndex]->GetPeople()->Simulate();
+	}, !UFlareGameTools::ParallelSimulation);
+
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		Sectors[SectorIndex]->GetPeople()->CommitDeferredMoney();
 	}
 
+	SimulationTimings.People = FPlatformTime::Seconds() - PhaseTs;
+	PhaseTs = FPlatformTime::Seconds();
 
 	FLOG("* Simulate > Trade routes");
 
@@ -557,6 +697,9 @@ void UFlareWorld::Simulate()
 			TradeRoutes[RouteIndex]->Simulate();
 		}
 	}
+	SimulationTimings.TradeRoutes = FPlatformTime::Seconds() - PhaseTs;
+	PhaseTs = FPlatformTime::Seconds();
+
 	FLOG("* Simulate > Travels");
 	// Travels
 	TArray<UFlareTravel*> TravelsToProcess = Travels;
@@ -565,6 +708,8 @@ void UFlareWorld::Simulate()
 		TravelsToProcess[TravelIndex]->Simulate();
 	}
 
+	SimulationTimings.Travels = FPlatformTime::Seconds() - PhaseTs;
+
 	FLOG("* Simulate > Reputation");
 	// Reputation stabilization
 	for (UFlareCompany* Company : Companies)
@@ -573,28 +718,27 @@ void UFlareWorld::Simulate()
 	}
 
 	FLOG("* Simulate > Prices");
+	PhaseTs = FPlatformTime::Seconds();
 	// Price variation.
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	ParallelFor(Sectors.Num(), [this](int32 SectorIndex)
 	{
 		Sectors[SectorIndex]->SimulatePriceVariation();
-	}
+	}, !UFlareGameTools::ParallelSimulation);
 
 	// People money migration
 	SimulatePeopleMoneyMigration();
 
 	// Process events
 
-	// Swap Prices.
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	// Swap prices and update reserve ships. Battle states are read on worker threads : nothing must be left to publish
+	FlushDamageStates();
+	ParallelFor(Sectors.Num(), [this](int32 SectorIndex)
 	{
 		Sectors[SectorIndex]->SwapPrices();
-	}
-	
-	// Update reserve ships
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
-	{
 		Sectors[SectorIndex]->UpdateReserveShips();
-	}
+	}, !UFlareGameTools::ParallelSimulation);
+
+	SimulationTimings.Prices = FPlatformTime::Seconds() - PhaseTs;
 
 	// Player being attacked ?
 	ProcessIncomingPlayerEnemy();
@@ -604,11 +748,147 @@ void UFlareWorld::Simulate()
 
 	
 	double EndTs = FPlatformTime::Seconds();
+	SimulationTimings.Total = EndTs - StartTs;
 	FLOGV("** Simulate day %d done in %.6fs", WorldData.Date-1, EndTs- StartTs);
 
 	GameLog::DaySimulated(WorldData.Date);
 }
 
+void UFlareWorld::SeedSectorSimulation()
+{
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		int32 Seed;
+
+		if (UFlareGameTools::DeterministicSimulation)
+		{
+			Seed = HashCombine(GetTypeHash(WorldData.Date), GetTypeHash(SectorIndex));
+		}
+		else
+		{
+			Seed = FMath::Rand();
+		}
+
+		Sectors[SectorIndex]->SetSimulationSeed(Seed);
+	}
+}
+
+void UFlareWorld::UpdateTravelDurations()
+{
+	int32 SectorCount = Sectors.Num();
+	TravelDurations.SetNumUninitialized(SectorCount * SectorCount);
+
+	for (int32 OriginIndex = 0; OriginIndex < SectorCount; OriginIndex++)
+	{
+		for (int32 DestinationIndex = 0; DestinationIndex < SectorCount; DestinationIndex++)
+		{
+			TravelDurations[OriginIndex * SectorCount + DestinationIndex] =
+				UFlareTravel::ComputeOrbitalTravelDuration(this, Sectors[OriginIndex], Sectors[DestinationIndex]);
+		}
+	}
+}
+
+void UFlareWorld::FlushDamageStates()
+{
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		Sectors[SectorIndex]->FlushDamageStates();
+	}
+
+	for (int TravelIndex = 0; TravelIndex < Travels.Num(); TravelIndex++)
+	{
+		Travels[TravelIndex]->GetTravelSector()->FlushDamageStates();
+	}
+}
+
+void UFlareWorld::OnHostilityChanged()
+{
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		Sectors[SectorIndex]->InvalidateHostilities();
+	}
+
+	for (int TravelIndex = 0; TravelIndex < Travels.Num(); TravelIndex++)
+	{
+		Travels[TravelIndex]->GetTravelSector()->InvalidateHostilities();
+	}
+}
+
+void UFlareWorld::UpdateCompanyHostilities()
+{
+	int32 CompanyCount = Companies.Num();
+	CompanyHostilitiesSize = CompanyCount;
+	CompanyHostilities.Init(false, CompanyCount * CompanyCount);
+	CompanyWars.Init(false, CompanyCount * CompanyCount);
+
+	for (int32 SourceIndex = 0; SourceIndex < CompanyCount; SourceIndex++)
+	{
+		const TArray<FName>& HostileCompanies = Companies[SourceIndex]->GetHostileCompanies();
+
+		for (int32 HostileIndex = 0; HostileIndex < HostileCompanies.Num(); HostileIndex++)
+		{
+			UFlareCompany* Target = FindCompany(HostileCompanies[HostileIndex]);
+			if (Target && Target != Companies[SourceIndex])
+			{
+				int32 TargetIndex = Target->GetWorldIndex();
+				CompanyHostilities[SourceIndex * CompanyCount + TargetIndex] = true;
+				CompanyWars[SourceIndex * CompanyCount + TargetIndex] = true;
+				CompanyWars[TargetIndex * CompanyCount + SourceIndex] = true;
+			}
+		}
+	}
+
+	OnHostilityChanged();
+}
+
+void UFlareWorld::SetCompanyHostility(const UFlareCompany* Source, const UFlareCompany* Target, bool Hostile)
+{
+	int32 SourceIndex = Source->GetWorldIndex();
+	int32 TargetIndex = Target->GetWorldIndex();
+
+	if (SourceIndex < 0 || TargetIndex < 0 || SourceIndex >= CompanyHostilitiesSize || TargetIndex >= CompanyHostilitiesSize)
+	{
+		UpdateCompanyHostilities();
+		return;
+	}
+
+	int32 CompanyCount = CompanyHostilitiesSize;
+	CompanyHostilities[SourceIndex * CompanyCount + TargetIndex] = Hostile;
+
+	bool War = Hostile || CompanyHostilities[TargetIndex * CompanyCount + SourceIndex];
+	CompanyWars[SourceIndex * CompanyCount + TargetIndex] = War;
+	CompanyWars[TargetIndex * CompanyCount + SourceIndex] = War;
+
+	OnHostilityChanged();
+}
+
+bool UFlareWorld::IsCompanyHostile(const UFlareCompany* Source, const UFlareCompany* Target) const
+{
+	int32 SourceIndex = Source->GetWorldIndex();
+	int32 TargetIndex = Target->GetWorldIndex();
+
+	if (SourceIndex < 0 || TargetIndex < 0 || SourceIndex >= CompanyHostilitiesSize || TargetIndex >= CompanyHostilitiesSize)
+	{
+		return Source->GetHostileCompanies().Contains(Target->GetIdentifier());
+	}
+
+	return CompanyHostilities[SourceIndex * CompanyHostilitiesSize + TargetIndex];
+}
+
+bool UFlareWorld::IsCompanyAtWar(const UFlareCompany* Source, const UFlareCompany* Target) const
+{
+	int32 SourceIndex = Source->GetWorldIndex();
+	int32 TargetIndex = Target->GetWorldIndex();
+
+	if (SourceIndex < 0 || TargetIndex < 0 || SourceIndex >= CompanyHostilitiesSize || TargetIndex >= CompanyHostilitiesSize)
+	{
+		return Source->GetHostileCompanies().Contains(Target->GetIdentifier())
+			|| Target->GetHostileCompanies().Contains(Source->GetIdentifier());
+	}
+
+	return CompanyWars[SourceIndex * CompanyHostilitiesSize + TargetIndex];
+}
+
 void UFlareWorld::CheckAIBattleState()
 {
 	for (UFlareCompany* Company : Companies)
@@ -842,7 +1122,7 @@ void UFlareWorld::SimulatePeopleMoneyMigration()
 				float TotalWealth = WealthA + WealthB;
 
 				float PercentRatio = 0.05f; // 5% at max
-				float TravelDuration = FMath::Max(1.f, (float) UFlareTravel::ComputeTravelDuration(this, SectorA, SectorB));
+				float TravelDuration = FMath::Max(1.f, (float) GetTravelDuration(SectorA, SectorB));
 
 				if(TotalWealth > 0)
 				{
@@ -1098,15 +1378,8 @@ void UFlareWorld::DeleteTravel(UFlareTravel* Travel)
 
 UFlareCompany* UFlareWorld::FindCompany(FName Identifier) const
 {
-	for (int i = 0; i < Companies.Num(); i++)
-	{
-		UFlareCompany* Company = Companies[i];
-		if (Company->GetIdentifier() == Identifier)
-		{
-			return Company;
-		}
-	}
-	return NULL;
+	UFlareCompany* const* Company = CompaniesByIdentifier.Find(Identifier);
+	return Company ? *Company : NULL;
 }
 
 UFlareCompany* UFlareWorld::FindCompanyByShortName(FName CompanyShortName) const
@@ -1125,73 +1398,159 @@ UFlareCompany* UFlareWorld::FindCompanyByShortName(FName CompanyShortName) const
 
 UFlareSimulatedSector* UFlareWorld::FindSector(FName Identifier) const
 {
-	for (int i = 0; i < Sectors.Num(); i++)
+	UFlareSimulatedSector* const* Sector = SectorsByIdentifier.Find(Identifier);
+	return Sector ? *Sector : NULL;
+}
+
+int64 UFlareWorld::GetTravelDuration(UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector)
+{
+	int32 SectorCount = Sectors.Num();
+	int32 OriginIndex = OriginSector->GetWorldIndex();
+	int32 DestinationIndex = DestinationSector->GetWorldIndex();
+
+	// Travel sectors move, compute them on demand
+	if (OriginIndex == INDEX_NONE || DestinationIndex == INDEX_NONE || TravelDurations.Num() != SectorCount * SectorCount)
 	{
-		UFlareSimulatedSector* Sector = Sectors[i];
-		if (Sector->GetIdentifier() == Identifier)
-		{
-			return Sector;
-		}
+		return UFlareTravel::ComputeOrbitalTravelDuration(this, OriginSector, DestinationSector);
 	}
-	return NULL;
+
+	return TravelDurations[OriginIndex * SectorCount + DestinationIndex];
 }
 
-UFlareSimulatedSector* UFlareWorld::FindSectorBySpacecraft(FName SpacecraftIdentifier) const
+UFlareSimulatedSector* UFlareWorld::FindSectorBySpacecraft(FName ShipImmatriculation) const
 {
-	for (int i = 0; i < Sectors.Num(); i++)
+	UFlareSimulatedSpacecraft* Spacecraft = FindSpacecraft(ShipImmatriculation);
+	return Spacecraft ? Spacecraft->GetCurrentSector() : NULL;
+}
+
+UFlareFleet* UFlareWorld::FindFleet(FName Identifier) const
+{
+	UFlareFleet* const* Fleet = FleetsByIdentifier.Find(Identifier);
+	return Fleet ? *Fleet : NULL;
+}
+
+UFlareTradeRoute* UFlareWorld::FindTradeRoute(FName Identifier) const
+{
+	UFlareTradeRoute* const* TradeRoute = TradeRoutesByIdentifier.Find(Identifier);
+	return TradeRoute ? *TradeRoute : NULL;
+}
+
+UFlareSimulatedSpacecraft* UFlareWorld::FindSpacecraft(FName ShipImmatriculation) const
+{
+	UFlareSimulatedSpacecraft* const* Spacecraft = SpacecraftsByImmatriculation.Find(ShipImmatriculation);
+	return Spacecraft ? *Spacecraft : NULL;
+}
+
+void UFlareWorld::IndexSpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	SpacecraftsByImmatriculation.Add(Spacecraft->GetImmatriculation(), Spacecraft);
+}
+
+void UFlareWorld::UnindexSpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	if (FindSpacecraft(Spacecraft->GetImmatriculation()) == Spacecraft)
 	{
-		UFlareSimulatedSector* Sector = Sectors[i];
-		for (int j = 0; j < Sector->GetSectorSpacecrafts().Num(); j++)
-		{
-			if (Sector->GetSectorSpacecrafts()[j]->GetDescription()->Identifier == SpacecraftIdentifier)
-			{
-				return Sector;
-			}
-		}
+		SpacecraftsByImmatriculation.Remove(Spacecraft->GetImmatriculation());
 	}
-	return NULL;
 }
 
-UFlareFleet* UFlareWorld::FindFleet(FName Identifier) const
+void UFlareWorld::IndexFleet(UFlareFleet* Fleet)
 {
-	for (int i = 0; i < Companies.Num(); i++)
+	FleetsByIdentifier.Add(Fleet->GetIdentifier(), Fleet);
+}
+
+void UFlareWorld::UnindexFleet(UFlareFleet* Fleet)
+{
+	if (FindFleet(Fleet->GetIdentifier()) == Fleet)
 	{
-		UFlareCompany* Company = Companies[i];
-		UFlareFleet* Fleet = Company->FindFleet(Identifier);
-		if (Fleet)
-		{
-			return Fleet;
-		}
+		FleetsByIdentifier.Remove(Fleet->GetIdentifier());
 	}
-	return NULL;
 }
 
-UFlareTradeRoute* UFlareWorld::FindTradeRoute(FName Identifier) const
+void UFlareWorld::IndexTradeRoute(UFlareTradeRoute* TradeRoute)
 {
-	for (int i = 0; i < Companies.Num(); i++)
+	TradeRoutesByIdentifier.Add(TradeRoute->GetIdentifier(), TradeRoute);
+}
+
+void UFlareWorld::UnindexTradeRoute(UFlareTradeRoute* TradeRoute)
+{
+	if (FindTradeRoute(TradeRoute->GetIdentifier()) == TradeRoute)
 	{
-		UFlareCompany* Company = Companies[i];
-		UFlareTradeRoute* TradeRoute = Company->FindTradeRoute(Identifier);
-		if (TradeRoute)
-		{
-			return TradeRoute;
-		}
+		TradeRoutesByIdentifier.Remove(TradeRoute->GetIdentifier());
 	}
-	return NULL;
 }
 
-UFlareSimulatedSpacecraft* UFlareWorld::FindSpacecraft(FName ShipImmatriculation)
+bool UFlareWorld::CheckIndexIntegrity()
 {
+	bool Integrity = true;
+	int32 SpacecraftCount = 0;
+	int32 FleetCount = 0;
+	int32 TradeRouteCount = 0;
+
+	for (int i = 0; i < Sectors.Num(); i++)
+	{
+		if (FindSector(Sectors[i]->GetIdentifier()) != Sectors[i])
+		{
+			FLOGV("WARNING : World integrity failure : sector %s is not indexed", *Sectors[i]->GetIdentifier().ToString());
+			Integrity = false;
+		}
+	}
+
 	for (int i = 0; i < Companies.Num(); i++)
 	{
 		UFlareCompany* Company = Companies[i];
-		UFlareSimulatedSpacecraft* Spacecraft = Company->FindSpacecraft(ShipImmatriculation);
-		if (Spacecraft)
+
+		if (FindCompany(Company->GetIdentifier()) != Company)
 		{
-			return Spacecraft;
+			FLOGV("WARNING : World integrity failure : company %s is not indexed", *Company->GetIdentifier().ToString());
+			Integrity = false;
+		}
+
+		for (UFlareSimulatedSpacecraft* Spacecraft : Company->GetCompanySpacecrafts())
+		{
+			if (FindSpacecraft(Spacecraft->GetImmatriculation()) != Spacecraft || Company->FindSpacecraft(Spacecraft->GetImmatriculation()) != Spacecraft)
+			{
+				FLOGV("WARNING : World integrity failure : spacecraft %s is not indexed", *Spacecraft->GetImmatriculation().ToString());
+				Integrity = false;
+			}
 		}
+
+		for (UFlareFleet* Fleet : Company->GetCompanyFleets())
+		{
+			if (FindFleet(Fleet->GetIdentifier()) != Fleet || Company->FindFleet(Fleet->GetIdentifier()) != Fleet)
+			{
+				FLOGV("WARNING : World integrity failure : fleet %s is not indexed", *Fleet->GetIdentifier().ToString());
+				Integrity = false;
+			}
+		}
+
+		for (UFlareTradeRoute* TradeRoute : Company->GetCompanyTradeRoutes())
+		{
+			if (FindTradeRoute(TradeRoute->GetIdentifier()) != TradeRoute || Company->FindTradeRoute(TradeRoute->GetIdentifier()) != TradeRoute)
+			{
+				FLOGV("WARNING : World integrity failure : trade route %s is not indexed", *TradeRoute->GetIdentifier().ToString());
+				Integrity = false;
+			}
+		}
+
+		SpacecraftCount += Company->GetCompanySpacecrafts().Num();
+		FleetCount += Company->GetCompanyFleets().Num();
+		TradeRouteCount += Company->GetCompanyTradeRoutes().Num();
 	}
-	return NULL;
+
+	if (CompaniesByIdentifier.Num() != Companies.Num()
+	 || SectorsByIdentifier.Num() != Sectors.Num()
+	 || SpacecraftsByImmatriculation.Num() != SpacecraftCount
+	 || FleetsByIdentifier.Num() != FleetCount
+	 || TradeRoutesByIdentifier.Num() != TradeRouteCount)
+	{
+		FLOGV("WARNING : World integrity failure : lookup indices contain %d companies, %d sectors, %d spacecrafts, %d fleets, %d trade routes but world has %d, %d, %d, %d, %d",
+			CompaniesByIdentifier.Num(), SectorsByIdentifier.Num(), SpacecraftsByImmatriculation.Num(), FleetsByIdentifier.Num(), TradeRoutesByIdentifier.Num(),
+			Companies.Num(), Sectors.Num(), SpacecraftCount, FleetCount, TradeRouteCount);
+		Integrity = false;
+	}
+
+	return Integrity;
 }
 
 
@@ -1249,4 +1608,10 @@ uint32 UFlareWorld::GetWorldPopulation()
 
 	return WorldPopulation;
 }
+
+const FFlareEconomySnapshot& UFlareWorld::GetEconomySnapshot() const
+{
+	FCHECK(EconomySnapshot.IsBuilt());
+	return EconomySnapshot;
+}
 #undef LOCTEXT_NAMESPACE
@@ -4,6 +4,7 @@
 #include "Object.h"
 #include "FlareGameTypes.h"
 #include "FlareTravel.h"
+#include "FlareEconomySnapshot.h"
 #include "Planetarium/FlareSimulatedPlanetarium.h"
 #include "FlareWorld.generated.h"
 
@@ -69,6 +70,33 @@ struct FFlareWorldEvent
 	TEnumAsByte<EFlareEventVisibility::Type>  Visibility;
 };
 
+/** Time spent in each phase of a simulated day, in seconds */
+struct FFlareWorldSimulationTimings
+{
+	double Battles;
+	double AI;
+	double Factories;
+	double People;
+	double TradeRoutes;
+	double Travels;
+	double Prices;
+	double Total;
+
+	/** AI time of each company, in world company order */
+	TArray<double> CompanyAI;
+
+	FFlareWorldSimulationTimings()
+		: Battles(0)
+		, AI(0)
+		, Factories(0)
+		, People(0)
+		, TradeRoutes(0)
+		, Travels(0)
+		, Prices(0)
+		, Total(0)
+	{}
+};
+
 UCLASS()
 class HELIUMRAIN_API UFlareWorld: public UObject
 {
@@ -116,6 +144,45 @@ public:
 	/** Simulate world for a day */
 	void Simulate();
 
+	/** Seed the random stream of each sector for the sector-local phases of the day */
+	void SeedSectorSimulation();
+
+	/** Precompute the travel duration between every pair of sectors */
+	void UpdateTravelDurations();
+
+	/** Publish the damage states of all spacecrafts damaged since the last flush */
+	void FlushDamageStates();
+
+	/** A company changed its hostility toward another company */
+	void OnHostilityChanged();
+
+	/** Rebuild the company hostility matrix from the hostility lists of each company */
+	void UpdateCompanyHostilities();
+
+	/** Set whether Source is hostile to Target in the company hostility matrix */
+	void SetCompanyHostility(const UFlareCompany* Source, const UFlareCompany* Target, bool Hostile);
+
+	/** Add a spacecraft to the world lookup index */
+	void IndexSpacecraft(UFlareSimulatedSpacecraft* Spacecraft);
+
+	/** Remove a spacecraft from the world lookup index */
+	void UnindexSpacecraft(UFlareSimulatedSpacecraft* Spacecraft);
+
+	/** Add a fleet to the world lookup index */
+	void IndexFleet(UFlareFleet* Fleet);
+
+	/** Remove a fleet from the world lookup index */
+	void UnindexFleet(UFlareFleet* Fleet);
+
+	/** Add a trade route to the world lookup index */
+	void IndexTradeRoute(UFlareTradeRoute* TradeRoute);
+
+	/** Remove a trade route from the world lookup index */
+	void UnindexTradeRoute(UFlareTradeRoute* TradeRoute);
+
+	/** Check that the lookup indices match the world arrays */
+	bool CheckIndexIntegrity();
+
 	void SimulatePeopleMoneyMigration();
 
 	/** Simulate world from now to the next event */
@@ -166,6 +233,31 @@ protected:
 	UPROPERTY()
 	UFlareSimulatedPlanetarium*			Planetarium;
 
+	/** Travel durations in days, indexed by [OriginIndex * SectorCount + DestinationIndex] */
+	TArray<int64>                       TravelDurations;
+
+	/** Company hostilities, indexed by [SourceIndex * CompanyCount + TargetIndex] */
+	TBitArray<>                         CompanyHostilities;
+
+	/** Company war states, symmetric version of CompanyHostilities */
+	TBitArray<>                         CompanyWars;
+
+	/** Number of companies the hostility matrices were built for */
+	int32                               CompanyHostilitiesSize;
+
+	/** Lookup indices, the arrays above keep the objects referenced */
+	TMap<FName, UFlareCompany*>             CompaniesByIdentifier;
+	TMap<FName, UFlareSimulatedSector*>     SectorsByIdentifier;
+	TMap<FName, UFlareSimulatedSpacecraft*> SpacecraftsByImmatriculation;
+	TMap<FName, UFlareFleet*>               FleetsByIdentifier;
+	TMap<FName, UFlareTradeRoute*>          TradeRoutesByIdentifier;
+
+	/** Phase timings of the last simulated day */
+	FFlareWorldSimulationTimings            SimulationTimings;
+
+	/** Economy state shared by the AI companies during the AI phase */
+	FFlareEconomySnapshot                   EconomySnapshot;
+
 	AFlareGame*                             Game;
 
 	bool WorldMoneyReferenceInit;
@@ -210,19 +302,33 @@ public:
 		return WorldData.Date;
 	}
 
+	inline const FFlareWorldSimulationTimings& GetSimulationTimings() const
+	{
+		return SimulationTimings;
+	}
+
 	UFlareCompany* FindCompany(FName Identifier) const;
 
 	UFlareCompany* FindCompanyByShortName(FName CompanyShortName) const;
 
 	UFlareSimulatedSector* FindSector(FName Identifier) const;
 
-	UFlareSimulatedSector* FindSectorBySpacecraft(FName SpacecraftIdentifier) const;
+	/** Get the travel duration between two sectors, in days */
+	int64 GetTravelDuration(UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector);
+
+	UFlareSimulatedSector* FindSectorBySpacecraft(FName ShipImmatriculation) const;
 
 	UFlareFleet* FindFleet(FName Identifier) const;
 
 	UFlareTradeRoute* FindTradeRoute(FName Identifier) const;
 
-	UFlareSimulatedSpacecraft* FindSpacecraft(FName ShipImmatriculation);
+	UFlareSimulatedSpacecraft* FindSpacecraft(FName ShipImmatriculation) const;
+
+	/** Check if Source is hostile to Target */
+	bool IsCompanyHostile(const UFlareCompany* Source, const UFlareCompany* Target) const;
+
+	/** Check if Source or Target is hostile to the other one */
+	bool IsCompanyAtWar(const UFlareCompany* Source, const UFlareCompany* Target) const;
 
 	inline const TArray<UFlareCompany*>& GetCompanies() const
 	{
@@ -233,4 +339,7 @@ public:
 
 	uint32 GetWorldPopulation();
 
+	/** Get the economy snapshot of the current AI phase. Only valid during the AI phase, it is built on the game thread before */
+	const FFlareEconomySnapshot& GetEconomySnapshot() const;
+
 };
@@ -10,37 +10,41 @@
 #include "../../Spacecrafts/FlareSimulatedSpacecraft.h"
 #include "../Save/FlareSaveWriter.h"
 
+/** Name of a damage type, read from the enum once per type */
+static FName GetDamageTypeName(EFlareDamage::Type DamageType)
+{
+	static TMap<int32, FName> DamageTypeNames;
+
+	FName* Name = DamageTypeNames.Find(DamageType);
+	if (!Name)
+	{
+		Name = &DamageTypeNames.Add(DamageType, FName(*UFlareSaveWriter::FormatEnum<EFlareDamage::Type>("EFlareDamage", DamageType)));
+	}
+
+	return *Name;
+}
+
+
 // Game log api
 
 void GameLog::GameLoaded()
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Game;
-	Message.Event = EFlareLogEvent::GAME_LOADED;
+	FlareLogMessage Message(EFlareLogTarget::Game, EFlareLogEvent::GAME_LOADED);
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void GameLog::GameUnloaded()
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Game;
-	Message.Event = EFlareLogEvent::GAME_UNLOADED;
+	FlareLogMessage Message(EFlareLogTarget::Game, EFlareLogEvent::GAME_UNLOADED);
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 
 void GameLog::DaySimulated(int64 NewDate)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Game;
-	Message.Event = EFlareLogEvent::DAY_SIMULATED;
+	FlareLogMessage Message(EFlareLogTarget::Game, EFlareLogEvent::DAY_SIMULATED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::Integer;
-		Param.IntValue = NewDate;
-		Message.Params.Add(Param);
-	}
+	Message.AddInt(NewDate);
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
@@ -50,34 +54,12 @@ void GameLog::AIConstructionStart(UFlareCompany* Company,
 								FFlareSpacecraftDescription* ConstructionProjectStationDescription,
 								UFlareSimulatedSpacecraft* ConstructionProjectStation)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Game;
-	Message.Event = EFlareLogEvent::AI_CONSTRUCTION_STARTED;
+	FlareLogMessage Message(EFlareLogTarget::Game, EFlareLogEvent::AI_CONSTRUCTION_STARTED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Company->GetShortName().ToString();
-		Message.Params.Add(Param);
-	}
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = ConstructionProjectSector->GetIdentifier().ToString();
-		Message.Params.Add(Param);
-	}
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = ConstructionProjectStationDescription->Identifier.ToString();
-		Message.Params.Add(Param);
-	}
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = (ConstructionProjectStation ? ConstructionProjectStation->GetImmatriculation().ToString() : "");
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Company->GetShortName());
+	Message.AddString(ConstructionProjectSector->GetIdentifier());
+	Message.AddString(ConstructionProjectStationDescription->Identifier);
+	Message.AddString(ConstructionProjectStation ? ConstructionProjectStation->GetImmatriculation() : NAME_None);
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
@@ -86,256 +68,97 @@ void GameLog::AIConstructionStart(UFlareCompany* Company,
 
 void CombatLog::SectorActivated(UFlareSimulatedSector* Sector)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::SECTOR_ACTIVATED;
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::SECTOR_ACTIVATED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Sector->GetIdentifier().ToString();
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Sector->GetIdentifier());
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::SectorDeactivated(UFlareSimulatedSector* Sector)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::SECTOR_DEACTIVATED;
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::SECTOR_DEACTIVATED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Sector->GetIdentifier().ToString();
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Sector->GetIdentifier());
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::AutomaticBattleStarted(UFlareSimulatedSector* Sector)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::AUTOMATIC_BATTLE_STARTED;
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::AUTOMATIC_BATTLE_STARTED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Sector->GetIdentifier().ToString();
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Sector->GetIdentifier());
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::AutomaticBattleEnded(UFlareSimulatedSector* Sector)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::AUTOMATIC_BATTLE_ENDED;
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::AUTOMATIC_BATTLE_ENDED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Sector->GetIdentifier().ToString();
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Sector->GetIdentifier());
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::BombDropped(AFlareBomb *Bomb)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::BOMB_DROPPED;
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::BOMB_DROPPED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Bomb->GetIdentifier().ToString();
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Bomb->GetFiringSpacecraft()->GetImmatriculation().ToString();
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Bomb->GetFiringWeapon()->Save()->ShipSlotIdentifier.ToString();
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Bomb->GetFiringWeapon()->GetDescription()->Identifier.ToString();
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Bomb->GetIdentifier());
+	Message.AddString(Bomb->GetFiringSpacecraft()->GetImmatriculation());
+	Message.AddString(Bomb->GetFiringWeapon()->Save()->ShipSlotIdentifier);
+	Message.AddString(Bomb->GetFiringWeapon()->GetDescription()->Identifier);
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::BombDestroyed(FName BombIdentifier)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::BOMB_DESTROYED;
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::BOMB_DESTROYED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = BombIdentifier.ToString();
-		Message.Params.Add(Param);
-	}
+	Message.AddString(BombIdentifier);
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::SpacecraftDamaged(UFlareSimulatedSpacecraft* Spacecraft, float Energy, float Radius, FVector RelativeLocation, EFlareDamage::Type DamageType, UFlareCompany* DamageSource)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::SPACECRAFT_DAMAGED;
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Spacecraft->GetImmatriculation().ToString();
-		Message.Params.Add(Param);
-	}
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::SPACECRAFT_DAMAGED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = UFlareSaveWriter::FormatEnum<EFlareDamage::Type>("EFlareDamage", DamageType);
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::Float;
-		Param.FloatValue = Energy;
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::Float;
-		Param.FloatValue = Radius;
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::Vector3;
-		Param.Vector3Value = RelativeLocation;
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue =  (DamageSource ? DamageSource->GetShortName().ToString() : "");
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Spacecraft->GetImmatriculation());
+	Message.AddString(GetDamageTypeName(DamageType));
+	Message.AddFloat(Energy);
+	Message.AddFloat(Radius);
+	Message.AddVector(RelativeLocation);
+	Message.AddString(DamageSource ? DamageSource->GetShortName() : NAME_None);
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::SpacecraftComponentDamaged(UFlareSimulatedSpacecraft* Spacecraft, FFlareSpacecraftComponentSave* ComponentData, FFlareSpacecraftComponentDescription* ComponentDescription, float Energy, float EffectiveEnergy, EFlareDamage::Type DamageType, float InitialDamageRatio, float TerminalDamageRatio)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::SPACECRAFT_COMPONENT_DAMAGED;
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Spacecraft->GetImmatriculation().ToString();
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = ComponentData->ShipSlotIdentifier.ToString();
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = ComponentDescription->Identifier.ToString();
-		Message.Params.Add(Param);
-	}
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::SPACECRAFT_COMPONENT_DAMAGED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::Float;
-		Param.FloatValue = Energy;
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::Float;
-		Param.FloatValue = EffectiveEnergy;
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = UFlareSaveWriter::FormatEnum<EFlareDamage::Type>("EFlareDamage", DamageType);
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::Float;
-		Param.FloatValue = InitialDamageRatio;
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::Float;
-		Param.FloatValue = TerminalDamageRatio;
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Spacecraft->GetImmatriculation());
+	Message.AddString(ComponentData->ShipSlotIdentifier);
+	Message.AddString(ComponentDescription->Identifier);
+	Message.AddFloat(Energy);
+	Message.AddFloat(EffectiveEnergy);
+	Message.AddString(GetDamageTypeName(DamageType));
+	Message.AddFloat(InitialDamageRatio);
+	Message.AddFloat(TerminalDamageRatio);
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::SpacecraftHarpooned(UFlareSimulatedSpacecraft* Spacecraft, UFlareCompany* HarpoonOwner)
 {
-	FlareLogMessage Message;
-	Message.Target = EFlareLogTarget::Combat;
-	Message.Event = EFlareLogEvent::SPACECRAFT_HARPOONED;
+	FlareLogMessage Message(EFlareLogTarget::Combat, EFlareLogEvent::SPACECRAFT_HARPOONED);
 
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue = Spacecraft->GetImmatriculation().ToString();
-		Message.Params.Add(Param);
-	}
-
-	{
-		FlareLogMessageParam Param;
-		Param.Type = EFlareLogParam::String;
-		Param.StringValue =  (HarpoonOwner ? HarpoonOwner->GetShortName().ToString() : "");
-		Message.Params.Add(Param);
-	}
+	Message.AddString(Spacecraft->GetImmatriculation());
+	Message.AddString(HarpoonOwner ? HarpoonOwner->GetShortName() : NAME_None);
 
 	FFlareLogWriter::PushWriterMessage(Message);
 }
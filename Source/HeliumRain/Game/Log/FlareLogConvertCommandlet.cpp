@@ -0,0 +1,39 @@
+#include "../../Flare.h"
+#include "FlareLogConvertCommandlet.h"
+#include "FlareLogWriter.h"
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+UFlareLogConvertCommandlet::UFlareLogConvertCommandlet(const class FObjectInitializer& PCIP)
+	: Super(PCIP)
+{
+	IsClient = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+/*----------------------------------------------------
+	Commandlet
+----------------------------------------------------*/
+
+int32 UFlareLogConvertCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	ParseCommandLine(*Params, Tokens, Switches);
+
+	if (Tokens.Num() < 1)
+	{
+		FLOG("UFlareLogConvertCommandlet::Main : usage is -run=FlareLogConvert <BinaryLog> [TextLog]");
+		return 1;
+	}
+
+	FString BinaryFileName = Tokens[0];
+	FString TextFileName = (Tokens.Num() > 1 ? Tokens[1] : FPaths::ChangeExtension(BinaryFileName, TEXT("txt")));
+
+	return FFlareLogWriter::ConvertBinaryLog(BinaryFileName, TextFileName) ? 0 : 1;
+}
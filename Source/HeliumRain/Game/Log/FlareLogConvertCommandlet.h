@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlareLogConvertCommandlet.generated.h"
+
+
+/** Convert binary game and combat logs to the text log format : -run=FlareLogConvert <BinaryLog> [TextLog] */
+UCLASS()
+class UFlareLogConvertCommandlet : public UCommandlet
+{
+public:
+
+	GENERATED_UCLASS_BODY()
+
+	virtual int32 Main(const FString& Params) override;
+
+};
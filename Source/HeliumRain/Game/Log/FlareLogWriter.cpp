@@ -1,25 +1,136 @@
 #include "../../Flare.h"
 #include "FlareLogWriter.h"
 #include "FlareLogApi.h"
+#include "../FlareGameTools.h"
 #include "../Save/FlareSaveWriter.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("LogWriter Overflow messages"), STAT_FlareLogWriter_Overflow, STATGROUP_Flare);
+
+/** Binary log identification */
+#define FLARE_LOG_BINARY_MAGIC           0x474F4C46
+#define FLARE_LOG_BINARY_VERSION         1
+
+/** Binary log entry kinds */
+#define FLARE_LOG_BINARY_NAME            0
+#define FLARE_LOG_BINARY_MESSAGE         1
+
+/** Messages that can wait in the queue, must be a power of two */
+#define FLARE_LOG_QUEUE_CAPACITY         8192
+
+/** File buffer size over which the buffer is written out */
+#define FLARE_LOG_FLUSH_SIZE             (256 * 1024)
+
+/** Maximum time between two writes in ms */
+#define FLARE_LOG_FLUSH_PERIOD           200
+
 //***********************************************************
 //Thread Worker Starts as NULL, prior to being instanced
 //		This line is essential! Compiler error without it
 FFlareLogWriter* FFlareLogWriter::Runnable = NULL;
 //***********************************************************
 
+TArray<FString> FFlareLogWriter::EventNames;
+
+
+/*----------------------------------------------------
+	Message queue
+----------------------------------------------------*/
+
+FFlareLogQueue::FFlareLogQueue(int32 QueueCapacity)
+	: Capacity(QueueCapacity)
+	, EnqueuePosition(0)
+	, DequeuePosition(0)
+{
+	check(FMath::IsPowerOfTwo(Capacity));
+
+	Slots = new FSlot[Capacity];
+	for (int32 Index = 0; Index < Capacity; Index++)
+	{
+		Slots[Index].Sequence = Index;
+	}
+}
+
+FFlareLogQueue::~FFlareLogQueue()
+{
+	delete[] Slots;
+}
+
+bool FFlareLogQueue::Enqueue(const FlareLogMessage& Message)
+{
+	int32 Position = EnqueuePosition;
+
+	while (true)
+	{
+		FSlot& Slot = Slots[(uint32)Position & (Capacity - 1)];
+		int32 Sequence = Slot.Sequence;
+		FPlatformMisc::MemoryBarrier();
+
+		// Positions wrap around, compare them as a difference
+		int32 Difference = (int32)((uint32)Sequence - (uint32)Position);
+
+		if (Difference == 0)
+		{
+			// Slot is free, claim it
+			int32 NextPosition = (int32)((uint32)Position + 1);
+			if (FPlatformAtomics::InterlockedCompareExchange(&EnqueuePosition, NextPosition, Position) == Position)
+			{
+				Slot.Message = Message;
+				FPlatformMisc::MemoryBarrier();
+				Slot.Sequence = NextPosition;
+				return true;
+			}
+		}
+		else if (Difference < 0)
+		{
+			// Slot not read yet : full
+			return false;
+		}
+
+		Position = EnqueuePosition;
+	}
+}
+
+bool FFlareLogQueue::Dequeue(FlareLogMessage& Message)
+{
+	FSlot& Slot = Slots[(uint32)DequeuePosition & (Capacity - 1)];
+	int32 Sequence = Slot.Sequence;
+	FPlatformMisc::MemoryBarrier();
+
+	int32 NextPosition = (int32)((uint32)DequeuePosition + 1);
+	if ((int32)((uint32)Sequence - (uint32)NextPosition) < 0)
+	{
+		return false;
+	}
+
+	Message = Slot.Message;
+	FPlatformMisc::MemoryBarrier();
+	Slot.Sequence = (int32)((uint32)DequeuePosition + Capacity);
+	DequeuePosition = NextPosition;
+	return true;
+}
+
+int32 FFlareLogQueue::Num() const
+{
+	return FMath::Clamp((int32)((uint32)EnqueuePosition - (uint32)DequeuePosition), 0, Capacity);
+}
+
+
+/*----------------------------------------------------
+	Writer thread
+----------------------------------------------------*/
+
 static int ThreadIndex = 0;
 
 FFlareLogWriter::FFlareLogWriter(FName UUID)
 	: StopTaskCounter(0),
+	  MessageQueue(FLARE_LOG_QUEUE_CAPACITY),
 	  GameUUID(UUID)
 
 {
 	FString Name = TEXT("FFlareLogWriter-") + FString::FromInt(ThreadIndex);
 
-	GameLogFile = NULL;
-	CombatLogFile = NULL;
+	// Created before the thread, messages can be pushed before Init runs
+	NewMessageEvent = FPlatformProcess::GetSynchEventFromPool(false);
 
 	Thread = FRunnableThread::Create(this, *Name, 0, TPri_BelowNormal); //windows default = 8mb for thread, could specify more
 	ThreadIndex++;
@@ -40,9 +151,6 @@ FFlareLogWriter::~FFlareLogWriter()
 //Init
 bool FFlareLogWriter::Init()
 {
-	//Init the Data
-	NewMessageEvent = FPlatformProcess::GetSynchEventFromPool(false);
-
 	return true;
 }
 
@@ -57,15 +165,12 @@ uint32 FFlareLogWriter::Run()
 	//		and not yet finished finding Prime Numbers
 	while (StopTaskCounter.GetValue() == 0)
 	{
-		NewMessageEvent->Wait();
-
-		FlareLogMessage Message;
-		while (MessageQueue.Dequeue(Message))
-		{
-			WriteMessage(Message);
-		}
+		// Producers only wake the thread when the queue fills up, write in batches otherwise
+		NewMessageEvent->Wait(FLARE_LOG_FLUSH_PERIOD);
+		WriteMessages();
 	}
 
+	WriteMessages();
 	CloseLogFiles();
 
 	return 0;
@@ -87,6 +192,7 @@ FFlareLogWriter* FFlareLogWriter::InitWriter(FName UUID)
 	//		and the platform supports multi threading!
 	if (!Runnable && FPlatformProcess::SupportsMultithreading())
 	{
+		InitEventNames();
 		Runnable = new FFlareLogWriter(UUID);
 		GameLog::GameLoaded();
 		return Runnable;
@@ -114,86 +220,394 @@ void FFlareLogWriter::Shutdown()
 
 void FFlareLogWriter::InitLogFiles()
 {
-	if(!GameLogFile)
+	bool Binary = UFlareGameTools::BinaryLogs;
+
+	if (!GameLogFile.Handle)
 	{
-		GameLogFile = InitLogFile("Game");
+		InitLogFile(GameLogFile, "Game", Binary);
 	}
 
-	if(!CombatLogFile)
+	if (!CombatLogFile.Handle)
 	{
-		CombatLogFile = InitLogFile("Combat");
+		InitLogFile(CombatLogFile, "Combat", Binary);
 	}
 }
 
 void FFlareLogWriter::CloseLogFiles()
 {
-	if (GameLogFile)
-	{
-		delete GameLogFile;
-		GameLogFile = NULL;
-	}
-
-	if (CombatLogFile)
-	{
-		delete CombatLogFile;
-		CombatLogFile = NULL;
-	}
+	CloseLogFile(GameLogFile);
+	CloseLogFile(CombatLogFile);
 }
 
-IFileHandle* FFlareLogWriter::InitLogFile(FString BaseName)
+void FFlareLogWriter::InitLogFile(FlareLogFile& File, FString BaseName, bool Binary)
 {
-	FString FileName = FString::Printf(TEXT("%s/SaveGames/%s-%s.log"), *FPaths::GameSavedDir(), *BaseName, *GameUUID.ToString());
+	FString FileName = FString::Printf(TEXT("%s/SaveGames/%s-%s.%s"), *FPaths::GameSavedDir(), *BaseName, *GameUUID.ToString(), Binary ? TEXT("flog") : TEXT("log"));
 
 	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
 
 	FLOGV("Init log file '%s'", *FileName);
-	IFileHandle* FileHandle = PlatformFile.OpenWrite(*FileName, true);
+	File.Handle = PlatformFile.OpenWrite(*FileName, true);
+	File.Binary = Binary;
+	File.Buffer.Reserve(FLARE_LOG_FLUSH_SIZE * 2);
+	File.NameIds.Empty();
 
-	if (!FileHandle)
+	if (!File.Handle)
 	{
 		FLOGV("Fail to init log file '%s' for base name '%s'", *FileName, *BaseName);
+		return;
 	}
 
-	return FileHandle;
+	// A binary file appended to a previous session redefines its names after a new header
+	if (Binary)
+	{
+		FMemoryWriter Writer(File.Buffer, false, true);
+		uint32 Magic = FLARE_LOG_BINARY_MAGIC;
+		uint32 Version = FLARE_LOG_BINARY_VERSION;
+		Writer << Magic;
+		Writer << Version;
+	}
 }
 
-void FFlareLogWriter::WriteLine(IFileHandle* FileHandle, FString& Line)
+void FFlareLogWriter::CloseLogFile(FlareLogFile& File)
 {
-	FileHandle->Write((const uint8*)TCHAR_TO_ANSI(*Line), Line.Len());
+	if (File.Handle)
+	{
+		FlushLogFile(File);
+		delete File.Handle;
+		File.Handle = NULL;
+	}
 }
 
-void FFlareLogWriter::WriteMessage(FlareLogMessage& Message)
+void FFlareLogWriter::FlushLogFile(FlareLogFile& File)
 {
-	FString MessageString = FormatMessage(Message);
+	if (File.Handle && File.Buffer.Num())
+	{
+		File.Handle->Write(File.Buffer.GetData(), File.Buffer.Num());
+	}
 
-	switch (Message.Target) {
-	case EFlareLogTarget::Game:
-		if (GameLogFile)
+	File.Buffer.Reset();
+}
+
+int32 FFlareLogWriter::WriteMessages()
+{
+	int32 MessageCount = 0;
+	FlareLogMessage Message;
+
+	while (MessageQueue.Dequeue(Message))
+	{
+		WriteMessage(Message);
+		MessageCount++;
+	}
+
+	// Messages that didn't fit in the queue are more recent than the queued ones
+	if (OverflowCount.GetValue() > 0)
+	{
+		TArray<FlareLogMessage> Overflow;
+		OverflowLock.Lock();
+		Overflow = MoveTemp(OverflowMessages);
+		OverflowMessages.Reset();
+		OverflowCount.Reset();
+		OverflowLock.Unlock();
+
+		for (int32 MessageIndex = 0; MessageIndex < Overflow.Num(); MessageIndex++)
 		{
-			WriteLine(GameLogFile, MessageString);
+			WriteMessage(Overflow[MessageIndex]);
+			MessageCount++;
 		}
-	break;
+	}
+
+	FlushLogFile(GameLogFile);
+	FlushLogFile(CombatLogFile);
+
+	return MessageCount;
+}
+
+void FFlareLogWriter::WriteMessage(const FlareLogMessage& Message)
+{
+	FlareLogFile* File = NULL;
+
+	switch (Message.Target) {
+	case EFlareLogTarget::Game:
+		File = &GameLogFile;
+		break;
 	case EFlareLogTarget::Combat:
-		if (CombatLogFile)
-		{
-			WriteLine(CombatLogFile, MessageString);
-		}
+		File = &CombatLogFile;
 		break;
 
 	default:
 		break;
 	}
+
+	if (!File || !File->Handle)
+	{
+		return;
+	}
+
+	if (File->Binary)
+	{
+		EncodeMessage(*File, Message);
+	}
+	else
+	{
+		FString MessageString = FormatMessage(Message);
+		FTCHARToUTF8 MessageData(*MessageString);
+		File->Buffer.Append((const uint8*) MessageData.Get(), MessageData.Length());
+	}
+
+	if (File->Buffer.Num() > FLARE_LOG_FLUSH_SIZE)
+	{
+		FlushLogFile(*File);
+	}
 }
 
-FString FFlareLogWriter::FormatMessage(FlareLogMessage& Message)
+void FFlareLogWriter::EncodeMessage(FlareLogFile& File, const FlareLogMessage& Message)
 {
+	FMemoryWriter Writer(File.Buffer, false, true);
+
+	// Name identifiers, NAME_None is written as INDEX_NONE
+	int32 NameIds[FLARE_LOG_MAX_PARAMS];
+	for (int32 ParamIndex = 0; ParamIndex < Message.ParamCount; ParamIndex++)
+	{
+		const FlareLogMessageParam& Param = Message.Params[ParamIndex];
+		NameIds[ParamIndex] = INDEX_NONE;
+
+		if (Param.Type != EFlareLogParam::String || Param.StringValue == NAME_None)
+		{
+			continue;
+		}
+
+		int32* ExistingId = File.NameIds.Find(Param.StringValue);
+		if (ExistingId)
+		{
+			NameIds[ParamIndex] = *ExistingId;
+			continue;
+		}
 
+		// New name : define it before use
+		int32 NameId = File.NameIds.Num();
+		File.NameIds.Add(Param.StringValue, NameId);
+		NameIds[ParamIndex] = NameId;
+
+		FTCHARToUTF8 NameData(*Param.StringValue.ToString());
+		int32 NameLength = NameData.Length();
+		uint8 Kind = FLARE_LOG_BINARY_NAME;
+		Writer << Kind;
+		Writer << NameId;
+		Writer << NameLength;
+		Writer.Serialize((void*) NameData.Get(), NameLength);
+	}
+
+	// Message
+	uint8 Kind = FLARE_LOG_BINARY_MESSAGE;
+	int64 Date = Message.Date;
+	uint8 Event = Message.Event;
+	uint8 ParamCount = Message.ParamCount;
+	Writer << Kind;
+	Writer << Date;
+	Writer << Event;
+	Writer << ParamCount;
+
+	for (int32 ParamIndex = 0; ParamIndex < Message.ParamCount; ParamIndex++)
+	{
+		const FlareLogMessageParam& Param = Message.Params[ParamIndex];
+		uint8 Type = Param.Type;
+		Writer << Type;
+
+		switch (Param.Type) {
+		case EFlareLogParam::String:
+			Writer << NameIds[ParamIndex];
+			break;
+		case EFlareLogParam::Integer:
+		{
+			int64 Value = Param.IntValue;
+			Writer << Value;
+			break;
+		}
+		case EFlareLogParam::Float:
+		{
+			double Value = Param.FloatValue;
+			Writer << Value;
+			break;
+		}
+		case EFlareLogParam::Vector3:
+		{
+			FVector Value(Param.Vector3Value[0], Param.Vector3Value[1], Param.Vector3Value[2]);
+			Writer << Value;
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+bool FFlareLogWriter::ConvertBinaryLog(const FString& BinaryFileName, const FString& TextFileName)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *BinaryFileName))
+	{
+		FLOGV("FFlareLogWriter::ConvertBinaryLog : failed to read '%s'", *BinaryFileName);
+		return false;
+	}
+
+	InitEventNames();
+
+	FMemoryReader Reader(Data);
+	TArray<FName> Names;
+	FString Output;
+	int32 MessageCount = 0;
+
+	while (!Reader.AtEnd() && !Reader.IsError())
+	{
+		uint8 Kind;
+		Reader << Kind;
+
+		// Sessions appended to the same file start with a new header
+		if (Kind == (FLARE_LOG_BINARY_MAGIC & 0xFF))
+		{
+			Reader.Seek(Reader.Tell() - 1);
+
+			uint32 Magic;
+			uint32 Version;
+			Reader << Magic;
+			Reader << Version;
+
+			if (Magic != FLARE_LOG_BINARY_MAGIC || Version != FLARE_LOG_BINARY_VERSION)
+			{
+				FLOGV("FFlareLogWriter::ConvertBinaryLog : invalid header in '%s'", *BinaryFileName);
+				return false;
+			}
+
+			Names.Empty();
+		}
+		else if (Kind == FLARE_LOG_BINARY_NAME)
+		{
+			int32 NameId;
+			int32 NameLength;
+			Reader << NameId;
+			Reader << NameLength;
+
+			if (NameId < 0 || NameLength < 0 || Reader.Tell() + NameLength > Reader.TotalSize())
+			{
+				Reader.SetError();
+				break;
+			}
+
+			TArray<ANSICHAR> NameData;
+			NameData.SetNumZeroed(NameLength + 1);
+			Reader.Serialize(NameData.GetData(), NameLength);
+
+			if (Names.Num() <= NameId)
+			{
+				Names.SetNum(NameId + 1);
+			}
+			Names[NameId] = FName(UTF8_TO_TCHAR(NameData.GetData()));
+		}
+		else if (Kind == FLARE_LOG_BINARY_MESSAGE)
+		{
+			FlareLogMessage Message;
+			uint8 Event;
+			uint8 ParamCount;
+			Reader << Message.Date;
+			Reader << Event;
+			Reader << ParamCount;
+
+			if (Event >= EventNames.Num() || ParamCount > FLARE_LOG_MAX_PARAMS)
+			{
+				Reader.SetError();
+				break;
+			}
+
+			Message.Event = (EFlareLogEvent::Type) Event;
+
+			for (int32 ParamIndex = 0; ParamIndex < ParamCount; ParamIndex++)
+			{
+				uint8 Type;
+				Reader << Type;
+
+				switch (Type) {
+				case EFlareLogParam::String:
+				{
+					int32 NameId;
+					Reader << NameId;
+					Message.AddString(Names.IsValidIndex(NameId) ? Names[NameId] : NAME_None);
+					break;
+				}
+				case EFlareLogParam::Integer:
+				{
+					int64 Value;
+					Reader << Value;
+					Message.AddInt(Value);
+					break;
+				}
+				case EFlareLogParam::Float:
+				{
+					double Value;
+					Reader << Value;
+					Message.AddFloat(Value);
+					break;
+				}
+				case EFlareLogParam::Vector3:
+				{
+					FVector Value;
+					Reader << Value;
+					Message.AddVector(Value);
+					break;
+				}
+				default:
+					Reader.SetError();
+					break;
+				}
+			}
+
+			if (!Reader.IsError())
+			{
+				Output += FormatMessage(Message);
+				MessageCount++;
+			}
+		}
+		else
+		{
+			Reader.SetError();
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		FLOGV("FFlareLogWriter::ConvertBinaryLog : '%s' is corrupted after %d messages", *BinaryFileName, MessageCount);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Output, *TextFileName, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		FLOGV("FFlareLogWriter::ConvertBinaryLog : failed to write '%s'", *TextFileName);
+		return false;
+	}
+
+	FLOGV("FFlareLogWriter::ConvertBinaryLog : converted %d messages to '%s'", MessageCount, *TextFileName);
+	return !Reader.IsError();
+}
+
+void FFlareLogWriter::InitEventNames()
+{
+	if (EventNames.Num())
+	{
+		return;
+	}
+
+	for (int32 Event = EFlareLogEvent::GAME_LOADED; Event <= EFlareLogEvent::SPACECRAFT_HARPOONED; Event++)
+	{
+		EventNames.Add(UFlareSaveWriter::FormatEnum<EFlareLogEvent::Type>("EFlareLogEvent", (EFlareLogEvent::Type) Event));
+	}
+}
+
+FString FFlareLogWriter::FormatMessage(const FlareLogMessage& Message)
+{
 	FString MessageString = FString::Printf(
 				TEXT("%s %s"),
-				*Message.Date.ToString(TEXT("%Y-%m-%dT%H:%M:%S.%s")),
-				*UFlareSaveWriter::FormatEnum<EFlareLogEvent::Type>("EFlareLogEvent", Message.Event));
+				*FDateTime(Message.Date).ToString(TEXT("%Y-%m-%dT%H:%M:%S.%s")),
+				EventNames.IsValidIndex(Message.Event) ? *EventNames[Message.Event] : TEXT("Invalid"));
 
-	for(int32 ParamIndex = 0; ParamIndex < Message.Params.Num(); ParamIndex++)
+	for(int32 ParamIndex = 0; ParamIndex < Message.ParamCount; ParamIndex++)
 	{
 		MessageString += "," + FormatParam(&Message.Params[ParamIndex]);
 	}
@@ -202,11 +616,11 @@ FString FFlareLogWriter::FormatMessage(FlareLogMessage& Message)
 	return MessageString;
 }
 
-FString FFlareLogWriter::FormatParam(FlareLogMessageParam* Param)
+FString FFlareLogWriter::FormatParam(const FlareLogMessageParam* Param)
 {
 	switch (Param->Type) {
 	case EFlareLogParam::String:
-		return "\""+Param->StringValue+"\"";
+		return "\""+(Param->StringValue == NAME_None ? FString() : Param->StringValue.ToString())+"\"";
 		break;
 	case EFlareLogParam::Integer:
 		return UFlareSaveWriter::FormatInt64(Param->IntValue);
@@ -215,7 +629,7 @@ FString FFlareLogWriter::FormatParam(FlareLogMessageParam* Param)
 		return  FString::Printf(TEXT("%f"), Param->FloatValue);
 		break;
 	case EFlareLogParam::Vector3:
-		return "("+UFlareSaveWriter::FormatVector(Param->Vector3Value)+")";
+		return "("+UFlareSaveWriter::FormatVector(FVector(Param->Vector3Value[0], Param->Vector3Value[1], Param->Vector3Value[2]))+")";
 		break;
 	default:
 		FLOGV("Invalid log param type %d", (Param->Type + 0));
@@ -226,9 +640,26 @@ FString FFlareLogWriter::FormatParam(FlareLogMessageParam* Param)
 
 void FFlareLogWriter::PushMessage(FlareLogMessage& Message)
 {
-	Message.Date = FDateTime::UtcNow();
-	MessageQueue.Enqueue(Message);
-	NewMessageEvent->Trigger();
+	Message.Date = FDateTime::UtcNow().GetTicks();
+
+	// Once a message overflowed, the next ones follow it until the writer catches up
+	if (OverflowCount.GetValue() > 0 || !MessageQueue.Enqueue(Message))
+	{
+		OverflowLock.Lock();
+		OverflowMessages.Add(Message);
+		OverflowCount.Increment();
+		OverflowLock.Unlock();
+
+		INC_DWORD_STAT(STAT_FlareLogWriter_Overflow);
+		NewMessageEvent->Trigger();
+		return;
+	}
+
+	// Wake the writer early when the queue is filling up
+	if (MessageQueue.Num() > MessageQueue.GetCapacity() / 2)
+	{
+		NewMessageEvent->Trigger();
+	}
 }
 
 void FFlareLogWriter::PushWriterMessage(FlareLogMessage& Message)
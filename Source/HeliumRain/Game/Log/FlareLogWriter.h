@@ -49,21 +49,133 @@ namespace EFlareLogParam
 	};
 }
 
+/** Maximum parameter count of a log message */
+#define FLARE_LOG_MAX_PARAMS 8
+
+/** Log message parameter. Strings are interned as names so that messages stay fixed-size */
 struct FlareLogMessageParam
 {
 	EFlareLogParam::Type Type;
-	FString StringValue;
-	int64 IntValue;
-	double FloatValue;
-	FVector Vector3Value;
+	FName StringValue;
+	union
+	{
+		int64 IntValue;
+		double FloatValue;
+		float Vector3Value[3];
+	};
 };
 
+/** Fixed-size log message, queued and written without allocation */
 struct FlareLogMessage
 {
-	FDateTime Date;
+	/** UTC date ticks, set when the message is pushed */
+	int64 Date;
 	EFlareLogTarget::Type Target;
 	EFlareLogEvent::Type Event;
-	TArray<FlareLogMessageParam> Params;
+	int32 ParamCount;
+	FlareLogMessageParam Params[FLARE_LOG_MAX_PARAMS];
+
+	FlareLogMessage()
+		: Date(0)
+		, Target(EFlareLogTarget::Game)
+		, Event(EFlareLogEvent::GAME_LOADED)
+		, ParamCount(0)
+	{}
+
+	FlareLogMessage(EFlareLogTarget::Type MessageTarget, EFlareLogEvent::Type MessageEvent)
+		: Date(0)
+		, Target(MessageTarget)
+		, Event(MessageEvent)
+		, ParamCount(0)
+	{}
+
+	inline FlareLogMessageParam* AddParam(EFlareLogParam::Type Type)
+	{
+		check(ParamCount < FLARE_LOG_MAX_PARAMS);
+		FlareLogMessageParam* Param = &Params[ParamCount++];
+		Param->Type = Type;
+		return Param;
+	}
+
+	inline void AddString(FName Value)
+	{
+		AddParam(EFlareLogParam::String)->StringValue = Value;
+	}
+
+	inline void AddInt(int64 Value)
+	{
+		AddParam(EFlareLogParam::Integer)->IntValue = Value;
+	}
+
+	inline void AddFloat(double Value)
+	{
+		AddParam(EFlareLogParam::Float)->FloatValue = Value;
+	}
+
+	inline void AddVector(FVector Value)
+	{
+		FlareLogMessageParam* Param = AddParam(EFlareLogParam::Vector3);
+		Param->Vector3Value[0] = Value.X;
+		Param->Vector3Value[1] = Value.Y;
+		Param->Vector3Value[2] = Value.Z;
+	}
+};
+
+
+/** Bounded multi-producer single-consumer message queue, without locks nor allocations */
+class FFlareLogQueue
+{
+public:
+
+	/** Capacity must be a power of two */
+	FFlareLogQueue(int32 QueueCapacity);
+	~FFlareLogQueue();
+
+	/** Add a message, return false if the queue is full */
+	bool Enqueue(const FlareLogMessage& Message);
+
+	/** Remove the oldest message, from the consumer thread only */
+	bool Dequeue(FlareLogMessage& Message);
+
+	/** Approximate message count */
+	int32 Num() const;
+
+	inline int32 GetCapacity() const
+	{
+		return Capacity;
+	}
+
+private:
+
+	struct FSlot
+	{
+		volatile int32 Sequence;
+		FlareLogMessage Message;
+	};
+
+	FSlot*                  Slots;
+	int32                   Capacity;
+	volatile int32          EnqueuePosition;
+	int32                   DequeuePosition;
+};
+
+
+/** Log file being written, with its write buffer */
+struct FlareLogFile
+{
+	IFileHandle*            Handle;
+	bool                    Binary;
+
+	/** Data not written yet */
+	TArray<uint8>           Buffer;
+
+	/** Identifiers of the names already written in a binary file */
+	TMap<FName, int32>      NameIds;
+
+	FlareLogFile()
+		: Handle(NULL)
+		, Binary(false)
+	{}
 };
 
 
@@ -84,24 +196,39 @@ class FFlareLogWriter : public FRunnable
 
 	void CloseLogFiles();
 
-	IFileHandle* InitLogFile(FString BaseName);
+	void InitLogFile(FlareLogFile& File, FString BaseName, bool Binary);
+
+	void CloseLogFile(FlareLogFile& File);
+
+	void FlushLogFile(FlareLogFile& File);
 
-	void WriteLine(IFileHandle* FileHandle, FString& Line);
+	/** Write all queued messages, return the count of written messages */
+	int32 WriteMessages();
 
-	void WriteMessage(FlareLogMessage& Message);
+	void WriteMessage(const FlareLogMessage& Message);
 
-	FString FormatMessage(FlareLogMessage& Message);
+	/** Append a message to a binary file buffer, defining its new names first */
+	static void EncodeMessage(FlareLogFile& File, const FlareLogMessage& Message);
 
-	FString FormatParam(FlareLogMessageParam* Param);
+	static FString FormatParam(const FlareLogMessageParam* Param);
+
+	/** Names of the log events, read from the enum once */
+	static void InitEventNames();
 
 private:
-	int32					PrimesFoundCount;
 	FEvent*					NewMessageEvent;
-	TQueue<FlareLogMessage>	MessageQueue;
-	IFileHandle*			GameLogFile;
-	IFileHandle*			CombatLogFile;
+	FFlareLogQueue			MessageQueue;
+	FlareLogFile			GameLogFile;
+	FlareLogFile			CombatLogFile;
 	FName					GameUUID;
 
+	/** Messages that didn't fit in the queue, written after it. Used until the writer empties it to keep the message order */
+	FCriticalSection		OverflowLock;
+	TArray<FlareLogMessage>	OverflowMessages;
+	FThreadSafeCounter		OverflowCount;
+
+	static TArray<FString>	EventNames;
+
 public:
 
 
@@ -113,6 +240,12 @@ public:
 
 	void PushMessage(FlareLogMessage& Message);
 
+	/** Format a message as a text log line */
+	static FString FormatMessage(const FlareLogMessage& Message);
+
+	/** Convert a binary log file to the text log format, return false on failure */
+	static bool ConvertBinaryLog(const FString& BinaryFileName, const FString& TextFileName);
+
 	// Begin FRunnable interface.
 	virtual bool Init();
 	virtual uint32 Run();
@@ -31,9 +31,6 @@ void UFlareSimulatedPlanetarium::Load()
 	Sun.RingsOuterAltitude = 0.;
 	Sun.RotationVelocity = 0;
 	Sun.OrbitDistance = 0;
-	Sun.RelativeLocation = FPreciseVector::ZeroVector;
-	Sun.AbsoluteLocation = FPreciseVector::ZeroVector;
-	Sun.RotationAngle = 0;
 
 	// Nema
 	FFlareCelestialBody Nema;
@@ -87,6 +84,12 @@ void UFlareSimulatedPlanetarium::Load()
 		Nema.Sattelites.Add(Adena);
 	}
 	Sun.Sattelites.Add(Nema);
+
+	// Flatten the tree for snapshots, the tree must not change after this point
+	Snapshot.Bodies.Empty();
+	SnapshotOrbits.Empty();
+	SnapshotValid = false;
+	AddSnapshotBody(&Sun, INDEX_NONE);
 }
 
 
@@ -163,22 +166,25 @@ float UFlareSimulatedPlanetarium::GetLightRatio(FFlareCelestialBody* Body, doubl
 	return 0.5 + FMath::Acos(Body->Radius / (Body->Radius + OrbitDistance)) / PI;
 }
 
-FFlareCelestialBody UFlareSimulatedPlanetarium::GetSnapShot(int64 Time, float SmoothTime)
+const FFlarePlanetariumSnapshot& UFlareSimulatedPlanetarium::GetSnapShot(int64 Time, float SmoothTime)
 {
-	ComputeCelestialBodyLocation(NULL, &Sun, Time, SmoothTime);
-	return Sun;
+	// Orbit phases only change with the integer time, the smooth time is a cheap offset on top of them
+	if (!SnapshotValid || Snapshot.Time != Time)
+	{
+		UpdateSnapshotTime(Time);
+		UpdateSnapshotSmoothTime(SmoothTime);
+	}
+	else if (Snapshot.SmoothTime != SmoothTime)
+	{
+		UpdateSnapshotSmoothTime(SmoothTime);
+	}
+
+	return Snapshot;
 }
 
-FPreciseVector UFlareSimulatedPlanetarium::GetRelativeLocation(FFlareCelestialBody* ParentBody, int64 Time, float SmoothTime, double OrbitDistance, double Mass, double InitialPhase)
+FPreciseVector UFlareSimulatedPlanetarium::GetRelativeLocation(const FFlareCelestialBody* ParentBody, int64 Time, float SmoothTime, double OrbitDistance, double Mass, double InitialPhase)
 {
-	// TODO extract the constant
-	double G = 6.674e-11; // Gravitational constant
-
-	double MassSum = ParentBody->Mass + Mass;
-	double OrbitalVelocity = FPreciseMath::Sqrt(G * ((MassSum) / (1000 * OrbitDistance)));
-
-	double OrbitalCircumference = 2 * PI * 1000 * OrbitDistance;
-	int64 RevolutionTime = (int64) (OrbitalCircumference / OrbitalVelocity);
+	int64 RevolutionTime = GetRevolutionTime(ParentBody, OrbitDistance, Mass);
 
 	double CurrentRevolutionTime = fmod(((double) (Time % RevolutionTime) + SmoothTime), (double) RevolutionTime);
 
@@ -193,23 +199,100 @@ FPreciseVector UFlareSimulatedPlanetarium::GetRelativeLocation(FFlareCelestialBo
 	return RelativeLocation;
 }
 
+int64 UFlareSimulatedPlanetarium::GetRevolutionTime(const FFlareCelestialBody* ParentBody, double OrbitDistance, double Mass)
+{
+	// TODO extract the constant
+	double G = 6.674e-11; // Gravitational constant
 
-void UFlareSimulatedPlanetarium::ComputeCelestialBodyLocation(FFlareCelestialBody* ParentBody, FFlareCelestialBody* Body, int64 Time, float SmoothTime)
+	double MassSum = ParentBody->Mass + Mass;
+	double OrbitalVelocity = FPreciseMath::Sqrt(G * ((MassSum) / (1000 * OrbitDistance)));
+
+	double OrbitalCircumference = 2 * PI * 1000 * OrbitDistance;
+	return (int64) (OrbitalCircumference / OrbitalVelocity);
+}
+
+
+/*----------------------------------------------------
+	Snapshot
+----------------------------------------------------*/
+
+void UFlareSimulatedPlanetarium::AddSnapshotBody(const FFlareCelestialBody* Body, int32 ParentIndex)
 {
-	if (ParentBody)
+	int32 BodyIndex = Snapshot.Bodies.Num();
+
+	FFlareCelestialBodyState BodyState;
+	BodyState.Body = Body;
+	BodyState.ParentIndex = ParentIndex;
+	BodyState.RelativeLocation = FPreciseVector::ZeroVector;
+	BodyState.AbsoluteLocation = FPreciseVector::ZeroVector;
+	BodyState.RotationAngle = 0;
+	Snapshot.Bodies.Add(BodyState);
+
+	FFlareCelestialBodyOrbit Orbit;
+	Orbit.RevolutionTime = 0;
+	Orbit.RotationPeriod = 0;
+	Orbit.BasePhase = 0;
+	Orbit.BaseRotationAngle = 0;
+	if (ParentIndex != INDEX_NONE)
 	{
-		Body->RelativeLocation = GetRelativeLocation(ParentBody, Time, SmoothTime, Body->OrbitDistance, Body->Mass, 0);
-		Body->AbsoluteLocation = ParentBody->AbsoluteLocation + Body->RelativeLocation;
+		Orbit.RevolutionTime = GetRevolutionTime(Snapshot.Bodies[ParentIndex].Body, Body->OrbitDistance, Body->Mass);
 	}
+	if (Body->RotationVelocity != 0)
+	{
+		Orbit.RotationPeriod = 360 / Body->RotationVelocity;
+	}
+	SnapshotOrbits.Add(Orbit);
 
-	int64 RotationPeriod = 360/Body->RotationVelocity;
-
-	Body->RotationAngle = FPreciseMath::UnwindDegrees(Body->RotationVelocity * (Time % RotationPeriod)) + Body->RotationVelocity * SmoothTime;
 	for (int SatteliteIndex = 0; SatteliteIndex < Body->Sattelites.Num(); SatteliteIndex++)
 	{
-		FFlareCelestialBody* CelestialBody = &Body->Sattelites[SatteliteIndex];
-		ComputeCelestialBodyLocation(Body, CelestialBody, Time, SmoothTime);
+		AddSnapshotBody(&Body->Sattelites[SatteliteIndex], BodyIndex);
+	}
+}
+
+void UFlareSimulatedPlanetarium::UpdateSnapshotTime(int64 Time)
+{
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Bodies.Num(); BodyIndex++)
+	{
+		const FFlareCelestialBody* Body = Snapshot.Bodies[BodyIndex].Body;
+		FFlareCelestialBodyOrbit& Orbit = SnapshotOrbits[BodyIndex];
+
+		if (Orbit.RevolutionTime > 0)
+		{
+			Orbit.BasePhase = 360 * (double) (Time % Orbit.RevolutionTime) / (double) Orbit.RevolutionTime;
+		}
+
+		if (Orbit.RotationPeriod != 0)
+		{
+			Orbit.BaseRotationAngle = FPreciseMath::UnwindDegrees(Body->RotationVelocity * (Time % Orbit.RotationPeriod));
+		}
 	}
+
+	Snapshot.Time = Time;
+	SnapshotValid = true;
+}
+
+void UFlareSimulatedPlanetarium::UpdateSnapshotSmoothTime(float SmoothTime)
+{
+	// Parents are always before their sattelites, so their absolute location is already up to date
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Bodies.Num(); BodyIndex++)
+	{
+		FFlareCelestialBodyState& BodyState = Snapshot.Bodies[BodyIndex];
+		const FFlareCelestialBodyOrbit& Orbit = SnapshotOrbits[BodyIndex];
+
+		if (BodyState.ParentIndex != INDEX_NONE && Orbit.RevolutionTime > 0)
+		{
+			double Phase = Orbit.BasePhase + 360 * SmoothTime / (double) Orbit.RevolutionTime;
+
+			BodyState.RelativeLocation = BodyState.Body->OrbitDistance * FPreciseVector(FPreciseMath::Cos(FPreciseMath::DegreesToRadians(Phase)),
+				0,
+				FPreciseMath::Sin(FPreciseMath::DegreesToRadians(Phase)));
+			BodyState.AbsoluteLocation = Snapshot.Bodies[BodyState.ParentIndex].AbsoluteLocation + BodyState.RelativeLocation;
+		}
+
+		BodyState.RotationAngle = Orbit.BaseRotationAngle + BodyState.Body->RotationVelocity * SmoothTime;
+	}
+
+	Snapshot.SmoothTime = SmoothTime;
 }
 
 AFlareGame* UFlareSimulatedPlanetarium::GetGame() const
@@ -204,19 +204,70 @@ struct FFlareCelestialBody
 	/** Sattelites list */
 	TArray<FFlareCelestialBody> Sattelites;
 
-	/*----------------------------------------------------
-		Dynamic parameters
-	----------------------------------------------------*/
+};
+
 
-	/** Current celestial body location relative to its parent celestial body*/
+/** Celestial body state at a given time */
+struct FFlareCelestialBodyState
+{
+	/** Static parameters */
+	const FFlareCelestialBody* Body;
+
+	/** Index of the parent celestial body in the snapshot, INDEX_NONE for the root star */
+	int32 ParentIndex;
+
+	/** Celestial body location relative to its parent celestial body*/
 	FPreciseVector RelativeLocation;
 
-	/** Current celestial body location relative to its the root star*/
+	/** Celestial body location relative to its the root star*/
 	FPreciseVector AbsoluteLocation;
 
-	/** Current celestial body self rotation angle*/
+	/** Celestial body self rotation angle*/
 	double RotationAngle;
+};
 
+
+/** Planetarium state at a given time. Bodies are flattened with the root star first and parents before their sattelites */
+struct FFlarePlanetariumSnapshot
+{
+	/** Integer time of the snapshot */
+	int64 Time;
+
+	/** Interpolation time added to Time */
+	float SmoothTime;
+
+	/** Celestial bodies state */
+	TArray<FFlareCelestialBodyState> Bodies;
+
+	/** Return the index of the celestial body with the given identifier, or INDEX_NONE */
+	int32 FindBodyIndex(FName BodyIdentifier) const
+	{
+		for (int32 BodyIndex = 0; BodyIndex < Bodies.Num(); BodyIndex++)
+		{
+			if (Bodies[BodyIndex].Body->Identifier == BodyIdentifier)
+			{
+				return BodyIndex;
+			}
+		}
+		return INDEX_NONE;
+	}
+};
+
+
+/** Orbital constants of a celestial body, and its orbit state at the snapshot integer time */
+struct FFlareCelestialBodyOrbit
+{
+	/** Revolution time around the parent, in seconds. 0 for the root star */
+	int64 RevolutionTime;
+
+	/** Self rotation period, in seconds. 0 if the body doesn't rotate */
+	int64 RotationPeriod;
+
+	/** Orbit phase at the snapshot integer time, in degrees */
+	double BasePhase;
+
+	/** Self rotation angle at the snapshot integer time, in degrees */
+	double BaseRotationAngle;
 };
 
 
@@ -231,11 +282,14 @@ public:
 	virtual void Load();
 
 
-	/** Load the planetarium */
-	virtual FFlareCelestialBody GetSnapShot(int64 Time, float SmoothTime);
+	/** Get the planetarium state at a given time. The snapshot is shared and stays valid until the next call */
+	virtual const FFlarePlanetariumSnapshot& GetSnapShot(int64 Time, float SmoothTime);
 
 	/** Get relative location of a body orbiting around its parent */
-	virtual FPreciseVector GetRelativeLocation(FFlareCelestialBody* ParentBody, int64 Time, float SmoothTime, double OrbitDistance, double Mass, double InitialPhase);
+	virtual FPreciseVector GetRelativeLocation(const FFlareCelestialBody* ParentBody, int64 Time, float SmoothTime, double OrbitDistance, double Mass, double InitialPhase);
+
+	/** Get the revolution time of a body orbiting around its parent, in seconds */
+	static int64 GetRevolutionTime(const FFlareCelestialBody* ParentBody, double OrbitDistance, double Mass);
 
 	/** Return the celestial body with the given identifier */
 	FFlareCelestialBody* FindCelestialBody(FName BodyIdentifier);
@@ -256,7 +310,14 @@ public:
 
 protected:
 
-	void ComputeCelestialBodyLocation(FFlareCelestialBody* ParentBody, FFlareCelestialBody* Body, int64 time, float SmoothTime);
+	/** Flatten the celestial body tree into the snapshot body list */
+	void AddSnapshotBody(const FFlareCelestialBody* Body, int32 ParentIndex);
+
+	/** Compute the orbit state of every body at an integer time */
+	void UpdateSnapshotTime(int64 Time);
+
+	/** Interpolate the snapshot between its integer time and the next one */
+	void UpdateSnapshotSmoothTime(float SmoothTime);
 
 	/*----------------------------------------------------
 		Protected data
@@ -266,6 +327,15 @@ protected:
 
 	FFlareCelestialBody           Sun;
 
+	/** Shared snapshot, recomputed when the requested time changes */
+	FFlarePlanetariumSnapshot     Snapshot;
+
+	/** Orbital constants, in snapshot body order */
+	TArray<FFlareCelestialBodyOrbit> SnapshotOrbits;
+
+	/** Snapshot integer time is valid */
+	bool                          SnapshotValid;
+
 public:
 
 	/*----------------------------------------------------
@@ -0,0 +1,409 @@
+#include "../../Flare.h"
+#include "FlareSaveBinary.h"
+
+
+/** "FLSB" */
+#define FLARE_SAVE_BINARY_MAGIC 0x42534C46
+
+#define FLARE_SAVE_BINARY_HEADER_SIZE 16
+
+#define FLARE_SAVE_BINARY_COMPRESSED 1
+
+#define FLARE_SAVE_BINARY_MAX_DEPTH 64
+
+/** zlib can't inflate data more than this, a bigger payload size is corrupted */
+#define FLARE_SAVE_BINARY_MAX_COMPRESSION_RATIO 1032
+
+/** Value tags */
+namespace EFlareSaveBinaryTag
+{
+	enum Type
+	{
+		Null,
+		False,
+		True,
+		Integer,
+		Number,
+		String,
+		Array,
+		Object
+	};
+}
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+UFlareSaveBinary::UFlareSaveBinary(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+
+/*----------------------------------------------------
+	Interface
+----------------------------------------------------*/
+
+bool UFlareSaveBinary::WriteSave(TSharedRef<FJsonObject> Object, TArray<uint8>& Data, bool Compress)
+{
+	// Encode the tree
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+	WrittenStrings.Empty();
+	WriteObject(PayloadWriter, Object);
+	WrittenStrings.Empty();
+
+	uint32 Magic = FLARE_SAVE_BINARY_MAGIC;
+	uint32 Version = FLARE_SAVE_BINARY_VERSION;
+	uint32 Flags = 0;
+	int32 PayloadSize = Payload.Num();
+
+	// Compress
+	TArray<uint8> CompressedPayload;
+	if (Compress)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(COMPRESS_ZLIB, PayloadSize);
+		CompressedPayload.SetNumUninitialized(CompressedSize);
+
+		if (FCompression::CompressMemory(COMPRESS_ZLIB, CompressedPayload.GetData(), CompressedSize, Payload.GetData(), PayloadSize))
+		{
+			CompressedPayload.SetNum(CompressedSize);
+			Flags |= FLARE_SAVE_BINARY_COMPRESSED;
+		}
+		else
+		{
+			FLOG("UFlareSaveBinary::WriteSave : compression failed, saving uncompressed");
+		}
+	}
+
+	// Write the file content
+	Data.Empty();
+	FMemoryWriter Writer(Data);
+	Writer << Magic;
+	Writer << Version;
+	Writer << Flags;
+	Writer << PayloadSize;
+
+	if (Flags & FLARE_SAVE_BINARY_COMPRESSED)
+	{
+		Writer.Serialize(CompressedPayload.GetData(), CompressedPayload.Num());
+	}
+	else
+	{
+		Writer.Serialize(Payload.GetData(), Payload.Num());
+	}
+
+	return !Writer.IsError();
+}
+
+TSharedPtr<FJsonObject> UFlareSaveBinary::ReadSave(const TArray<uint8>& Data)
+{
+	if (!IsBinarySave(Data))
+	{
+		FLOG("UFlareSaveBinary::ReadSave : not a binary save");
+		return nullptr;
+	}
+
+	// Read header
+	FMemoryReader Reader(Data);
+	uint32 Magic;
+	uint32 Version;
+	uint32 Flags;
+	int32 PayloadSize;
+	Reader << Magic;
+	Reader << Version;
+	Reader << Flags;
+	Reader << PayloadSize;
+
+	if (Version > FLARE_SAVE_BINARY_VERSION)
+	{
+		FLOGV("UFlareSaveBinary::ReadSave : unsupported version %u (%u expected)", Version, FLARE_SAVE_BINARY_VERSION);
+		return nullptr;
+	}
+
+	if (PayloadSize < 0)
+	{
+		FLOG("UFlareSaveBinary::ReadSave : invalid payload size");
+		return nullptr;
+	}
+
+	// Decompress
+	TArray<uint8> Payload;
+	const uint8* StoredPayload = Data.GetData() + FLARE_SAVE_BINARY_HEADER_SIZE;
+	int32 StoredPayloadSize = Data.Num() - FLARE_SAVE_BINARY_HEADER_SIZE;
+
+	if (Flags & FLARE_SAVE_BINARY_COMPRESSED)
+	{
+		// Check the size read from the header before allocating
+		if (StoredPayloadSize <= 0 || (int64) PayloadSize > (int64) StoredPayloadSize * FLARE_SAVE_BINARY_MAX_COMPRESSION_RATIO)
+		{
+			FLOG("UFlareSaveBinary::ReadSave : truncated payload");
+			return nullptr;
+		}
+
+		Payload.SetNumUninitialized(PayloadSize);
+		if (!FCompression::UncompressMemory(COMPRESS_ZLIB, Payload.GetData(), PayloadSize, StoredPayload, StoredPayloadSize))
+		{
+			FLOG("UFlareSaveBinary::ReadSave : decompression failed");
+			return nullptr;
+		}
+	}
+	else if (StoredPayloadSize == PayloadSize)
+	{
+		Payload.Append(StoredPayload, StoredPayloadSize);
+	}
+	else
+	{
+		FLOG("UFlareSaveBinary::ReadSave : truncated payload");
+		return nullptr;
+	}
+
+	// Decode the tree
+	FMemoryReader PayloadReader(Payload);
+	ReadStrings.Empty();
+	TSharedPtr<FJsonObject> Object = ReadObject(PayloadReader, 0);
+	ReadStrings.Empty();
+
+	if (PayloadReader.IsError())
+	{
+		FLOG("UFlareSaveBinary::ReadSave : corrupted payload");
+		return nullptr;
+	}
+
+	return Object;
+}
+
+bool UFlareSaveBinary::IsBinarySave(const TArray<uint8>& Data)
+{
+	if (Data.Num() < FLARE_SAVE_BINARY_HEADER_SIZE)
+	{
+		return false;
+	}
+
+	uint32 Magic;
+	FMemory::Memcpy(&Magic, Data.GetData(), sizeof(Magic));
+	return INTEL_ORDER32(Magic) == FLARE_SAVE_BINARY_MAGIC;
+}
+
+
+/*----------------------------------------------------
+	Internal
+----------------------------------------------------*/
+
+void UFlareSaveBinary::WriteValue(FArchive& Ar, const TSharedPtr<FJsonValue>& Value)
+{
+	uint8 Tag;
+
+	if (!Value.IsValid())
+	{
+		Tag = EFlareSaveBinaryTag::Null;
+		Ar << Tag;
+		return;
+	}
+
+	switch (Value->Type)
+	{
+		case EJson::Boolean:
+			Tag = Value->AsBool() ? EFlareSaveBinaryTag::True : EFlareSaveBinaryTag::False;
+			Ar << Tag;
+			break;
+
+		case EJson::Number:
+		{
+			double Number = Value->AsNumber();
+
+			// Small integers are zigzag encoded in a packed int
+			if (Number >= MIN_int32 && Number <= MAX_int32 && Number == FMath::FloorToDouble(Number))
+			{
+				int32 Integer = (int32) Number;
+				uint32 Packed = ((uint32) Integer << 1) ^ (uint32) (Integer >> 31);
+				Tag = EFlareSaveBinaryTag::Integer;
+				Ar << Tag;
+				Ar.SerializeIntPacked(Packed);
+			}
+			else
+			{
+				Tag = EFlareSaveBinaryTag::Number;
+				Ar << Tag;
+				Ar << Number;
+			}
+		}
+		break;
+
+		case EJson::String:
+			Tag = EFlareSaveBinaryTag::String;
+			Ar << Tag;
+			WriteString(Ar, Value->AsString());
+			break;
+
+		case EJson::Array:
+		{
+			const TArray< TSharedPtr<FJsonValue> >& Values = Value->AsArray();
+			uint32 Count = Values.Num();
+			Tag = EFlareSaveBinaryTag::Array;
+			Ar << Tag;
+			Ar.SerializeIntPacked(Count);
+
+			for (int32 Index = 0; Index < Values.Num(); Index++)
+			{
+				WriteValue(Ar, Values[Index]);
+			}
+		}
+		break;
+
+		case EJson::Object:
+			Tag = EFlareSaveBinaryTag::Object;
+			Ar << Tag;
+			WriteObject(Ar, Value->AsObject());
+			break;
+
+		default:
+			Tag = EFlareSaveBinaryTag::Null;
+			Ar << Tag;
+			break;
+	}
+}
+
+void UFlareSaveBinary::WriteObject(FArchive& Ar, const TSharedPtr<FJsonObject>& Object)
+{
+	uint32 Count = Object.IsValid() ? Object->Values.Num() : 0;
+	Ar.SerializeIntPacked(Count);
+
+	if (Object.IsValid())
+	{
+		for (auto& Field : Object->Values)
+		{
+			WriteString(Ar, Field.Key);
+			WriteValue(Ar, Field.Value);
+		}
+	}
+}
+
+void UFlareSaveBinary::WriteString(FArchive& Ar, const FString& String)
+{
+	// Known strings are written as their table index, new ones are appended to the table
+	uint32* KnownIndex = WrittenStrings.Find(String);
+	if (KnownIndex)
+	{
+		Ar.SerializeIntPacked(*KnownIndex);
+	}
+	else
+	{
+		uint32 NewIndex = WrittenStrings.Num();
+		WrittenStrings.Add(String, NewIndex);
+		Ar.SerializeIntPacked(NewIndex);
+
+		FString Value = String;
+		Ar << Value;
+	}
+}
+
+TSharedPtr<FJsonValue> UFlareSaveBinary::ReadValue(FArchive& Ar, int32 Depth)
+{
+	uint8 Tag = EFlareSaveBinaryTag::Null;
+	Ar << Tag;
+
+	if (Ar.IsError() || Depth > FLARE_SAVE_BINARY_MAX_DEPTH)
+	{
+		Ar.SetError();
+		return nullptr;
+	}
+
+	switch (Tag)
+	{
+		case EFlareSaveBinaryTag::Null:
+			return MakeShareable(new FJsonValueNull());
+
+		case EFlareSaveBinaryTag::False:
+			return MakeShareable(new FJsonValueBoolean(false));
+
+		case EFlareSaveBinaryTag::True:
+			return MakeShareable(new FJsonValueBoolean(true));
+
+		case EFlareSaveBinaryTag::Integer:
+		{
+			uint32 Packed = 0;
+			Ar.SerializeIntPacked(Packed);
+			int32 Integer = (int32) (Packed >> 1) ^ -(int32) (Packed & 1);
+			return MakeShareable(new FJsonValueNumber(Integer));
+		}
+
+		case EFlareSaveBinaryTag::Number:
+		{
+			double Number = 0;
+			Ar << Number;
+			return MakeShareable(new FJsonValueNumber(Number));
+		}
+
+		case EFlareSaveBinaryTag::String:
+		{
+			FString String;
+			ReadString(Ar, String);
+			return MakeShareable(new FJsonValueString(String));
+		}
+
+		case EFlareSaveBinaryTag::Array:
+		{
+			uint32 Count = 0;
+			Ar.SerializeIntPacked(Count);
+
+			TArray< TSharedPtr<FJsonValue> > Values;
+			for (uint32 Index = 0; Index < Count && !Ar.IsError(); Index++)
+			{
+				Values.Add(ReadValue(Ar, Depth + 1));
+			}
+			return MakeShareable(new FJsonValueArray(Values));
+		}
+
+		case EFlareSaveBinaryTag::Object:
+			return MakeShareable(new FJsonValueObject(ReadObject(Ar, Depth + 1)));
+
+		default:
+			FLOGV("UFlareSaveBinary::ReadValue : invalid tag %d", Tag);
+			Ar.SetError();
+			return nullptr;
+	}
+}
+
+TSharedPtr<FJsonObject> UFlareSaveBinary::ReadObject(FArchive& Ar, int32 Depth)
+{
+	TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject());
+
+	uint32 Count = 0;
+	Ar.SerializeIntPacked(Count);
+
+	for (uint32 Index = 0; Index < Count && !Ar.IsError(); Index++)
+	{
+		FString Key;
+		if (!ReadString(Ar, Key))
+		{
+			break;
+		}
+		Object->SetField(Key, ReadValue(Ar, Depth));
+	}
+
+	return Object;
+}
+
+bool UFlareSaveBinary::ReadString(FArchive& Ar, FString& String)
+{
+	uint32 Index = 0;
+	Ar.SerializeIntPacked(Index);
+
+	if (Index < (uint32) ReadStrings.Num())
+	{
+		String = ReadStrings[Index];
+	}
+	else if (Index == (uint32) ReadStrings.Num())
+	{
+		Ar << String;
+		ReadStrings.Add(String);
+	}
+	else
+	{
+		Ar.SetError();
+	}
+
+	return !Ar.IsError();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Object.h"
+#include "FlareSaveBinary.generated.h"
+
+
+/** Binary save format version */
+#define FLARE_SAVE_BINARY_VERSION 1
+
+
+/** Binary encoding of the save json tree, with an optional zlib compression */
+UCLASS()
+class HELIUMRAIN_API UFlareSaveBinary: public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	/*----------------------------------------------------
+	  Interface
+	----------------------------------------------------*/
+
+	/** Encode a save json tree to a binary buffer */
+	bool WriteSave(TSharedRef<FJsonObject> Object, TArray<uint8>& Data, bool Compress);
+
+	/** Decode a binary buffer to a save json tree, return an invalid pointer on failure */
+	TSharedPtr<FJsonObject> ReadSave(const TArray<uint8>& Data);
+
+	/** Check if a file content is a binary save */
+	static bool IsBinarySave(const TArray<uint8>& Data);
+
+
+protected:
+
+	/*----------------------------------------------------
+	  Internal
+	----------------------------------------------------*/
+
+	void WriteValue(FArchive& Ar, const TSharedPtr<FJsonValue>& Value);
+	void WriteObject(FArchive& Ar, const TSharedPtr<FJsonObject>& Object);
+	void WriteString(FArchive& Ar, const FString& String);
+
+	TSharedPtr<FJsonValue> ReadValue(FArchive& Ar, int32 Depth);
+	TSharedPtr<FJsonObject> ReadObject(FArchive& Ar, int32 Depth);
+	bool ReadString(FArchive& Ar, FString& String);
+
+
+	/*----------------------------------------------------
+		Protected data
+	----------------------------------------------------*/
+
+	/** Strings already written, keys and values share the same table */
+	TMap<FString, uint32>                   WrittenStrings;
+
+	/** Strings already read, in table order */
+	TArray<FString>                         ReadStrings;
+
+};
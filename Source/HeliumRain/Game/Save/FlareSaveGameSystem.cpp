@@ -4,7 +4,9 @@
 #include "FlareSaveGameSystem.h"
 #include "FlareSaveWriter.h"
 #include "FlareSaveReaderV1.h"
+#include "FlareSaveBinary.h"
 #include "../FlareGame.h"
+#include "../FlareGameTools.h"
 
 
 /*----------------------------------------------------
@@ -23,7 +25,8 @@ UFlareSaveGameSystem::UFlareSaveGameSystem(const FObjectInitializer& ObjectIniti
 
 bool UFlareSaveGameSystem::DoesSaveGameExist(const FString SaveName)
 {
-	return IFileManager::Get().FileSize(*GetSaveGamePath(SaveName)) >= 0;
+	return IFileManager::Get().FileSize(*GetBinarySaveGamePath(SaveName)) >= 0
+		|| IFileManager::Get().FileSize(*GetSaveGamePath(SaveName)) >= 0;
 }
 
 bool UFlareSaveGameSystem::SaveGame(const FString SaveName, UFlareSaveGame* SaveData)
@@ -31,26 +34,34 @@ bool UFlareSaveGameSystem::SaveGame(const FString SaveName, UFlareSaveGame* Save
 	bool ret = false;
 	SaveLock.Lock();
 	FLOGV("UFlareSaveGameSystem::SaveGame SaveName=%s", *SaveName);
+	double StartTime = FPlatformTime::Seconds();
 
 	UFlareSaveWriter* SaveWriter = NewObject<UFlareSaveWriter>(this, UFlareSaveWriter::StaticClass());
 	TSharedRef<FJsonObject> JsonObject = SaveWriter->SaveGame(SaveData);
 
 	// Save the json object
-	FString FileContents;
-	//TSharedRef< TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>> > JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&FileContents);
-	TSharedRef< TJsonWriter<> > JsonWriter = TJsonWriterFactory<>::Create(&FileContents);
+	bool Binary = UFlareGameTools::BinarySaveGames;
+	FString SavePath = Binary ? GetBinarySaveGamePath(SaveName) : GetSaveGamePath(SaveName);
+	ret = WriteSaveFile(SavePath, JsonObject, Binary, UFlareGameTools::CompressSaveGames);
 
-	if (FJsonSerializer::Serialize(JsonObject, JsonWriter))
+	if (ret)
 	{
-		JsonWriter->Close();
+		if (Binary)
+		{
+			// Keep a backup of the json save, the binary one is loaded first
+			FString JsonSavePath = GetSaveGamePath(SaveName);
+			if (IFileManager::Get().FileSize(*JsonSavePath) >= 0)
+			{
+				IFileManager::Get().Move(*GetBackupSaveGamePath(SaveName), *JsonSavePath, true, true);
+			}
+		}
+		else
+		{
+			// Remove the binary save, it would be loaded instead of this one
+			IFileManager::Get().Delete(*GetBinarySaveGamePath(SaveName), false, false, true);
+		}
 
-		ret = FFileHelper::SaveStringToFile(FileContents, *GetSaveGamePath(SaveName));
-		FLOG("UFlareSaveGameSystem::SaveGame : Save done");
-	}
-	else
-	{
-		FLOGV("Fail to serialize save %s", *SaveName);
-		ret = false;
+		FLOGV("UFlareSaveGameSystem::SaveGame : Save done in %.3fs", FPlatformTime::Seconds() - StartTime);
 	}
 
 	SaveLock.Unlock();
@@ -67,27 +78,21 @@ UFlareSaveGame* UFlareSaveGameSystem::LoadGame(const FString SaveName)
 	FLOGV("UFlareSaveGameSystem::LoadGame SaveName=%s", *SaveName);
 
 	UFlareSaveGame *SaveGame = NULL;
+	double StartTime = FPlatformTime::Seconds();
 
-	// Read the saveto a string
-	FString SaveString;
-	if(FFileHelper::LoadFileToString(SaveString, *GetSaveGamePath(SaveName)))
+	// Prefer the binary save, fallback to the json one
+	FString SavePath = GetBinarySaveGamePath(SaveName);
+	if (IFileManager::Get().FileSize(*SavePath) < 0)
 	{
-		// Deserialize a JSON object from the string
-		TSharedPtr< FJsonObject > Object;
-		TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(SaveString);
-		if(FJsonSerializer::Deserialize(Reader, Object) && Object.IsValid())
-		{
-			UFlareSaveReaderV1* SaveReader = NewObject<UFlareSaveReaderV1>(this, UFlareSaveReaderV1::StaticClass());
-			SaveGame = SaveReader->LoadGame(Object);
-		}
-		else
-		{
-			FLOGV("Fail to deserialize save '%s'", *GetSaveGamePath(SaveName));
-		}
+		SavePath = GetSaveGamePath(SaveName);
 	}
-	else
+
+	TSharedPtr<FJsonObject> Object = ReadSaveFile(SavePath);
+	if (Object.IsValid())
 	{
-		FLOGV("Fail to read save '%s'", *GetSaveGamePath(SaveName));
+		UFlareSaveReaderV1* SaveReader = NewObject<UFlareSaveReaderV1>(this, UFlareSaveReaderV1::StaticClass());
+		SaveGame = SaveReader->LoadGame(Object);
+		FLOGV("UFlareSaveGameSystem::LoadGame : Load done in %.3fs", FPlatformTime::Seconds() - StartTime);
 	}
 
 	return SaveGame;
@@ -95,7 +100,10 @@ UFlareSaveGame* UFlareSaveGameSystem::LoadGame(const FString SaveName)
 
 bool UFlareSaveGameSystem::DeleteGame(const FString SaveName)
 {
-	return IFileManager::Get().Delete(*GetSaveGamePath(SaveName), true);
+	bool Deleted = IFileManager::Get().Delete(*GetBinarySaveGamePath(SaveName), false, false, true);
+	Deleted |= IFileManager::Get().Delete(*GetSaveGamePath(SaveName), false, false, true);
+	IFileManager::Get().Delete(*GetBackupSaveGamePath(SaveName), false, false, true);
+	return Deleted;
 }
 
 
@@ -107,6 +115,119 @@ void UFlareSaveGameSystem::PushSaveData(UFlareSaveGame* SaveData)
 }
 
 
+void UFlareSaveGameSystem::BenchmarkSaveFormats(UFlareSaveGame* SaveData)
+{
+	FLOG("UFlareSaveGameSystem::BenchmarkSaveFormats");
+
+	FString BenchmarkName = "SaveBenchmark";
+	FString FormatNames[] = { "json", "binary", "binary+zlib" };
+	bool FormatBinary[] = { false, true, true };
+	bool FormatCompress[] = { false, false, true };
+
+	// Json tree generation is shared by all formats
+	double StartTime = FPlatformTime::Seconds();
+	UFlareSaveWriter* SaveWriter = NewObject<UFlareSaveWriter>(this, UFlareSaveWriter::StaticClass());
+	TSharedRef<FJsonObject> JsonObject = SaveWriter->SaveGame(SaveData);
+	FLOGV("UFlareSaveGameSystem::BenchmarkSaveFormats : save tree built in %.3fs", FPlatformTime::Seconds() - StartTime);
+
+	for (int32 FormatIndex = 0; FormatIndex < 3; FormatIndex++)
+	{
+		FString SavePath = FormatBinary[FormatIndex] ? GetBinarySaveGamePath(BenchmarkName) : GetSaveGamePath(BenchmarkName);
+
+		// Save
+		StartTime = FPlatformTime::Seconds();
+		bool Saved = WriteSaveFile(SavePath, JsonObject, FormatBinary[FormatIndex], FormatCompress[FormatIndex]);
+		double SaveTime = FPlatformTime::Seconds() - StartTime;
+		int64 SaveSize = IFileManager::Get().FileSize(*SavePath);
+
+		// Load
+		StartTime = FPlatformTime::Seconds();
+		TSharedPtr<FJsonObject> Object = ReadSaveFile(SavePath);
+		double ReadTime = FPlatformTime::Seconds() - StartTime;
+		UFlareSaveReaderV1* SaveReader = NewObject<UFlareSaveReaderV1>(this, UFlareSaveReaderV1::StaticClass());
+		bool Loaded = Object.IsValid() && SaveReader->LoadGame(Object) != NULL;
+		double LoadTime = FPlatformTime::Seconds() - StartTime;
+
+		FLOGV("UFlareSaveGameSystem::BenchmarkSaveFormats : %s : size %lld bytes, save %.3fs, read %.3fs, load %.3fs%s",
+			*FormatNames[FormatIndex], SaveSize, SaveTime, ReadTime, LoadTime,
+			(Saved && Loaded) ? TEXT("") : TEXT(" (FAILED)"));
+
+		IFileManager::Get().Delete(*SavePath, false, false, true);
+	}
+}
+
+
+/*----------------------------------------------------
+	Internal
+----------------------------------------------------*/
+
+bool UFlareSaveGameSystem::WriteSaveFile(const FString& Path, TSharedRef<FJsonObject> JsonObject, bool Binary, bool Compress)
+{
+	if (Binary)
+	{
+		UFlareSaveBinary* SaveBinary = NewObject<UFlareSaveBinary>(this, UFlareSaveBinary::StaticClass());
+		TArray<uint8> FileContents;
+
+		if (SaveBinary->WriteSave(JsonObject, FileContents, Compress))
+		{
+			return FFileHelper::SaveArrayToFile(FileContents, *Path);
+		}
+
+		FLOGV("Fail to encode save %s", *Path);
+		return false;
+	}
+
+	FString FileContents;
+	//TSharedRef< TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>> > JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&FileContents);
+	TSharedRef< TJsonWriter<> > JsonWriter = TJsonWriterFactory<>::Create(&FileContents);
+
+	if (FJsonSerializer::Serialize(JsonObject, JsonWriter))
+	{
+		JsonWriter->Close();
+		return FFileHelper::SaveStringToFile(FileContents, *Path);
+	}
+
+	FLOGV("Fail to serialize save %s", *Path);
+	return false;
+}
+
+TSharedPtr<FJsonObject> UFlareSaveGameSystem::ReadSaveFile(const FString& Path)
+{
+	TArray<uint8> FileContents;
+	if (!FFileHelper::LoadFileToArray(FileContents, *Path))
+	{
+		FLOGV("Fail to read save '%s'", *Path);
+		return nullptr;
+	}
+
+	// Binary save
+	if (UFlareSaveBinary::IsBinarySave(FileContents))
+	{
+		UFlareSaveBinary* SaveBinary = NewObject<UFlareSaveBinary>(this, UFlareSaveBinary::StaticClass());
+		TSharedPtr<FJsonObject> Object = SaveBinary->ReadSave(FileContents);
+		if (!Object.IsValid())
+		{
+			FLOGV("Fail to decode save '%s'", *Path);
+		}
+		return Object;
+	}
+
+	// Json save
+	FString SaveString;
+	FFileHelper::BufferToString(SaveString, FileContents.GetData(), FileContents.Num());
+
+	TSharedPtr< FJsonObject > Object;
+	TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(SaveString);
+	if (FJsonSerializer::Deserialize(Reader, Object) && Object.IsValid())
+	{
+		return Object;
+	}
+
+	FLOGV("Fail to deserialize save '%s'", *Path);
+	return nullptr;
+}
+
+
 /*----------------------------------------------------
 	Getters
 ----------------------------------------------------*/
@@ -116,3 +237,13 @@ FString UFlareSaveGameSystem::GetSaveGamePath(const FString SaveName)
 {
 	return FString::Printf(TEXT("%s/SaveGames/%s.json"), *FPaths::GameSavedDir(), *SaveName);
 }
+
+FString UFlareSaveGameSystem::GetBinarySaveGamePath(const FString SaveName)
+{
+	return FString::Printf(TEXT("%s/SaveGames/%s.sav"), *FPaths::GameSavedDir(), *SaveName);
+}
+
+FString UFlareSaveGameSystem::GetBackupSaveGamePath(const FString SaveName)
+{
+	return FString::Printf(TEXT("%s/SaveGames/%s.json.bak"), *FPaths::GameSavedDir(), *SaveName);
+}
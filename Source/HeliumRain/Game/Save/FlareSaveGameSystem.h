@@ -31,8 +31,21 @@ public:
 	/* Keep Save data reference for the async save*/
 	virtual void PushSaveData(UFlareSaveGame* SaveData);
 
+	/** Measure save and load time and size of the json and binary formats */
+	virtual void BenchmarkSaveFormats(UFlareSaveGame* SaveData);
+
 protected:
 
+	/*----------------------------------------------------
+		Internal
+	----------------------------------------------------*/
+
+	/** Write a save json tree to a file, in binary or json format */
+	bool WriteSaveFile(const FString& Path, TSharedRef<FJsonObject> JsonObject, bool Binary, bool Compress);
+
+	/** Read a save json tree from a file, detecting its format */
+	TSharedPtr<FJsonObject> ReadSaveFile(const FString& Path);
+
 
 	/*----------------------------------------------------
 		Protected data
@@ -55,4 +68,10 @@ public:
    /** Get the path to save game file for the given name, a platform _may_ be able to simply override this and no other functions above */
    static FString GetSaveGamePath(const FString SaveName);
 
+   /** Get the path to the binary save game file for the given name */
+   static FString GetBinarySaveGamePath(const FString SaveName);
+
+   /** Get the path to the backup of the json save game file, kept when saving in the binary format */
+   static FString GetBackupSaveGamePath(const FString SaveName);
+
 };
@@ -165,6 +165,8 @@ void AFlareHUD::Setup(AFlareMenuManager* NewMenuManager)
 		GEngine->GameViewport->AddViewportWidgetContent(SNew(SWeakWidget).PossiblyNullContent(MouseMenu.ToSharedRef()), 5);
 		GEngine->GameViewport->AddViewportWidgetContent(SNew(SWeakWidget).PossiblyNullContent(ContextMenuContainer.ToSharedRef()), 10);
 	}
+
+	MenuManager->GetGame()->OnDamageStateChanged().AddUObject(this, &AFlareHUD::OnDamageStateChanged);
 }
 
 
@@ -232,6 +234,43 @@ void AFlareHUD::SignalHit(AFlareSpacecraft* HitSpacecraft, EFlareDamage::Type Da
 	PlayerHitTime = 0;
 }
 
+void AFlareHUD::OnDamageStateChanged(UFlareSimulatedSpacecraft* Spacecraft, int32 OldDamageState, int32 NewDamageState)
+{
+	AFlarePlayerController* PC = MenuManager->GetPC();
+
+	// Only the first state of a ship or a destroyed ship is not worth a notification
+	if (!PC || Spacecraft != PC->GetPlayerShip() || OldDamageState == INDEX_NONE || !(NewDamageState & EFlareDamageState::Alive))
+	{
+		return;
+	}
+
+	int32 NewFlags = NewDamageState & ~OldDamageState;
+
+	if (NewFlags & EFlareDamageState::Stranded)
+	{
+		PC->Notify(LOCTEXT("PlayerShipStrandedTitle", "Ship stranded"),
+			LOCTEXT("PlayerShipStrandedInfo", "The ship you are piloting can't exit the sector anymore"),
+			FName("player-ship-stranded"),
+			EFlareNotification::NT_Military);
+	}
+
+	if (NewFlags & EFlareDamageState::Uncontrollable)
+	{
+		PC->Notify(LOCTEXT("PlayerShipUncontrollableTitle", "Ship uncontrollable"),
+			LOCTEXT("PlayerShipUncontrollableInfo", "The ship you are piloting can't move in the local space anymore"),
+			FName("player-ship-uncontrollable"),
+			EFlareNotification::NT_Military);
+	}
+
+	if ((NewFlags & EFlareDamageState::Disarmed) && Spacecraft->IsMilitary())
+	{
+		PC->Notify(LOCTEXT("PlayerShipDisarmedTitle", "Ship disarmed"),
+			LOCTEXT("PlayerShipDisarmedInfo", "The ship you are piloting is unable to fight back"),
+			FName("player-ship-disarmed"),
+			EFlareNotification::NT_Military);
+	}
+}
+
 void AFlareHUD::DrawHUD()
 {
 	Super::DrawHUD();
@@ -1359,19 +1398,24 @@ void AFlareHUD::DrawHUDDesignatorCorner(FVector2D Position, FVector2D ObjectSize
 
 void AFlareHUD::DrawHUDDesignatorStatus(FVector2D Position, float DesignatorIconSize, AFlareSpacecraft* Ship)
 {
-	UFlareSimulatedSpacecraftDamageSystem* DamageSystem = Ship->GetParent()->GetDamageSystem();
+	// Published once per frame, no need to evaluate the subsystems
+	int32 DamageState = Ship->GetParent()->GetDamageSystem()->GetDamageState();
+	if (DamageState == INDEX_NONE)
+	{
+		DamageState = 0;
+	}
 
-	if (DamageSystem->IsStranded())
+	if (DamageState & EFlareDamageState::Stranded)
 	{
 		Position = DrawHUDDesignatorStatusIcon(Position, DesignatorIconSize, HUDPropulsionIcon);
 	}
 
-	if (DamageSystem->IsUncontrollable())
+	if (DamageState & EFlareDamageState::Uncontrollable)
 	{
 		Position = DrawHUDDesignatorStatusIcon(Position, DesignatorIconSize, HUDRCSIcon);
 	}
 
-	if (Ship->GetParent()->IsMilitary() && DamageSystem->IsDisarmed())
+	if (Ship->GetParent()->IsMilitary() && (DamageState & EFlareDamageState::Disarmed))
 	{
 		DrawHUDDesignatorStatusIcon(Position, DesignatorIconSize, HUDWeaponIcon);
 	}
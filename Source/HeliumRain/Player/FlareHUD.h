@@ -60,6 +60,9 @@ public:
 	/** We just hit this spacecraft with a weapon */
 	void SignalHit(AFlareSpacecraft* HitSpacecraft, EFlareDamage::Type DamageType);
 
+	/** A spacecraft was destroyed, disarmed, stranded or became uncontrollable */
+	void OnDamageStateChanged(UFlareSimulatedSpacecraft* Spacecraft, int32 OldDamageState, int32 NewDamageState);
+
 
 	virtual void DrawHUD() override;
 
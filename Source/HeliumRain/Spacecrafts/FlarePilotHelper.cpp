@@ -14,6 +14,7 @@ DECLARE_CYCLE_STAT(TEXT("PilotHelper CheckFriendlyFire"), STAT_PilotHelper_Check
 DECLARE_CYCLE_STAT(TEXT("PilotHelper Anticollision"), STAT_PilotHelper_AnticollisionCorrection, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("PilotHelper Anticollision Avoidance"), STAT_PilotHelper_AnticollisionCorrection_Avoidance, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("PilotHelper GetBestTarget"), STAT_PilotHelper_GetBestTarget, STATGROUP_Flare);
+DECLARE_CYCLE_STAT(TEXT("PilotHelper GetTargetCandidates"), STAT_PilotHelper_GetTargetCandidates, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("PilotHelper GetBestTargetComponent"), STAT_PilotHelper_GetBestTargetComponent, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("PilotHelper CheckRelativeDangerosity"), STAT_PilotHelper_CheckRelativeDangerosity, STATGROUP_Flare);
 
@@ -83,36 +84,44 @@ FVector PilotHelper::AnticollisionCorrection(AFlareSpacecraft* Ship, FVector Ini
 	TArray<TFlareCollisionCandidate> Candidates;
 	TFlareCollisionCandidate Candidate;
 
-	// Select dangerous ships
-	for (auto SpacecraftCandidate : ActiveSector->GetSpacecrafts())
+	// Input data for danger processing
+	FBox ShipBox = Ship->GetComponentsBoundingBox();
+	FVector CurrentVelocity = Ship->GetLinearVelocity() * 100;
+	FVector CurrentLocation = (ShipBox.Max + ShipBox.Min) / 2.0;
+	float CurrentSize = FMath::Max(ShipBox.GetExtent().Size(), 1.0f);
+	float MaxRelevanceDistance = 200 * CurrentSize;
+
+	// Select nearby ships, asteroids and colliders
+	TArray<const FFlareSpatialEntry*> Bodies;
+	ActiveSector->GetSpatialIndex().QuerySphere(CurrentLocation, MaxRelevanceDistance, EFlareSpatialBody::All, Bodies);
+
+	for (const FFlareSpatialEntry* Body : Bodies)
 	{
-		if (SpacecraftCandidate != Ship
-		 && SpacecraftCandidate != SpacecraftToIgnore
-		 && !Ship->GetDockingSystem()->IsGrantedShip(SpacecraftCandidate)
-		 && !Ship->GetDockingSystem()->IsDockedShip(SpacecraftCandidate))
+		if (Body->Type == EFlareSpatialBody::Spacecraft)
+		{
+			AFlareSpacecraft* SpacecraftCandidate = Body->Spacecraft;
+			if (SpacecraftCandidate != Ship
+			 && SpacecraftCandidate != SpacecraftToIgnore
+			 && !Ship->GetDockingSystem()->IsGrantedShip(SpacecraftCandidate)
+			 && !Ship->GetDockingSystem()->IsDockedShip(SpacecraftCandidate))
+			{
+				Candidate.Key = SpacecraftCandidate;
+				Candidate.Value = SpacecraftCandidate->Airframe->GetPhysicsLinearVelocity();
+				Candidates.Add(Candidate);
+			}
+		}
+		else if (Body->Type == EFlareSpatialBody::Asteroid)
 		{
-			Candidate.Key = SpacecraftCandidate;
-			Candidate.Value = SpacecraftCandidate->Airframe->GetPhysicsLinearVelocity();
+			Candidate.Key = Body->Actor;
+			Candidate.Value = Cast<AFlareAsteroid>(Body->Actor)->GetAsteroidComponent()->GetPhysicsLinearVelocity();
+			Candidates.Add(Candidate);
+		}
+		else
+		{
+			Candidate.Key = Body->Actor;
+			Candidate.Value = FVector::ZeroVector;
 			Candidates.Add(Candidate);
 		}
-	}
-
-	// Select dangerous asteroids
-	for (auto AsteroidCandidate : ActiveSector->GetAsteroids())
-	{
-		Candidate.Key = AsteroidCandidate;
-		Candidate.Value = AsteroidCandidate->GetAsteroidComponent()->GetPhysicsLinearVelocity();
-		Candidates.Add(Candidate);
-	}
-
-	// Select dangerous colliders
-	TArray<AActor*> ColliderActorList;
-	UGameplayStatics::GetAllActorsOfClass(Ship->GetWorld(), AFlareCollider::StaticClass(), ColliderActorList);
-	for (auto ColliderCandidate : ColliderActorList)
-	{
-		Candidate.Key = Cast<AFlareCollider>(ColliderCandidate);
-		Candidate.Value = FVector::ZeroVector;
-		Candidates.Add(Candidate);
 	}
 
 	// No candidate found, return
@@ -121,13 +130,6 @@ FVector PilotHelper::AnticollisionCorrection(AFlareSpacecraft* Ship, FVector Ini
 		return InitialVelocity;
 	}
 
-	// Input data for danger processing
-	FBox ShipBox = Ship->GetComponentsBoundingBox();
-	FVector CurrentVelocity = Ship->GetLinearVelocity() * 100;
-	FVector CurrentLocation = (ShipBox.Max + ShipBox.Min) / 2.0;
-	float CurrentSize = FMath::Max(ShipBox.GetExtent().Size(), 1.0f);
-	float MaxRelevanceDistance = 200 * CurrentSize;
-
 	// Output data
 	AActor* MostDangerousCandidateActor = NULL;
 	FVector MostDangerousLocation;
@@ -193,6 +195,12 @@ FVector PilotHelper::AnticollisionCorrection(AFlareSpacecraft* Ship, FVector Ini
 }
 
 AFlareSpacecraft* PilotHelper::GetBestTarget(AFlareSpacecraft* Ship, struct TargetPreferences Preferences)
+{
+	UFlareSector* Sector = Ship->GetGame()->GetActiveSector();
+	return GetBestTarget(Sector->GetPilotSnapshot(), Ship->GetParent()->GetCompany(), Sector->GetSectorLimits(), Preferences);
+}
+
+AFlareSpacecraft* PilotHelper::GetBestTarget(const TArray<FFlarePilotShipState>& Snapshot, const UFlareCompany* ShipCompany, float SectorLimits, const struct TargetPreferences& Preferences)
 {
 	SCOPE_CYCLE_COUNTER(STAT_PilotHelper_GetBestTarget);
 
@@ -201,179 +209,220 @@ AFlareSpacecraft* PilotHelper::GetBestTarget(AFlareSpacecraft* Ship, struct Targ
 
 	//FLOGV("GetBestTarget for %s", *Ship->GetImmatriculation().ToString());
 
-	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Ship->GetGame()->GetActiveSector()->GetSpacecrafts().Num(); SpacecraftIndex++)
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Snapshot.Num(); SpacecraftIndex++)
 	{
-		AFlareSpacecraft* ShipCandidate = Ship->GetGame()->GetActiveSector()->GetSpacecrafts()[SpacecraftIndex];
+		const FFlarePilotShipState& ShipCandidate = Snapshot[SpacecraftIndex];
 
-		if (Preferences.IgnoreList.Contains(ShipCandidate))
+		if (Preferences.IgnoreList.Contains(ShipCandidate.Ship))
 		{
 			continue;
 		}
 
-		if (Ship->GetParent()->GetCompany()->GetWarState(ShipCandidate->GetCompany()) != EFlareHostility::Hostile)
-		{
-			// Ignore not hostile ships
-			continue;
-		}
-
-		if (!ShipCandidate->GetParent()->GetDamageSystem()->IsAlive())
+		float StateScore;
+		float BaseScore;
+		if (!GetTargetBaseScore(ShipCompany, ShipCandidate, SectorLimits, Preferences, StateScore, BaseScore))
 		{
-			// Ignore destroyed ships
 			continue;
 		}
 
-		if (ShipCandidate->GetActorLocation().Size() > ShipCandidate->GetGame()->GetActiveSector()->GetSectorLimits())
-		{
-			// Ignore out limit ships
-			continue;
+		if(ShipCandidate.Ship == Preferences.LastTarget) {
+			StateScore *=  Preferences.LastTargetWeight;
 		}
 
-		float Score;
-		float StateScore;
-		float AttackTargetScore;
-		float DistanceScore;
-		float AlignementScore;
+		float AlignementScore = GetTargetAlignementScore(ShipCandidate.Location, Preferences);
+		float Score = StateScore * (BaseScore + AlignementScore);
 
-		StateScore = Preferences.TargetStateWeight;
+		/*FLOGV("  - %s: %f", *ShipCandidate.Ship->GetImmatriculation().ToString(), Score);
+		FLOGV("        - StateScore=%f", StateScore);
+		FLOGV("        - BaseScore=%f", BaseScore);
+		FLOGV("        - AlignementScore=%f", AlignementScore);*/
 
-		if (ShipCandidate->GetParent()->GetSize() == EFlarePartSize::L)
+		if (Score > 0)
 		{
-			StateScore *= Preferences.IsLarge;
+			if (BestTarget == NULL || Score > BestScore)
+			{
+				BestTarget = ShipCandidate.Ship;
+				BestScore = Score;
+			}
 		}
+	}
 
-		if (ShipCandidate->GetParent()->GetSize() == EFlarePartSize::S)
-		{
-			StateScore *= Preferences.IsSmall;
-		}
+	/*if(BestTarget)
+	{
+		FLOGV(" -> BestTarget %s with %f", *BestTarget->GetImmatriculation().ToString(), BestScore);
+	}
+	else
+	{
+		FLOG(" -> No target");
+	}*/
 
-		if (ShipCandidate->GetParent()->IsStation())
-		{
-			StateScore *= Preferences.IsStation;
-		}
-		else
-		{
-			StateScore *= Preferences.IsNotStation;
-		}
+	return BestTarget;
+}
 
-		if (ShipCandidate->GetParent()->IsMilitary())
-		{
-			StateScore *= Preferences.IsMilitary;
-		}
-		else
-		{
-			StateScore *= Preferences.IsNotMilitary;
-		}
+void PilotHelper::GetTargetCandidates(AFlareSpacecraft* Ship, const struct TargetPreferences& Preferences, TArray<TargetCandidate>& Candidates)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PilotHelper_GetTargetCandidates);
 
-		if (IsShipDangerous(ShipCandidate))
-		{
-			StateScore *= Preferences.IsDangerous;
-		}
-		else
-		{
-			StateScore *= Preferences.IsNotDangerous;
-		}
+	UFlareSector* Sector = Ship->GetGame()->GetActiveSector();
+	const TArray<FFlarePilotShipState>& Snapshot = Sector->GetPilotSnapshot();
+	UFlareCompany* ShipCompany = Ship->GetParent()->GetCompany();
 
-		if (ShipCandidate->GetParent()->GetDamageSystem()->IsStranded())
-		{
-			StateScore *= Preferences.IsStranded;
-		}
-		else
-		{
-			StateScore *= Preferences.IsNotStranded;
-		}
+	Candidates.Reset();
 
-		if (ShipCandidate->GetParent()->GetDamageSystem()->IsUncontrollable() && ShipCandidate->GetParent()->GetDamageSystem()->IsDisarmed())
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Snapshot.Num(); SpacecraftIndex++)
+	{
+		TargetCandidate Candidate;
+		if (GetTargetBaseScore(ShipCompany, Snapshot[SpacecraftIndex], Sector->GetSectorLimits(), Preferences, Candidate.StateScore, Candidate.BaseScore))
 		{
-			if (ShipCandidate->IsMilitary())
-			{
-				StateScore *= Preferences.IsUncontrollableMilitary;
-			}
-			else
+			Candidate.Ship = Snapshot[SpacecraftIndex].Ship;
+			Candidate.MaxScore = Candidate.StateScore * (Candidate.BaseScore + FMath::Max(Preferences.AlignementWeight, 0.f));
+			if (Candidate.MaxScore > 0)
 			{
-				StateScore *= Preferences.IsUncontrollableCivil;
+				Candidates.Add(Candidate);
 			}
 		}
-		else
-		{
-			StateScore *= Preferences.IsNotUncontrollable;
-		}
+	}
 
-		if(ShipCandidate->GetParent()->IsHarpooned()) {
-			if(ShipCandidate->GetParent()->GetDamageSystem()->IsUncontrollable())
-			{
-				// Never target harponned uncontrollable ships
-				continue;
-			}
-			StateScore *=  Preferences.IsHarpooned;
-		}
+	// Best possible targets first
+	Candidates.Sort([](const TargetCandidate& A, const TargetCandidate& B)
+	{
+		return A.MaxScore > B.MaxScore;
+	});
+}
 
+bool PilotHelper::GetTargetBaseScore(const UFlareCompany* ShipCompany, const FFlarePilotShipState& ShipCandidate, float SectorLimits, const struct TargetPreferences& Preferences, float& StateScore, float& BaseScore)
+{
+	if (ShipCompany->GetWarState(ShipCandidate.Company) != EFlareHostility::Hostile)
+	{
+		// Ignore not hostile ships
+		return false;
+	}
 
-		if(ShipCandidate == Preferences.LastTarget) {
-			StateScore *=  Preferences.LastTargetWeight;
-		}
+	if (!ShipCandidate.Alive)
+	{
+		// Ignore destroyed ships
+		return false;
+	}
 
-		float Distance = (Preferences.BaseLocation - ShipCandidate->GetActorLocation()).Size();
-		if (Distance >= Preferences.MaxDistance)
-		{
-			DistanceScore = 0.f;
-		}
-		else
-		{
-			DistanceScore = Preferences.DistanceWeight * (1.f - (Distance / Preferences.MaxDistance));
-		}
+	if (ShipCandidate.Location.Size() > SectorLimits)
+	{
+		// Ignore out limit ships
+		return false;
+	}
 
-		if (Preferences.AttackTarget && IsShipDangerous(ShipCandidate) && ShipCandidate->GetPilot()->GetTargetShip() == Preferences.AttackTarget)
-		{
-			AttackTargetScore = Preferences.AttackTargetWeight;
-		}
-		else
-		{
-			AttackTargetScore = 0.0f;
-		}
+	float AttackTargetScore;
+	float DistanceScore;
+
+	StateScore = Preferences.TargetStateWeight;
+
+	if (ShipCandidate.Size == EFlarePartSize::L)
+	{
+		StateScore *= Preferences.IsLarge;
+	}
 
-		FVector Direction = (ShipCandidate->GetActorLocation() - Preferences.BaseLocation).GetUnsafeNormal();
+	if (ShipCandidate.Size == EFlarePartSize::S)
+	{
+		StateScore *= Preferences.IsSmall;
+	}
 
+	if (ShipCandidate.Station)
+	{
+		StateScore *= Preferences.IsStation;
+	}
+	else
+	{
+		StateScore *= Preferences.IsNotStation;
+	}
+
+	if (ShipCandidate.Military)
+	{
+		StateScore *= Preferences.IsMilitary;
+	}
+	else
+	{
+		StateScore *= Preferences.IsNotMilitary;
+	}
+
+	if (ShipCandidate.Dangerous)
+	{
+		StateScore *= Preferences.IsDangerous;
+	}
+	else
+	{
+		StateScore *= Preferences.IsNotDangerous;
+	}
 
-		float Alignement = FVector::DotProduct(Preferences.PreferredDirection, Direction);
+	if (ShipCandidate.Stranded)
+	{
+		StateScore *= Preferences.IsStranded;
+	}
+	else
+	{
+		StateScore *= Preferences.IsNotStranded;
+	}
 
-		if (Alignement > Preferences.MinAlignement)
+	if (ShipCandidate.Uncontrollable && ShipCandidate.Disarmed)
+	{
+		if (ShipCandidate.Military)
 		{
-			AlignementScore = Preferences.AlignementWeight * ((Alignement - Preferences.MinAlignement) / (1 - Preferences.MinAlignement));
+			StateScore *= Preferences.IsUncontrollableMilitary;
 		}
 		else
 		{
-			AlignementScore = 0;
+			StateScore *= Preferences.IsUncontrollableCivil;
 		}
+	}
+	else
+	{
+		StateScore *= Preferences.IsNotUncontrollable;
+	}
 
-		Score = StateScore * (AttackTargetScore + DistanceScore + AlignementScore);
-
-
-		/*FLOGV("  - %s: %f", *ShipCandidate->GetImmatriculation().ToString(), Score);
-		FLOGV("        - StateScore=%f", StateScore);
-		FLOGV("        - AttackTargetScore=%f", AttackTargetScore);
-		FLOGV("        - DistanceScore=%f", DistanceScore);
-		FLOGV("        - AlignementScore=%f", AlignementScore);*/
-
-		if (Score > 0)
+	if(ShipCandidate.Harpooned) {
+		if(ShipCandidate.Uncontrollable)
 		{
-			if (BestTarget == NULL || Score > BestScore)
-			{
-				BestTarget = ShipCandidate;
-				BestScore = Score;
-			}
+			// Never target harponned uncontrollable ships
+			return false;
 		}
+		StateScore *=  Preferences.IsHarpooned;
 	}
 
-	/*if(BestTarget)
+
+	float Distance = (Preferences.BaseLocation - ShipCandidate.Location).Size();
+	if (Distance >= Preferences.MaxDistance)
 	{
-		FLOGV(" -> BestTarget %s with %f", *BestTarget->GetImmatriculation().ToString(), BestScore);
+		DistanceScore = 0.f;
 	}
 	else
 	{
-		FLOG(" -> No target");
-	}*/
+		DistanceScore = Preferences.DistanceWeight * (1.f - (Distance / Preferences.MaxDistance));
+	}
 
-	return BestTarget;
+	if (Preferences.AttackTarget && ShipCandidate.Dangerous && ShipCandidate.PilotTarget == Preferences.AttackTarget)
+	{
+		AttackTargetScore = Preferences.AttackTargetWeight;
+	}
+	else
+	{
+		AttackTargetScore = 0.0f;
+	}
+
+	BaseScore = AttackTargetScore + DistanceScore;
+	return true;
+}
+
+float PilotHelper::GetTargetAlignementScore(FVector CandidateLocation, const struct TargetPreferences& Preferences)
+{
+	FVector Direction = (CandidateLocation - Preferences.BaseLocation).GetUnsafeNormal();
+	float Alignement = FVector::DotProduct(Preferences.PreferredDirection, Direction);
+
+	if (Alignement > Preferences.MinAlignement)
+	{
+		return Preferences.AlignementWeight * ((Alignement - Preferences.MinAlignement) / (1 - Preferences.MinAlignement));
+	}
+	else
+	{
+		return 0;
+	}
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine.h"
+#include "../Game/FlarePilotScheduler.h"
 
 class UFlareCompany;
 class UFlareSector;
@@ -39,6 +40,17 @@ struct PilotHelper
 		TArray<AFlareSpacecraft*> IgnoreList;
 	};
 
+	/** Target scored without the alignement and last target terms, which depend on the shooter */
+	struct TargetCandidate
+	{
+		AFlareSpacecraft* Ship;
+		float StateScore;
+		float BaseScore;
+
+		/** Score with the best possible alignement */
+		float MaxScore;
+	};
+
 	static bool CheckFriendlyFire(UFlareSector* Sector, UFlareCompany* MyCompany, FVector FireBaseLocation, FVector FireBaseVelocity , float AmmoVelocity, FVector FireAxis, float MaxDelay, float AimRadius);
 
 	/** Correct trajectory to avoid incoming ships */
@@ -46,6 +58,18 @@ struct PilotHelper
 
 	static AFlareSpacecraft* GetBestTarget(AFlareSpacecraft* Ship, struct TargetPreferences Preferences);
 
+	/** Get the best target in a pilot snapshot, safe on worker threads */
+	static AFlareSpacecraft* GetBestTarget(const TArray<FFlarePilotShipState>& Snapshot, const UFlareCompany* ShipCompany, float SectorLimits, const struct TargetPreferences& Preferences);
+
+	/** Get all valid targets, sorted by decreasing MaxScore. IgnoreList and LastTarget are not used */
+	static void GetTargetCandidates(AFlareSpacecraft* Ship, const struct TargetPreferences& Preferences, TArray<TargetCandidate>& Candidates);
+
+	/** Compute the shooter independent score terms of a target, return false if it can't be targeted */
+	static bool GetTargetBaseScore(const UFlareCompany* ShipCompany, const FFlarePilotShipState& ShipCandidate, float SectorLimits, const struct TargetPreferences& Preferences, float& StateScore, float& BaseScore);
+
+	/** Compute the alignement score of a target */
+	static float GetTargetAlignementScore(FVector CandidateLocation, const struct TargetPreferences& Preferences);
+
 	static UFlareSpacecraftComponent* GetBestTargetComponent(AFlareSpacecraft* TargetSpacecraft);
 
 	/** Return true if the ship is dangerous */
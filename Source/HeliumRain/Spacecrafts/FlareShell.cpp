@@ -16,10 +16,10 @@ AFlareShell::AFlareShell(const class FObjectInitializer& PCIP) : Super(PCIP)
 	ShellComp = PCIP.CreateDefaultSubobject<USceneComponent>(this, TEXT("Root"));
 	RootComponent = ShellComp;
 
-	// Settings
+	// Settings, shells are moved by the sector
 	FlightEffects = NULL;
-	PrimaryActorTick.bCanEverTick = true;
-	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	ShellActive = false;
+	PrimaryActorTick.bCanEverTick = false;
 }
 
 
@@ -34,6 +34,9 @@ void AFlareShell::Initialize(UFlareWeapon* Weapon, const FFlareSpacecraftCompone
 	ParentWeapon = Weapon;
 	Armed = false;
 	MinEffectiveDistance = 0.f;
+	SecureTime = 0.f;
+	ActiveTime = 0.f;
+	ShellActive = true;
 
 	// Can't exist without description, can't return
 	FCHECK(Description);
@@ -57,28 +60,62 @@ void AFlareShell::Initialize(UFlareWeapon* Weapon, const FFlareSpacecraftCompone
 
 	LastLocation = GetActorLocation();
 
+	// Reuse the flight effects of the previous use of this shell if possible
+	if (FlightEffects && (!TracerShell || FlightEffects->Template != FlightEffectsTemplate))
+	{
+		FlightEffects->DestroyComponent();
+		FlightEffects = NULL;
+	}
+
 	// Spawn the flight effects
 	if (TracerShell)
 	{
-		FlightEffects = UGameplayStatics::SpawnEmitterAttached(
-			FlightEffectsTemplate,
-			RootComponent,
-			NAME_None,
-			FVector(0,0,0),
-			FRotator(0,0,0),
-			EAttachLocation::KeepRelativeOffset,
-			true);
+		if (FlightEffects)
+		{
+			FlightEffects->ActivateSystem(true);
+		}
+		else
+		{
+			FlightEffects = UGameplayStatics::SpawnEmitterAttached(
+				FlightEffectsTemplate,
+				RootComponent,
+				NAME_None,
+				FVector(0,0,0),
+				FRotator(0,0,0),
+				EAttachLocation::KeepRelativeOffset,
+				false);
+		}
 	}
 
-	SetLifeSpan(ShellDescription->WeaponCharacteristics.GunCharacteristics.AmmoRange * 100 / ShellVelocity.Size()); // 10km
-	ParentWeapon->GetSpacecraft()->GetGame()->GetActiveSector()->RegisterShell(this);
+	ShellLifeSpan = ShellDescription->WeaponCharacteristics.GunCharacteristics.AmmoRange * 100 / ShellVelocity.Size(); // 10km
+	ShellRemainingLifeSpan = ShellLifeSpan;
+	Sector = ParentWeapon->GetSpacecraft()->GetGame()->GetActiveSector();
 	PC = ParentWeapon->GetSpacecraft()->GetGame()->GetPC();
 }
 
-void AFlareShell::Tick(float DeltaSeconds)
+void AFlareShell::Deactivate()
 {
-	Super::Tick(DeltaSeconds);
-	
+	ShellActive = false;
+
+	if (FlightEffects)
+	{
+		FlightEffects->DeactivateSystem();
+		FlightEffects->KillParticlesForced();
+	}
+
+	SetActorHiddenInGame(true);
+}
+
+void AFlareShell::TickShell(float DeltaSeconds)
+{
+	// End of life
+	ShellRemainingLifeSpan -= DeltaSeconds;
+	if (ShellRemainingLifeSpan <= 0)
+	{
+		Sector->ReleaseShell(this);
+		return;
+	}
+
 	FVector ActorLocation = GetActorLocation();
 	FVector NextActorLocation = ActorLocation + ShellVelocity * DeltaSeconds;
 	SetActorLocation(NextActorLocation, false);
@@ -89,7 +126,7 @@ void AFlareShell::Tick(float DeltaSeconds)
 	float MinScale = 0.1f;
 	if(PC->GetShipPawn())
 	{
-		float LifeRatio = GetLifeSpan() / InitialLifeSpan;
+		float LifeRatio = ShellRemainingLifeSpan / ShellLifeSpan;
 
 		float LifeRatioScale = 1.f;
 
@@ -140,10 +177,13 @@ void AFlareShell::CheckFuze(FVector ActorLocation, FVector NextActorLocation)
 {
 	FVector Center = (NextActorLocation + ActorLocation) / 2;
 	float NearThresoldSquared = FMath::Square(100000); // 1km
-	UFlareSector* Sector = ParentWeapon->GetSpacecraft()->GetGame()->GetActiveSector();
-	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Sector->GetSpacecrafts().Num(); SpacecraftIndex++)
+	// Only spacecrafts near the shell path are candidates
+	TArray<const FFlareSpatialEntry*> Candidates;
+	Sector->GetSpatialIndex().QuerySegment(ActorLocation, NextActorLocation, FMath::Sqrt(NearThresoldSquared), EFlareSpatialBody::Spacecraft, Candidates);
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num() && ShellActive; CandidateIndex++)
 	{
-		AFlareSpacecraft* ShipCandidate = Sector->GetSpacecrafts()[SpacecraftIndex];
+		AFlareSpacecraft* ShipCandidate = Candidates[CandidateIndex]->Spacecraft;
 
 
 		if (ShipCandidate == ParentWeapon->GetSpacecraft())
@@ -342,7 +382,7 @@ void AFlareShell::OnImpact(const FHitResult& HitResult, const FVector& HitVeloci
 
 	if (DestroyProjectile)
 	{
-		Destroy();
+		Sector->ReleaseShell(this);
 	}
 }
 
@@ -352,7 +392,6 @@ void AFlareShell::DetonateAt(FVector DetonatePoint)
 		UGameplayStatics::SpawnEmitterAtLocation(this,
 			ExplosionEffectTemplate,
 			DetonatePoint);
-		UFlareSector* Sector = ParentWeapon->GetSpacecraft()->GetGame()->GetActiveSector();
 		for (int32 SpacecraftIndex = 0; SpacecraftIndex < Sector->GetSpacecrafts().Num(); SpacecraftIndex++)
 		{
 			AFlareSpacecraft* ShipCandidate = Sector->GetSpacecrafts()[SpacecraftIndex];
@@ -465,7 +504,7 @@ void AFlareShell::DetonateAt(FVector DetonatePoint)
 		}
 
 	}
-	Destroy();
+	Sector->ReleaseShell(this);
 }
 
 float AFlareShell::ApplyDamage(AActor *ActorToDamage, UPrimitiveComponent* HitComponent, FVector ImpactLocation,  FVector ImpactAxis,  FVector ImpactNormal, float ImpactPower, float ImpactRadius, EFlareDamage::Type DamageType)
@@ -603,10 +642,10 @@ void AFlareShell::Destroyed()
 	AFlareGame* Game = Cast<AFlareGame>(GetWorld()->GetAuthGameMode());
 	FCHECK(Game);
 
-	UFlareSector* Sector = Game->GetActiveSector();
-	if (Sector->IsValidLowLevel())
+	UFlareSector* ActiveSector = Game->GetActiveSector();
+	if (ActiveSector->IsValidLowLevel())
 	{
-		Sector->UnregisterShell(this);
+		ActiveSector->UnregisterShell(this);
 	}
 }
 
@@ -3,6 +3,9 @@
 #include "FlareWeapon.h"
 #include "FlareShell.generated.h"
 
+class UFlareSector;
+
+
 UCLASS(Blueprintable, ClassGroup = (Flare, Ship), meta = (BlueprintSpawnableComponent))
 class AFlareShell : public AActor
 {
@@ -19,7 +22,11 @@ public:
 	/** Properties setup */
 	void Initialize(class UFlareWeapon* Weapon, const FFlareSpacecraftComponentDescription* Description, FVector ShootDirection, FVector ParentVelocity, bool Tracer);
 
-	virtual void Tick(float DeltaSeconds) override;
+	/** Move the shell and check impacts, called by the sector for all active shells */
+	void TickShell(float DeltaSeconds);
+
+	/** Stop the shell so that it can be reused by the sector */
+	void Deactivate();
 
 	virtual void SetPause(bool Pause);
 
@@ -90,7 +97,23 @@ protected:
 	float SecureTime;
 	float ActiveTime;
 
+	float ShellLifeSpan;
+	float ShellRemainingLifeSpan;
+	bool ShellActive;
+
 	UFlareWeapon* ParentWeapon;
+	UFlareSector* Sector;
 	AFlarePlayerController* PC;
 
+public:
+
+	/*----------------------------------------------------
+		Getters
+	----------------------------------------------------*/
+
+	inline bool IsShellActive() const
+	{
+		return ShellActive;
+	}
+
 };
@@ -7,6 +7,7 @@
 
 #include "../Game/FlareCompany.h"
 #include "../Game/FlareGame.h"
+#include "../Game/FlareGameTools.h"
 #include "../Game/AI/FlareCompanyAI.h"
 
 #include "../Player/FlarePlayerController.h"
@@ -15,13 +16,13 @@
 #include "../Spacecrafts/FlareRCS.h"
 
 DECLARE_CYCLE_STAT(TEXT("FlareShipPilot Tick"), STAT_FlareShipPilot_Tick, STATGROUP_Flare);
+DECLARE_CYCLE_STAT(TEXT("FlareShipPilot Decisions"), STAT_FlareShipPilot_Decisions, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareShipPilot Military"), STAT_FlareShipPilot_Military, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareShipPilot Cargo"), STAT_FlareShipPilot_Cargo, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareShipPilot Fighter"), STAT_FlareShipPilot_Fighter, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareShipPilot Bomber"), STAT_FlareShipPilot_Bomber, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareShipPilot Idle"), STAT_FlareShipPilot_Idle, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareShipPilot Flagship"), STAT_FlareShipPilot_Flagship, STATGROUP_Flare);
-DECLARE_CYCLE_STAT(TEXT("FlareShipPilot FindBestHostileTarget"), STAT_FlareShipPilot_FindBestHostileTarget, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareShipPilot ExitAvoidance"), STAT_FlareShipPilot_ExitAvoidance, STATGROUP_Flare);
 
 
@@ -34,12 +35,14 @@ UFlareShipPilot::UFlareShipPilot(const class FObjectInitializer& PCIP)
 {
 	ReactionTime = FMath::FRandRange(0.4, 0.7);
 	TimeUntilNextReaction = 0;
+	TimeUntilNextDecision = 0;
 	WaitTime = 0;
 	PilotTargetLocation = FVector::ZeroVector;
 	PilotTargetShip = NULL;
 	LastPilotTargetShip = NULL;
 	PilotTargetStation = NULL;
 	PilotLastTargetStation = NULL;
+	PilotNearestHostileShip = NULL;
 	SelectedWeaponGroupIndex = -1;
 	MaxFollowDistance = 0;
 	LockTarget = false;
@@ -66,7 +69,34 @@ void UFlareShipPilot::TickPilot(float DeltaSeconds)
 	}
 
 	TimeUntilNextReaction -= DeltaSeconds;
+	TimeUntilNextDecision -= DeltaSeconds;
 
+	// Forget destroyed ships without waiting for the next decision
+	if (PilotTargetShip && !PilotTargetShip->GetParent()->GetDamageSystem()->IsAlive())
+	{
+		PilotTargetShip = NULL;
+		TimeUntilNextDecision = 0;
+	}
+	if (PilotNearestHostileShip && !PilotNearestHostileShip->GetParent()->GetDamageSystem()->IsAlive())
+	{
+		PilotNearestHostileShip = NULL;
+	}
+
+	// Decisions are spread over frames by the sector, the control below runs every frame with the last decision
+	if (UFlareGameTools::ParallelPilots)
+	{
+		Ship->GetGame()->GetActiveSector()->UpdatePilotDecisions();
+	}
+	else
+	{
+		FFlarePilotDecision Decision;
+		if (BeginDecision(Decision))
+		{
+			ComputeDecision(Decision);
+			ApplyDecision(Decision);
+			Ship->GetGame()->GetActiveSector()->GetPilotScheduler().EndDecision();
+		}
+	}
 
 	LinearTargetVelocity = FVector::ZeroVector;
 	AngularTargetVelocity = FVector::ZeroVector;
@@ -102,6 +132,74 @@ void UFlareShipPilot::Initialize(const FFlareShipPilotSave* Data, UFlareCompany*
 	Pilot functions
 ----------------------------------------------------*/
 
+bool UFlareShipPilot::BeginDecision(FFlarePilotDecision& Decision)
+{
+	if (TimeUntilNextDecision > 0)
+	{
+		return false;
+	}
+
+	FFlarePilotScheduler& Scheduler = Ship->GetGame()->GetActiveSector()->GetPilotScheduler();
+	if (!Scheduler.RequestDecision(DecisionState, Ship->GetWorld()->GetTimeSeconds()))
+	{
+		return false;
+	}
+	TimeUntilNextDecision = ReactionTime;
+
+	// Target selection, when the ship is free to fight
+	Decision.SelectTarget = Ship->IsMilitary() && !Ship->GetNavigationSystem()->IsDocked() && !Ship->GetNavigationSystem()->IsAutoPilot();
+	if (Decision.SelectTarget)
+	{
+		EFlareCombatGroup::Type CombatGroup;
+
+		if(Ship->GetSize() == EFlarePartSize::L)
+		{
+			CombatGroup = EFlareCombatGroup::Capitals;
+		}
+		else
+		{
+			CombatGroup = EFlareCombatGroup::Fighters;
+		}
+
+		CurrentTactic = Ship->GetCompany()->GetTacticManager()->GetCurrentTacticForShipGroup(CombatGroup);
+		GetTargetPreferences(CurrentTactic, Decision.TargetPreferences);
+	}
+
+	Decision.Target = NULL;
+	Decision.NearestHostileShip = NULL;
+	return true;
+}
+
+void UFlareShipPilot::ComputeDecision(FFlarePilotDecision& Decision) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareShipPilot_Decisions);
+
+	// The snapshot is up to date when decisions are computed, this doesn't modify the sector
+	UFlareSector* Sector = Ship->GetGame()->GetActiveSector();
+
+	if (Decision.SelectTarget)
+	{
+		Decision.Target = PilotHelper::GetBestTarget(Sector->GetPilotSnapshot(), Ship->GetCompany(), Sector->GetSectorLimits(), Decision.TargetPreferences);
+	}
+
+	// Threat detection, used to flee
+	Decision.NearestHostileShip = GetNearestHostileShip(true, EFlarePartSize::S);
+	if (!Decision.NearestHostileShip)
+	{
+		Decision.NearestHostileShip = GetNearestHostileShip(true, EFlarePartSize::L);
+	}
+}
+
+void UFlareShipPilot::ApplyDecision(const FFlarePilotDecision& Decision)
+{
+	if (Decision.SelectTarget)
+	{
+		ApplyTarget(Decision.Target);
+	}
+
+	PilotNearestHostileShip = Decision.NearestHostileShip;
+}
+
 void UFlareShipPilot::MilitaryPilot(float DeltaSeconds)
 {
 	SCOPE_CYCLE_COUNTER(STAT_FlareShipPilot_Military);
@@ -120,20 +218,6 @@ void UFlareShipPilot::MilitaryPilot(float DeltaSeconds)
 		return;
 	}
 
-	EFlareCombatGroup::Type CombatGroup;
-
-	if(Ship->GetSize() == EFlarePartSize::L)
-	{
-		CombatGroup = EFlareCombatGroup::Capitals;
-	}
-	else
-	{
-		CombatGroup = EFlareCombatGroup::Fighters;
-	}
-
-	CurrentTactic = Ship->GetCompany()->GetTacticManager()->GetCurrentTacticForShipGroup(CombatGroup);
-	FindBestHostileTarget(CurrentTactic);
-
 	bool Idle = true;
 
 	TimeUntilNextComponentSwitch-=DeltaSeconds;
@@ -211,11 +295,7 @@ void UFlareShipPilot::CargoPilot(float DeltaSeconds)
 
 	TimeSinceLastDockingAttempt += DeltaSeconds;
 
-	AFlareSpacecraft* PilotAvoidShip = GetNearestHostileShip(true, EFlarePartSize::S);
-	if (!PilotAvoidShip)
-	{
-		PilotAvoidShip = GetNearestHostileShip(true, EFlarePartSize::L);
-	}
+	AFlareSpacecraft* PilotAvoidShip = PilotNearestHostileShip;
 
 	// If enemy near, run away !
 	if (PilotAvoidShip)
@@ -856,11 +936,7 @@ void UFlareShipPilot::IdlePilot(float DeltaSeconds)
 	//UseOrbitalBoost = false;
 
 	// If there is ennemy fly away
-	AFlareSpacecraft* PilotAvoidShip = GetNearestHostileShip(true, EFlarePartSize::S);
-	if (!PilotAvoidShip)
-	{
-		PilotAvoidShip = GetNearestHostileShip(true, EFlarePartSize::L);
-	}
+	AFlareSpacecraft* PilotAvoidShip = PilotNearestHostileShip;
 
 	// If enemy near, run away !
 	if (PilotAvoidShip)
@@ -1052,13 +1128,8 @@ void UFlareShipPilot::FlagShipPilot(float DeltaSeconds)
 
 
 
-void UFlareShipPilot::FindBestHostileTarget(EFlareCombatTactic::Type Tactic)
+void UFlareShipPilot::GetTargetPreferences(EFlareCombatTactic::Type Tactic, PilotHelper::TargetPreferences& TargetPreferences)
 {
-	SCOPE_CYCLE_COUNTER(STAT_FlareShipPilot_FindBestHostileTarget);
-
-	AFlareSpacecraft* TargetCandidate = NULL;
-
-	struct PilotHelper::TargetPreferences TargetPreferences;
 	TargetPreferences.IsLarge = 1;
 	TargetPreferences.IsSmall = 1;
 	TargetPreferences.IsStation = 0;
@@ -1110,9 +1181,10 @@ void UFlareShipPilot::FindBestHostileTarget(EFlareCombatTactic::Type Tactic)
 			TargetPreferences.AttackTargetWeight = 1.0;
 		}
 	}
+}
 
-	TargetCandidate = PilotHelper::GetBestTarget(Ship, TargetPreferences);
-
+void UFlareShipPilot::ApplyTarget(AFlareSpacecraft* TargetCandidate)
+{
 	if (TargetCandidate)
 	{
 		bool NewTarget = false;
@@ -1195,8 +1267,7 @@ FVector UFlareShipPilot::ExitAvoidance(AFlareSpacecraft* TargetShip, FVector Ini
 
 		FVector CurrentVelocityAxis = CurrentVelocity.GetUnsafeNormal();
 
-		// TODO Cache
-		TArray<UActorComponent*> Engines = Ship->GetComponentsByClass(UFlareEngine::StaticClass());
+		const TArray<UFlareEngine*>& Engines = Ship->GetEngines();
 
 
 		FVector Acceleration = Ship->GetNavigationSystem()->GetTotalMaxThrustInAxis(Engines, CurrentVelocityAxis, false) / Ship->GetSpacecraftMass();
@@ -1292,43 +1363,39 @@ AFlareSpacecraft* UFlareShipPilot::GetNearestHostileShip(bool DangerousOnly, EFl
 	// - From another company
 	// - Is the nearest
 
-	FVector PilotLocation = Ship->GetActorLocation();
-	float MinDistanceSquared = -1;
-	AFlareSpacecraft* NearestHostileShip = NULL;
+	// Only read the sector snapshot, this runs on worker threads with parallel pilots
+	UFlareSector* Sector = Ship->GetGame()->GetActiveSector();
+	const TArray<FFlarePilotShipState>& Snapshot = Sector->GetPilotSnapshot();
 
-	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Ship->GetGame()->GetActiveSector()->GetSpacecrafts().Num(); SpacecraftIndex++)
+	const FFlareSpatialEntry* NearestHostileShip = Sector->GetSpatialIndex().FindNearest(Ship->GetActorLocation(), EFlareSpatialBody::Spacecraft, false,
+		[=, &Snapshot](const FFlareSpatialEntry& Entry)
 	{
-		AFlareSpacecraft* ShipCandidate = Ship->GetGame()->GetActiveSector()->GetSpacecrafts()[SpacecraftIndex];
+		const FFlarePilotShipState& ShipCandidate = Snapshot[Entry.Index];
 
-		if (!ShipCandidate->GetParent()->GetDamageSystem()->IsAlive())
+		if (!ShipCandidate.Alive)
 		{
-			continue;
+			return false;
 		}
 
-		if (ShipCandidate->GetSize() != Size)
+		if (ShipCandidate.Size != Size)
 		{
-			continue;
+			return false;
 		}
 
-		if (DangerousOnly && ! PilotHelper::IsShipDangerous(ShipCandidate))
+		if (DangerousOnly && !ShipCandidate.Dangerous)
 		{
-			continue;
+			return false;
 		}
 
-		if (Ship->GetCompany()->GetWarState(ShipCandidate->GetCompany()) != EFlareHostility::Hostile)
+		if (Ship->GetCompany()->GetWarState(ShipCandidate.Company) != EFlareHostility::Hostile)
 		{
-			continue;
+			return false;
 		}
 
-		float DistanceSquared = (PilotLocation - ShipCandidate->GetActorLocation()).SizeSquared();
-		if (NearestHostileShip == NULL || DistanceSquared < MinDistanceSquared)
-		{
-			MinDistanceSquared = DistanceSquared;
-			NearestHostileShip = ShipCandidate;
-		}
+		return true;
+	});
 
-	}
-	return NearestHostileShip;
+	return NearestHostileShip ? NearestHostileShip->Spacecraft : NULL;
 }
 
 AFlareSpacecraft* UFlareShipPilot::GetNearestShip(bool IgnoreDockingShip) const
@@ -1339,44 +1406,37 @@ AFlareSpacecraft* UFlareShipPilot::GetNearestShip(bool IgnoreDockingShip) const
 	// - Is the nearest
 	// - Is not me
 
-	FVector PilotLocation = Ship->GetActorLocation();
-	float MinDistanceSquared = -1;
-	AFlareSpacecraft* NearestShip = NULL;
-
-	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Ship->GetGame()->GetActiveSector()->GetSpacecrafts().Num(); SpacecraftIndex++)
+	const FFlareSpatialEntry* NearestShip = Ship->GetGame()->GetActiveSector()->GetSpatialIndex().FindNearest(Ship->GetActorLocation(), EFlareSpatialBody::Spacecraft, false,
+		[=](const FFlareSpatialEntry& Entry)
 	{
-		AFlareSpacecraft* ShipCandidate = Ship->GetGame()->GetActiveSector()->GetSpacecrafts()[SpacecraftIndex];
+		AFlareSpacecraft* ShipCandidate = Entry.Spacecraft;
 
 		if (ShipCandidate == Ship)
 		{
-			continue;
+			return false;
 		}
 
 		if (IgnoreDockingShip && Ship->GetDockingSystem()->IsGrantedShip(ShipCandidate) && !ShipCandidate->GetParent()->GetDamageSystem()->IsUncontrollable())
 		{
 			// Constrollable ship are not dangerous for collision
-			continue;
+			return false;
 		}
 
 		if (IgnoreDockingShip && Ship->GetDockingSystem()->IsDockedShip(ShipCandidate))
 		{
 			// Docked shipship are not dangerous for collision, even if they are dead or offlline
-			continue;
+			return false;
 		}
 
-		float DistanceSquared = (PilotLocation - ShipCandidate->GetActorLocation()).SizeSquared();
-		if (NearestShip == NULL || DistanceSquared < MinDistanceSquared)
-		{
-			MinDistanceSquared = DistanceSquared;
-			NearestShip = ShipCandidate;
-		}
-	}
-	return NearestShip;
+		return true;
+	});
+
+	return NearestShip ? NearestShip->Spacecraft : NULL;
 }
 
 FVector UFlareShipPilot::GetAngularVelocityToAlignAxis(FVector LocalShipAxis, FVector TargetAxis, FVector TargetAngularVelocity, float DeltaSeconds) const
 {
-	TArray<UActorComponent*> Engines = Ship->GetComponentsByClass(UFlareEngine::StaticClass());
+	const TArray<UFlareEngine*>& Engines = Ship->GetEngines();
 
 	FVector AngularVelocity = Ship->Airframe->GetPhysicsAngularVelocity();
 	FVector WorldShipAxis = Ship->Airframe->GetComponentToWorld().GetRotation().RotateVector(LocalShipAxis);
@@ -2,6 +2,8 @@
 
 #include "FlareSpacecraftTypes.h"
 #include "../Game/FlareGameTypes.h"
+#include "../Game/FlarePilotScheduler.h"
+#include "FlarePilotHelper.h"
 #include "FlareShipPilot.generated.h"
 
 class UFlareCompany;
@@ -9,6 +11,18 @@ class AFlareSpacecraft;
 class UFlareSpacecraftComponent;
 
 
+/** Decision of a ship pilot : tactic, target selection and threat detection */
+struct FFlarePilotDecision
+{
+	/** Target selection is part of this decision */
+	bool                                         SelectTarget;
+	PilotHelper::TargetPreferences               TargetPreferences;
+
+	// Results
+	AFlareSpacecraft*                            Target;
+	AFlareSpacecraft*                            NearestHostileShip;
+};
+
 /** Ship pilot class */
 UCLASS()
 class HELIUMRAIN_API UFlareShipPilot : public UObject
@@ -29,10 +43,20 @@ public:
 	/** Initialize this pilot and register the master ship object */
 	virtual void Initialize(const FFlareShipPilotSave* Data, UFlareCompany* Company, AFlareSpacecraft* OwnerShip);
 
+	/** Start a decision on the game thread, return false if no decision is due or if the scheduler delays it */
+	bool BeginDecision(FFlarePilotDecision& Decision);
+
+	/** Compute a decision from the sector pilot snapshot, safe on worker threads */
+	void ComputeDecision(FFlarePilotDecision& Decision) const;
+
+	/** Apply a decision on the game thread */
+	void ApplyDecision(const FFlarePilotDecision& Decision);
+
 protected:
 	/*----------------------------------------------------
 		Pilot functions
 	----------------------------------------------------*/
+
 	virtual void MilitaryPilot(float DeltaSeconds);
 
 	virtual void CargoPilot(float DeltaSeconds);
@@ -78,7 +102,11 @@ public:
 	 */
 	virtual FVector GetAngularVelocityToAlignAxis(FVector LocalShipAxis, FVector TargetAxis, FVector TargetAngularVelocity, float DeltaSeconds) const;
 
-	virtual void FindBestHostileTarget(EFlareCombatTactic::Type Tactic);
+	/** Fill target preferences for a tactic */
+	virtual void GetTargetPreferences(EFlareCombatTactic::Type Tactic, PilotHelper::TargetPreferences& TargetPreferences);
+
+	/** Switch to a new target, NULL if there is none */
+	virtual void ApplyTarget(AFlareSpacecraft* TargetCandidate);
 
 	void AlignToTargetVelocityWithThrust(float DeltaSeconds);
 
@@ -128,6 +156,8 @@ protected:
 	// Pilot brain TODO save in save
 	float                                        ReactionTime;
 	float                                        TimeUntilNextReaction;
+	float                                        TimeUntilNextDecision;
+	FFlarePilotDecisionState                     DecisionState;
 	FVector                                      PilotTargetLocation;
 	float								         WaitTime;
 
@@ -142,6 +172,8 @@ protected:
 	AFlareSpacecraft*                            PilotLastTargetStation;
 	UPROPERTY()
 	UFlareSpacecraftComponent*			         PilotTargetComponent;
+	UPROPERTY()
+	AFlareSpacecraft*                            PilotNearestHostileShip;
 
 	float                                        AttackAngle;
 	float                                        AttackDistance;
@@ -172,4 +204,10 @@ public:
 	{
 		return PilotTargetShip;
 	}
+
+	/** Time the last decision waited for the scheduler, in seconds */
+	inline float GetDecisionLatency() const
+	{
+		return DecisionState.LastLatency;
+	}
 };
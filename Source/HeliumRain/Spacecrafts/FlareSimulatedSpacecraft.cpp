@@ -201,6 +201,13 @@ bool UFlareSimulatedSpacecraft::CanBeFlown(FText& OutInfo) const
 void UFlareSimulatedSpacecraft::SetCurrentSector(UFlareSimulatedSector* Sector)
 {
 	CurrentSector = Sector;
+	GetCompany()->InvalidateCompanyValue();
+
+	// Let the new sector publish a damage state it never received
+	if (DamageSystem->IsDamageStateDirty())
+	{
+		Sector->SetDamageStateDirty(this);
+	}
 
 	// Mark the sector as visited
 	if (!Sector->IsTravelSector())
@@ -435,6 +442,11 @@ void UFlareSimulatedSpacecraft::SetRepairing(bool Repairing)
 
 void UFlareSimulatedSpacecraft::SetReserve(bool InReserve)
 {
+	if (SpacecraftData.IsReserve != InReserve && CurrentSector)
+	{
+		CurrentSector->InvalidateBattleState();
+	}
+
 	SpacecraftData.IsReserve = InReserve;
 }
 
@@ -67,6 +67,8 @@ AFlareSpacecraft::AFlareSpacecraft(const class FObjectInitializer& PCIP)
 	StateManager = NULL;
 	CurrentTarget = NULL;
 	NavigationSystem = NULL;
+	LightsUpdated = false;
+	LightsPowerOutage = false;
 }
 
 
@@ -77,6 +79,7 @@ AFlareSpacecraft::AFlareSpacecraft(const class FObjectInitializer& PCIP)
 void AFlareSpacecraft::BeginPlay()
 {
 	Super::BeginPlay();
+	UpdateComponentRegistry();
 
 	// Setup asteroid components, if any
 	TArray<UActorComponent*> Components = GetComponentsByClass(UFlareAsteroidComponent::StaticClass());
@@ -134,28 +137,20 @@ void AFlareSpacecraft::Tick(float DeltaSeconds)
 		}
 
 		// Lights
-		TArray<UActorComponent*> LightComponents = GetComponentsByClass(USpotLightComponent::StaticClass());
-		for (int32 ComponentIndex = 0; ComponentIndex < LightComponents.Num(); ComponentIndex++)
-		{
-			USpotLightComponent* Component = Cast<USpotLightComponent>(LightComponents[ComponentIndex]);
-			if (Component)
-			{
-				Component->SetActive(!Parent->GetDamageSystem()->HasPowerOutage());
-			}
-		}
+		UpdateLights();
 
 		// Player ship updates
-		AFlarePlayerController* PC = Cast<AFlarePlayerController>(GetWorld()->GetFirstPlayerController());
+		AFlarePlayerController* PC = GetPC();
 		if (PC)
 		{
 			SCOPE_CYCLE_COUNTER(STAT_FlareSpacecraft_PlayerShip);
 			AFlareSpacecraft* PlayerShip = PC->GetShipPawn();
+			float Distance = GetActorLocation().Size();
+			float Limits = GetGame()->GetActiveSector()->GetSectorLimits();
 			
 			if (this == PlayerShip && !HasExitedSector)
 			{
 				// Warn player if he's going to exit the sector
-				float Distance = GetActorLocation().Size();
-				float Limits = GetGame()->GetActiveSector()->GetSectorLimits();
 				if (Distance < Limits)
 				{
 					float MinDistance = Limits - Distance;
@@ -240,8 +235,6 @@ void AFlareSpacecraft::Tick(float DeltaSeconds)
 			}
 
 			// Make ship bounce lost ships if they are outside 1.5 * limit
-			float Distance = GetActorLocation().Size();
-			float Limits = GetGame()->GetActiveSector()->GetSectorLimits();
 			if (Distance > Limits * 1.5f)
 			{
 				Airframe->SetPhysicsLinearVelocity(- Airframe->GetPhysicsLinearVelocity() / 2.f);
@@ -421,27 +414,17 @@ void AFlareSpacecraft::Destroyed()
 	}
 
 	// Stop lights
-	TArray<UActorComponent*> LightComponents = GetComponentsByClass(USpotLightComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < LightComponents.Num(); ComponentIndex++)
+	for (int32 LightIndex = 0; LightIndex < Lights.Num(); LightIndex++)
 	{
-		USpotLightComponent* Component = Cast<USpotLightComponent>(LightComponents[ComponentIndex]);
-		if (Component)
-		{
-			Component->SetActive(false);
-		}
+		Lights[LightIndex]->SetActive(false);
 	}
 
 	Super::Destroyed();
 
 	// Clear bombs
-	TArray<UActorComponent*> Components = GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	for (int32 WeaponIndex = 0; WeaponIndex < Weapons.Num(); WeaponIndex++)
 	{
-		UFlareWeapon* Weapon = Cast<UFlareWeapon>(Components[ComponentIndex]);
-		if (Weapon)
-		{
-			Weapon->ClearBombs();
-		}
+		Weapons[WeaponIndex]->ClearBombs();
 	}
 
 	CurrentTarget = NULL;
@@ -631,6 +614,9 @@ void AFlareSpacecraft::Load(UFlareSimulatedSpacecraft* ParentSpacecraft)
 		NavigationSystem->BreakDock();
 	}
 
+	// Gather components
+	UpdateComponentRegistry();
+
 	// Initialize damage system
 	DamageSystem = NewObject<UFlareSpacecraftDamageSystem>(this, UFlareSpacecraftDamageSystem::StaticClass());
 	DamageSystem->Initialize(this, &GetData());
@@ -654,10 +640,9 @@ void AFlareSpacecraft::Load(UFlareSimulatedSpacecraft* ParentSpacecraft)
 	UpdateDynamicComponents();
 
 	// Initialize components
-	TArray<UActorComponent*> Components = GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	for (int32 ComponentIndex = 0; ComponentIndex < SpacecraftComponents.Num(); ComponentIndex++)
 	{
-		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
+		UFlareSpacecraftComponent* Component = SpacecraftComponents[ComponentIndex];
 		FFlareSpacecraftComponentSave* ComponentData = NULL;
 
 		// Find component the corresponding component data comparing the slot id
@@ -701,6 +686,9 @@ void AFlareSpacecraft::Load(UFlareSimulatedSpacecraft* ParentSpacecraft)
 		}
 	}
 
+	// Parts created their sub-components (turrets, barrels) while reloading
+	UpdateComponentRegistry();
+
 	// Look for an asteroid component
 	ApplyAsteroidData();
 
@@ -761,11 +749,9 @@ void AFlareSpacecraft::Save()
 	}
 
 	// Save all components datas
-	TArray<UActorComponent*> Components = GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	for (int32 ComponentIndex = 0; ComponentIndex < SpacecraftComponents.Num(); ComponentIndex++)
 	{
-		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
-		Component->Save();
+		SpacecraftComponents[ComponentIndex]->Save();
 	}
 }
 
@@ -886,9 +872,7 @@ UFlareSimulatedSector* AFlareSpacecraft::GetOwnerSector()
 
 void AFlareSpacecraft::UpdateDynamicComponents()
 {
-	TArray<UActorComponent*> DynamicComponents = GetComponentsByClass(UChildActorComponent::StaticClass());
-
-	if(DynamicComponents.Num() == 0)
+	if(ChildActorComponents.Num() == 0)
 	{
 		return;
 	}
@@ -914,14 +898,9 @@ void AFlareSpacecraft::UpdateDynamicComponents()
 		}
 	}
 
-		for (int32 ComponentIndex = 0; ComponentIndex < DynamicComponents.Num(); ComponentIndex++)
+	for (int32 ComponentIndex = 0; ComponentIndex < ChildActorComponents.Num(); ComponentIndex++)
 	{
-		UChildActorComponent* Component = Cast<UChildActorComponent>(DynamicComponents[ComponentIndex]);
-
-		if(!Component)
-		{
-			continue;
-		}
+		UChildActorComponent* Component = ChildActorComponents[ComponentIndex];
 
 		if (CurrentState == NULL)
 		{
@@ -982,10 +961,15 @@ UFlareInternalComponent* AFlareSpacecraft::GetInternalComponentAtLocation(FVecto
 	float MinDistance = 100000; // 1km
 	UFlareInternalComponent* ClosestComponent = NULL;
 
-	TArray<UActorComponent*> Components = GetComponentsByClass(UFlareInternalComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	// Use the component tree of the damage system once it is started
+	if (DamageSystem && DamageSystem->GetComponentTree().IsBuilt())
+	{
+		return Cast<UFlareInternalComponent>(DamageSystem->GetComponentTree().FindNearestInternal(GetRootComponent()->GetComponentTransform(), Location, MinDistance));
+	}
+
+	for (int32 ComponentIndex = 0; ComponentIndex < InternalComponents.Num(); ComponentIndex++)
 	{
-		UFlareInternalComponent* InternalComponent = Cast<UFlareInternalComponent>(Components[ComponentIndex]);
+		UFlareInternalComponent* InternalComponent = InternalComponents[ComponentIndex];
 
 		FVector ComponentLocation;
 		float ComponentSize;
@@ -1002,6 +986,77 @@ UFlareInternalComponent* AFlareSpacecraft::GetInternalComponentAtLocation(FVecto
 }
 
 
+/*----------------------------------------------------
+	Component registry
+----------------------------------------------------*/
+
+void AFlareSpacecraft::UpdateComponentRegistry()
+{
+	SpacecraftComponents.Reset();
+	Engines.Reset();
+	RCSs.Reset();
+	Weapons.Reset();
+	InternalComponents.Reset();
+	Lights.Reset();
+	ChildActorComponents.Reset();
+
+	TArray<UActorComponent*> Components = GetComponentsByClass(UActorComponent::StaticClass());
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	{
+		UActorComponent* Component = Components[ComponentIndex];
+
+		if (UFlareSpacecraftComponent* SpacecraftComponent = Cast<UFlareSpacecraftComponent>(Component))
+		{
+			SpacecraftComponents.Add(SpacecraftComponent);
+
+			if (UFlareEngine* Engine = Cast<UFlareEngine>(Component))
+			{
+				Engines.Add(Engine);
+
+				if (UFlareRCS* RCS = Cast<UFlareRCS>(Component))
+				{
+					RCSs.Add(RCS);
+				}
+			}
+			else if (UFlareWeapon* Weapon = Cast<UFlareWeapon>(Component))
+			{
+				Weapons.Add(Weapon);
+			}
+			else if (UFlareInternalComponent* InternalComponent = Cast<UFlareInternalComponent>(Component))
+			{
+				InternalComponents.Add(InternalComponent);
+			}
+		}
+		else if (USpotLightComponent* Light = Cast<USpotLightComponent>(Component))
+		{
+			Lights.Add(Light);
+		}
+		else if (UChildActorComponent* ChildActorComponent = Cast<UChildActorComponent>(Component))
+		{
+			ChildActorComponents.Add(ChildActorComponent);
+		}
+	}
+
+	LightsUpdated = false;
+}
+
+void AFlareSpacecraft::UpdateLights()
+{
+	bool PowerOutage = Parent->GetDamageSystem()->HasPowerOutage();
+
+	if (!LightsUpdated || PowerOutage != LightsPowerOutage)
+	{
+		for (int32 LightIndex = 0; LightIndex < Lights.Num(); LightIndex++)
+		{
+			Lights[LightIndex]->SetActive(!PowerOutage);
+		}
+
+		LightsUpdated = true;
+		LightsPowerOutage = PowerOutage;
+	}
+}
+
+
 /*----------------------------------------------------
 	Customization
 ----------------------------------------------------*/
@@ -1037,16 +1092,11 @@ void AFlareSpacecraft::UpdateCustomization()
 	}
 
 	// Customize lights
-	TArray<UActorComponent*> LightComponents = GetComponentsByClass(USpotLightComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < LightComponents.Num(); ComponentIndex++)
+	for (int32 LightIndex = 0; LightIndex < Lights.Num(); LightIndex++)
 	{
-		USpotLightComponent* Component = Cast<USpotLightComponent>(LightComponents[ComponentIndex]);
-		if (Component)
-		{
-			FLinearColor LightColor = GetGame()->GetCustomizationCatalog()->GetColor(Company->GetLightColorIndex());
-			LightColor = LightColor.Desaturate(0.5);
-			Component->SetLightColor(LightColor);
-		}
+		FLinearColor LightColor = GetGame()->GetCustomizationCatalog()->GetColor(Company->GetLightColorIndex());
+		LightColor = LightColor.Desaturate(0.5);
+		Lights[LightIndex]->SetLightColor(LightColor);
 	}
 
 	// Customize decal materials
@@ -1133,27 +1183,18 @@ void AFlareSpacecraft::DrawShipName(UCanvas* TargetCanvas, int32 Width, int32 He
 
 void AFlareSpacecraft::OnRepaired()
 {
-	TArray<UActorComponent*> Components = GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	for (int32 ComponentIndex = 0; ComponentIndex < SpacecraftComponents.Num(); ComponentIndex++)
 	{
-		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
-		Component->OnRepaired();
+		SpacecraftComponents[ComponentIndex]->OnRepaired();
 	}
 }
 
 void AFlareSpacecraft::OnRefilled()
 {
 	// Reload and repair
-	TArray<UActorComponent*> Components = GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	for (int32 WeaponIndex = 0; WeaponIndex < Weapons.Num(); WeaponIndex++)
 	{
-		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
-
-		UFlareWeapon* Weapon = Cast<UFlareWeapon>(Components[ComponentIndex]);
-		if (Weapon)
-		{
-			Weapon->OnRefilled();
-		}
+		Weapons[WeaponIndex]->OnRefilled();
 	}
 }
 
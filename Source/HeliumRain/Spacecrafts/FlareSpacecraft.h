@@ -13,6 +13,9 @@
 
 class UFlareShipPilot;
 class AFlareSpacecraft;
+class UFlareEngine;
+class UFlareRCS;
+class UFlareInternalComponent;
 
 /** Target info */
 USTRUCT()
@@ -148,6 +151,17 @@ public:
 	/** Canvas callback for the ship name */
 	UFUNCTION()
 	void DrawShipName(UCanvas* TargetCanvas, int32 Width, int32 Height);
+
+
+	/*----------------------------------------------------
+		Component registry
+	----------------------------------------------------*/
+
+	/** Gather the components of this spacecraft by type */
+	void UpdateComponentRegistry();
+
+	/** Turn lights on or off if the power outage state changed */
+	void UpdateLights();
 	
 
 public:
@@ -296,6 +310,26 @@ protected:
 
 	bool										   InWarningZone;
 
+	// Components by type, gathered at load
+	UPROPERTY()
+	TArray<UFlareSpacecraftComponent*>             SpacecraftComponents;
+	UPROPERTY()
+	TArray<UFlareEngine*>                          Engines;
+	UPROPERTY()
+	TArray<UFlareRCS*>                             RCSs;
+	UPROPERTY()
+	TArray<UFlareWeapon*>                          Weapons;
+	UPROPERTY()
+	TArray<UFlareInternalComponent*>               InternalComponents;
+	UPROPERTY()
+	TArray<USpotLightComponent*>                   Lights;
+	UPROPERTY()
+	TArray<UChildActorComponent*>                  ChildActorComponents;
+
+	// Power outage state of the lights
+	bool                                           LightsUpdated;
+	bool                                           LightsPowerOutage;
+
 	bool                                           AttachedToParentActor;
 
 	// Joystick settings
@@ -392,6 +426,32 @@ public:
 		return RCSDescription;
 	}
 
+	inline const TArray<UFlareSpacecraftComponent*>& GetSpacecraftComponents() const
+	{
+		return SpacecraftComponents;
+	}
+
+	/** All engines, including RCS */
+	inline const TArray<UFlareEngine*>& GetEngines() const
+	{
+		return Engines;
+	}
+
+	inline const TArray<UFlareRCS*>& GetRCSs() const
+	{
+		return RCSs;
+	}
+
+	inline const TArray<UFlareWeapon*>& GetWeapons() const
+	{
+		return Weapons;
+	}
+
+	inline const TArray<UFlareInternalComponent*>& GetInternalComponents() const
+	{
+		return InternalComponents;
+	}
+
 	virtual UFlareSpacecraftComponent* GetCockpit() const
 	{
 		return ShipCockit;
@@ -0,0 +1,221 @@
+
+#include "../Flare.h"
+#include "FlareSpacecraftComponentTree.h"
+#include "FlareSpacecraftComponent.h"
+#include "FlareInternalComponent.h"
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+FFlareSpacecraftComponentTree::FFlareSpacecraftComponentTree()
+	: LeafSize(4)
+{
+}
+
+
+/*----------------------------------------------------
+	Build
+----------------------------------------------------*/
+
+void FFlareSpacecraftComponentTree::Build(const FTransform& SpacecraftTransform, const TArray<UActorComponent*>& Components)
+{
+	Reset();
+
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	{
+		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
+		if (!Component)
+		{
+			continue;
+		}
+
+		float ComponentSize;
+		FVector ComponentLocation;
+		Component->GetBoundingSphere(ComponentLocation, ComponentSize);
+
+		// Turrets rotate around their origin : bound the component around it
+		FVector Origin = Component->GetComponentLocation();
+
+		FItem Item;
+		Item.Component = Component;
+		Item.Index = ComponentIndex;
+		Item.Center = SpacecraftTransform.InverseTransformPosition(Origin);
+		Item.Radius = ComponentSize + (ComponentLocation - Origin).Size();
+		Item.Internal = Component->IsA(UFlareInternalComponent::StaticClass());
+		Items.Add(Item);
+	}
+
+	if (Items.Num())
+	{
+		Nodes.Reserve(2 * Items.Num() / LeafSize + 1);
+		BuildNode(0, Items.Num());
+	}
+}
+
+void FFlareSpacecraftComponentTree::Reset()
+{
+	Items.Reset();
+	Nodes.Reset();
+}
+
+
+/*----------------------------------------------------
+	Queries
+----------------------------------------------------*/
+
+void FFlareSpacecraftComponentTree::QuerySphere(const FTransform& SpacecraftTransform, FVector Location, float Radius, TArray<int32>& Results) const
+{
+	Results.Reset();
+	if (!Nodes.Num())
+	{
+		return;
+	}
+
+	// World distances are at least spacecraft space distances times the smallest scale
+	FVector LocalLocation = SpacecraftTransform.InverseTransformPosition(Location);
+	float Scale = SpacecraftTransform.GetMinimumAxisScale();
+
+	TArray<int32, TInlineAllocator<32>> Stack;
+	Stack.Add(0);
+
+	while (Stack.Num())
+	{
+		const FNode& Node = Nodes[Stack.Pop(false)];
+
+		float NodeDistance = FMath::Sqrt(Node.CenterBounds.ComputeSquaredDistanceToPoint(LocalLocation)) * Scale;
+		if (NodeDistance >= Radius + Node.MaxRadius)
+		{
+			continue;
+		}
+
+		if (Node.Left == INDEX_NONE)
+		{
+			for (int32 ItemIndex = Node.Start; ItemIndex < Node.Start + Node.Count; ItemIndex++)
+			{
+				const FItem& Item = Items[ItemIndex];
+				if ((Item.Center - LocalLocation).Size() * Scale < Radius + Item.Radius)
+				{
+					Results.Add(Item.Index);
+				}
+			}
+		}
+		else
+		{
+			Stack.Add(Node.Left);
+			Stack.Add(Node.Right);
+		}
+	}
+
+	// Keep the component order
+	Results.Sort();
+}
+
+UFlareSpacecraftComponent* FFlareSpacecraftComponentTree::FindNearestInternal(const FTransform& SpacecraftTransform, FVector Location, float MaxDistance) const
+{
+	if (!Nodes.Num())
+	{
+		return NULL;
+	}
+
+	FVector LocalLocation = SpacecraftTransform.InverseTransformPosition(Location);
+	float Scale = SpacecraftTransform.GetMinimumAxisScale();
+
+	const FItem* NearestItem = NULL;
+	float NearestDistance = MaxDistance;
+
+	TArray<int32, TInlineAllocator<32>> Stack;
+	Stack.Add(0);
+
+	while (Stack.Num())
+	{
+		const FNode& Node = Nodes[Stack.Pop(false)];
+
+		// Lowest possible distance to a component surface in this node
+		float NodeDistance = FMath::Sqrt(Node.CenterBounds.ComputeSquaredDistanceToPoint(LocalLocation)) * Scale - Node.MaxRadius;
+		if (!Node.HasInternal || NodeDistance > NearestDistance)
+		{
+			continue;
+		}
+
+		if (Node.Left == INDEX_NONE)
+		{
+			for (int32 ItemIndex = Node.Start; ItemIndex < Node.Start + Node.Count; ItemIndex++)
+			{
+				const FItem& Item = Items[ItemIndex];
+				if (!Item.Internal)
+				{
+					continue;
+				}
+
+				float ComponentSize;
+				FVector ComponentLocation;
+				Item.Component->GetBoundingSphere(ComponentLocation, ComponentSize);
+
+				// Ties go to the first component, like a linear search would
+				float Distance = (ComponentLocation - Location).Size() - ComponentSize;
+				if (Distance < NearestDistance || (NearestItem && Distance == NearestDistance && Item.Index < NearestItem->Index))
+				{
+					NearestItem = &Item;
+					NearestDistance = Distance;
+				}
+			}
+		}
+		else
+		{
+			Stack.Add(Node.Left);
+			Stack.Add(Node.Right);
+		}
+	}
+
+	return (NearestItem ? NearestItem->Component : NULL);
+}
+
+
+/*----------------------------------------------------
+	Internal
+----------------------------------------------------*/
+
+int32 FFlareSpacecraftComponentTree::BuildNode(int32 Start, int32 Count)
+{
+	FNode Node;
+	Node.CenterBounds.Init();
+	Node.MaxRadius = 0;
+	Node.HasInternal = false;
+	Node.Start = Start;
+	Node.Count = Count;
+	Node.Left = INDEX_NONE;
+	Node.Right = INDEX_NONE;
+
+	for (int32 ItemIndex = Start; ItemIndex < Start + Count; ItemIndex++)
+	{
+		const FItem& Item = Items[ItemIndex];
+		Node.CenterBounds += Item.Center;
+		Node.MaxRadius = FMath::Max(Node.MaxRadius, Item.Radius);
+		Node.HasInternal |= Item.Internal;
+	}
+
+	int32 NodeIndex = Nodes.Add(Node);
+
+	if (Count > LeafSize)
+	{
+		// Split the items in two halves along the largest axis
+		FVector Extent = Node.CenterBounds.GetExtent();
+		int32 Axis = (Extent.X >= Extent.Y && Extent.X >= Extent.Z) ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+
+		Sort(Items.GetData() + Start, Count, [Axis](const FItem& A, const FItem& B)
+		{
+			return A.Center[Axis] < B.Center[Axis];
+		});
+
+		int32 LeftCount = Count / 2;
+		int32 Left = BuildNode(Start, LeftCount);
+		int32 Right = BuildNode(Start + LeftCount, Count - LeftCount);
+
+		Nodes[NodeIndex].Left = Left;
+		Nodes[NodeIndex].Right = Right;
+	}
+
+	return NodeIndex;
+}
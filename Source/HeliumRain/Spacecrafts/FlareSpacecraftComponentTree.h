@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Engine.h"
+
+class UFlareSpacecraftComponent;
+
+
+/** Bounding volume hierarchy of the components of a spacecraft, built in spacecraft space */
+class FFlareSpacecraftComponentTree
+{
+public:
+
+	FFlareSpacecraftComponentTree();
+
+	/*----------------------------------------------------
+		Build
+	----------------------------------------------------*/
+
+	/** Build the tree from the components of a spacecraft, indexed as in Components */
+	void Build(const FTransform& SpacecraftTransform, const TArray<UActorComponent*>& Components);
+
+	/** Remove all components */
+	void Reset();
+
+
+	/*----------------------------------------------------
+		Queries
+	----------------------------------------------------*/
+
+	/** Get the index of the components whose bounding sphere may touch a world sphere, sorted by index */
+	void QuerySphere(const FTransform& SpacecraftTransform, FVector Location, float Radius, TArray<int32>& Results) const;
+
+	/** Get the internal component whose bounding sphere is the nearest from a world location, NULL if none is closer than MaxDistance */
+	UFlareSpacecraftComponent* FindNearestInternal(const FTransform& SpacecraftTransform, FVector Location, float MaxDistance) const;
+
+	inline bool IsBuilt() const
+	{
+		return Items.Num() > 0;
+	}
+
+
+protected:
+
+	/*----------------------------------------------------
+		Internal
+	----------------------------------------------------*/
+
+	/** Build a node for Items[Start, Start + Count[, return its index */
+	int32 BuildNode(int32 Start, int32 Count);
+
+
+	/*----------------------------------------------------
+		Data
+	----------------------------------------------------*/
+
+	/** Component in the tree */
+	struct FItem
+	{
+		UFlareSpacecraftComponent* Component;
+
+		/** Index in the component list */
+		int32 Index;
+
+		/** Component origin in spacecraft space */
+		FVector Center;
+
+		/** Bounding sphere radius around the origin in world units, valid for any rotation of the component around its origin */
+		float Radius;
+
+		bool Internal;
+	};
+
+	/** Tree node, a leaf if Left is INDEX_NONE */
+	struct FNode
+	{
+		/** Bounds of the centers of the node items */
+		FBox CenterBounds;
+
+		/** Largest item radius */
+		float MaxRadius;
+
+		/** The node contains internal components */
+		bool HasInternal;
+
+		int32 Start;
+		int32 Count;
+		int32 Left;
+		int32 Right;
+	};
+
+	/** Maximum number of components in a leaf */
+	int32                                LeafSize;
+
+	TArray<FItem>                        Items;
+	TArray<FNode>                        Nodes;
+
+};
@@ -252,21 +252,23 @@ void UFlareTurretPilot::TickPilot(float DeltaSeconds)
 
 void UFlareTurretPilot::ProcessTurretTargetSelection()
 {
+	if(PilotTargetShip && !PilotTargetShip->GetParent()->GetDamageSystem()->IsAlive())
+	{
+		PilotTargetShip = NULL;
+	}
 
 	if (TimeUntilNextTargetSelectionReaction > 0)
 	{
-		if(PilotTargetShip && !PilotTargetShip->GetParent()->GetDamageSystem()->IsAlive())
-		{
-			PilotTargetShip = NULL;
-		}
-
 		return;
 	}
-	else
+
+	// Target selection is spread over frames by the sector
+	FFlarePilotScheduler& Scheduler = Turret->GetSpacecraft()->GetGame()->GetActiveSector()->GetPilotScheduler();
+	if (!Scheduler.RequestDecision(DecisionState, Turret->GetSpacecraft()->GetWorld()->GetTimeSeconds()))
 	{
-		TimeUntilNextTargetSelectionReaction = TargetSelectionReactionTime;
+		return;
 	}
-
+	TimeUntilNextTargetSelectionReaction = TargetSelectionReactionTime;
 
 	AFlareSpacecraft* OldPilotTargetShip = PilotTargetShip;
 
@@ -311,6 +313,8 @@ void UFlareTurretPilot::ProcessTurretTargetSelection()
 	{
 		PilotTargetShip = GetNearestHostileShip(false, Tactic);
 	}
+
+	Scheduler.EndDecision();
 }
 
 AFlareSpacecraft* UFlareTurretPilot::GetNearestHostileShip(bool ReachableOnly, EFlareCombatTactic::Type Tactic) const
@@ -402,34 +406,74 @@ AFlareSpacecraft* UFlareTurretPilot::GetNearestHostileShip(bool ReachableOnly, E
 	}
 
 
-	while (NearestHostileShip == NULL)
-	{
-		NearestHostileShip = PilotHelper::GetBestTarget(Turret->GetSpacecraft(), TargetPreferences);
+	// Candidates are scored once for all the turrets of the ship that share these preferences
+	PilotHelper::TargetPreferences ShipPreferences = TargetPreferences;
+	ShipPreferences.BaseLocation = Turret->GetSpacecraft()->GetActorLocation();
+	int32 PreferenceSet = 2 * Tactic + (Turret->GetDescription()->WeaponCharacteristics.DamageType == EFlareShellDamageType::HEAT ? 1 : 0);
+	const TArray<PilotHelper::TargetCandidate>& Candidates = Turret->GetSpacecraft()->GetWeaponsSystem()->GetTurretTargetCandidates(PreferenceSet, ShipPreferences);
+
+	float NearestHostileShipScore = 0;
+	int32 LastTargetIndex = INDEX_NONE;
 
-		if(NearestHostileShip == NULL)
+	// Apply the turret alignement and safety filters
+	auto EvaluateCandidate = [&](const PilotHelper::TargetCandidate& Candidate, float StateWeight)
+	{
+		float Score = Candidate.StateScore * StateWeight * (Candidate.BaseScore + PilotHelper::GetTargetAlignementScore(Candidate.Ship->GetActorLocation(), TargetPreferences));
+		if (Score <= 0 || (NearestHostileShip && Score <= NearestHostileShipScore))
 		{
-			// No target
-			return NULL;
+			return;
 		}
 
+		// The list can be a bit older than this frame
+		if (!Candidate.Ship->GetParent()->GetDamageSystem()->IsAlive())
+		{
+			return;
+		}
 
-		float Distance = (PilotLocation - NearestHostileShip->GetActorLocation()).Size();
+		float Distance = (PilotLocation - Candidate.Ship->GetActorLocation()).Size();
 		if (Distance < SecurityRadius * 100)
 		{
-			TargetPreferences.IgnoreList.Add(NearestHostileShip);
-			NearestHostileShip = NULL;
-			continue;
+			return;
 		}
 
-		FVector TargetAxis = (NearestHostileShip->GetActorLocation()- PilotLocation).GetUnsafeNormal();
-
+		FVector TargetAxis = (Candidate.Ship->GetActorLocation() - PilotLocation).GetUnsafeNormal();
 		if (ReachableOnly && !Turret->IsReacheableAxis(TargetAxis))
 		{
-			TargetPreferences.IgnoreList.Add(NearestHostileShip);
-			NearestHostileShip = NULL;
-			continue;
+			return;
+		}
+
+		NearestHostileShip = Candidate.Ship;
+		NearestHostileShipScore = Score;
+	};
+
+	// The last target has a score bonus, so it is not ranked like the others
+	if (PilotTargetShip)
+	{
+		for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); CandidateIndex++)
+		{
+			if (Candidates[CandidateIndex].Ship == PilotTargetShip)
+			{
+				LastTargetIndex = CandidateIndex;
+				EvaluateCandidate(Candidates[CandidateIndex], TargetPreferences.LastTargetWeight);
+				break;
+			}
+		}
+	}
+
+	// Candidates are sorted by best possible score, stop when none can beat the current target
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); CandidateIndex++)
+	{
+		if (NearestHostileShip && Candidates[CandidateIndex].MaxScore <= NearestHostileShipScore)
+		{
+			break;
+		}
+
+		if (CandidateIndex != LastTargetIndex)
+		{
+			EvaluateCandidate(Candidates[CandidateIndex], 1.f);
 		}
 	}
+
 	return NearestHostileShip;
 }
 
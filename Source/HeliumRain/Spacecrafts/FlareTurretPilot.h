@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Game/FlareGameTypes.h"
+#include "../Game/FlarePilotScheduler.h"
 #include "FlareTurretPilot.generated.h"
 
 class UFlareTurret;
@@ -91,6 +92,7 @@ protected:
 	float                                TimeUntilNextTargetSelectionReaction;
 	float                                TimeUntilFireReaction;
 	float                                TimeUntilNextComponentSwitch;
+	FFlarePilotDecisionState             DecisionState;
 	AFlareSpacecraft*                    PilotTargetShip;
 	UFlareSpacecraftComponent*			 PilotTargetComponent;
 
@@ -111,4 +113,10 @@ public:
 		return ManualAimDistance;
 	}
 
+	/** Time the last target selection waited for the scheduler, in seconds */
+	inline float GetDecisionLatency() const
+	{
+		return DecisionState.LastLatency;
+	}
+
 };
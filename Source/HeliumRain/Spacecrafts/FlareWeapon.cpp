@@ -5,6 +5,7 @@
 #include "FlareSpacecraft.h"
 #include "FlareShell.h"
 #include "FlareBomb.h"
+#include "../Game/FlareSector.h"
 #include "../Player/FlarePlayerController.h"
 
 DECLARE_CYCLE_STAT(TEXT("FlareWeapon Firing"), STAT_Weapon_Firing, STATGROUP_Flare);
@@ -217,12 +218,8 @@ bool UFlareWeapon::FireGun(int GunIndex)
 	FVector FiringDirection = FMath::VRandCone(FiringAxis, Imprecision);
 	FVector FiringVelocity = GetPhysicsLinearVelocity();
 
-	// Create a shell
-	AFlareShell* Shell = GetWorld()->SpawnActor<AFlareShell>(
-		AFlareShell::StaticClass(),
-		FiringLocation,
-		FRotator::ZeroRotator,
-		ProjectileSpawnParams);
+	// Create a shell, reusing a pooled one if possible
+	AFlareShell* Shell = Spacecraft->GetGame()->GetActiveSector()->AcquireShell(FiringLocation, ProjectileSpawnParams);
 
 	// Fire it. Tracer ammo every bullets
 	Shell->Initialize(this, ComponentDescription, FiringDirection, FiringVelocity, true);
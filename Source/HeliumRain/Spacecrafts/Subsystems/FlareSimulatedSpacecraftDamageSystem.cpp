@@ -4,12 +4,14 @@
 #include "../FlareSimulatedSpacecraft.h"
 #include "../FlareSpacecraftComponent.h"
 #include "../../Game/FlareGame.h"
+#include "../../Game/FlareSimulatedSector.h"
 #include "FlareSimulatedSpacecraftDamageSystem.h"
 
 DECLARE_CYCLE_STAT(TEXT("FlareSimulatedDamageSystem UpdateSubsystemHealth"), STAT_FlareSimulatedDamageSystem_UpdateSubsystemHealth, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareSimulatedDamageSystem GetWeaponGroupHealth"), STAT_FlareSimulatedDamageSystem_GetWeaponGroupHealth, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareSimulatedDamageSystem ApplyDamage"), STAT_FlareSimulatedDamageSystem_ApplyDamage, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareSimulatedDamageSystem IsPowered"), STAT_FlareSimulatedDamageSystem_IsPowered, STATGROUP_Flare);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FlareSimulatedDamageSystem Damage state changes"), STAT_FlareSimulatedDamageSystem_DamageStateChanges, STATGROUP_Flare);
 
 #define LOCTEXT_NAMESPACE "FlareSimulatedSpacecraftDamageSystem"
 
@@ -36,6 +38,8 @@ void UFlareSimulatedSpacecraftDamageSystem::Initialize(UFlareSimulatedSpacecraft
 	Data = OwnerData;
 	DamageDirty = true;
 	AmmoDirty = true;
+	DamageState = INDEX_NONE;
+	DamageStateDirty = true;
 	IsPoweredCacheIndex = 0;
 
 	for (int32 Index = EFlareSubsystem::SYS_None; Index <= EFlareSubsystem::SYS_WeaponAndAmmo; Index++)
@@ -608,11 +612,83 @@ void UFlareSimulatedSpacecraftDamageSystem::SetDamageDirty(FFlareSpacecraftCompo
 	{
 		SetPowerDirty();
 	}
+
+	Spacecraft->GetCompany()->InvalidateCompanyValue();
+	SetDamageStateDirty();
 }
 
 void UFlareSimulatedSpacecraftDamageSystem::SetAmmoDirty()
 {
 	AmmoDirty = true;
+
+	// Disarmed ships have no combat value
+	Spacecraft->GetCompany()->InvalidateCompanyValue();
+	SetDamageStateDirty();
+}
+
+void UFlareSimulatedSpacecraftDamageSystem::SetDamageStateDirty()
+{
+	if (DamageStateDirty)
+	{
+		return;
+	}
+
+	// The sector publishes the new state when it is needed, once for all damages
+	DamageStateDirty = true;
+	if (Spacecraft->GetCurrentSector())
+	{
+		Spacecraft->GetCurrentSector()->SetDamageStateDirty(Spacecraft);
+	}
+}
+
+void UFlareSimulatedSpacecraftDamageSystem::UpdateDamageState()
+{
+	if (!DamageStateDirty)
+	{
+		return;
+	}
+
+	DamageStateDirty = false;
+	int32 NewDamageState = ComputeDamageState();
+	if (NewDamageState == DamageState)
+	{
+		return;
+	}
+
+	int32 OldDamageState = DamageState;
+	DamageState = NewDamageState;
+	INC_DWORD_STAT(STAT_FlareSimulatedDamageSystem_DamageStateChanges);
+
+	if (Spacecraft->GetCurrentSector())
+	{
+		Spacecraft->GetCurrentSector()->OnSpacecraftDamageStateChanged(Spacecraft, OldDamageState, NewDamageState);
+	}
+	Spacecraft->GetCompany()->OnSpacecraftDamageStateChanged(Spacecraft, OldDamageState, NewDamageState);
+	Spacecraft->GetGame()->OnDamageStateChanged().Broadcast(Spacecraft, OldDamageState, NewDamageState);
+}
+
+int32 UFlareSimulatedSpacecraftDamageSystem::ComputeDamageState() const
+{
+	int32 State = 0;
+
+	if (IsAlive())
+	{
+		State |= EFlareDamageState::Alive;
+	}
+	if (IsStranded())
+	{
+		State |= EFlareDamageState::Stranded;
+	}
+	if (IsUncontrollable())
+	{
+		State |= EFlareDamageState::Uncontrollable;
+	}
+	if (IsDisarmed())
+	{
+		State |= EFlareDamageState::Disarmed;
+	}
+
+	return State;
 }
 
 bool UFlareSimulatedSpacecraftDamageSystem::IsPowered(FFlareSpacecraftComponentSave* ComponentToPowerData) const
@@ -21,6 +21,21 @@ namespace EFlareSubsystem
 	};
 }
 
+/** Damage state flags, published by the damage system when they change */
+namespace EFlareDamageState
+{
+	enum Type
+	{
+		Alive = 1,
+		Stranded = 2,
+		Uncontrollable = 4,
+		Disarmed = 8
+	};
+}
+
+/** Damage state change event : spacecraft, old state (INDEX_NONE if never published), new state */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FFlareDamageStateChanged, UFlareSimulatedSpacecraft*, int32, int32);
+
 /** Spacecraft damage system class */
 UCLASS()
 class HELIUMRAIN_API UFlareSimulatedSpacecraftDamageSystem : public UObject
@@ -105,6 +120,20 @@ public:
 	void SetDamageDirty(FFlareSpacecraftComponentDescription* ComponentDescription);
 	void SetAmmoDirty();
 
+	/** Publish the damage state if it may have changed, notifying the sector, the company and the game */
+	void UpdateDamageState();
+
+	/** Get the last published EFlareDamageState flags, INDEX_NONE if never published */
+	inline int32 GetDamageState() const
+	{
+		return DamageState;
+	}
+
+	inline bool IsDamageStateDirty() const
+	{
+		return DamageStateDirty;
+	}
+
 protected:
 
 	/*----------------------------------------------------
@@ -124,6 +153,12 @@ protected:
 	// Update health values
 	float GetSubsystemHealthInternal(EFlareSubsystem::Type Type) const;
 
+	/** Compute the current EFlareDamageState flags */
+	int32 ComputeDamageState() const;
+
+	/** Damage or ammo changed : the damage state must be published again */
+	void SetDamageStateDirty();
+
 	/*----------------------------------------------------
 		Protected data
 	----------------------------------------------------*/
@@ -138,6 +173,10 @@ protected:
 	bool                                            DamageDirty;
 	bool                                            AmmoDirty;
 
+	// Published damage state
+	int32                                           DamageState;
+	bool                                            DamageStateDirty;
+
 public:
 
 
@@ -10,6 +10,8 @@
 #include "../FlareShell.h"
 
 DECLARE_CYCLE_STAT(TEXT("FlareDamageSystem Tick"), STAT_FlareDamageSystem_Tick, STATGROUP_Flare);
+DECLARE_CYCLE_STAT(TEXT("FlareDamageSystem ApplyDamage"), STAT_FlareDamageSystem_ApplyDamage, STATGROUP_Flare);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FlareDamageSystem Damaged components"), STAT_FlareDamageSystem_DamagedComponents, STATGROUP_Flare);
 
 #define LOCTEXT_NAMESPACE "FlareSpacecraftDamageSystem"
 
@@ -21,6 +23,8 @@ DECLARE_CYCLE_STAT(TEXT("FlareDamageSystem Tick"), STAT_FlareDamageSystem_Tick,
 UFlareSpacecraftDamageSystem::UFlareSpacecraftDamageSystem(const class FObjectInitializer& PCIP)
 	: Super(PCIP)
 	, Spacecraft(NULL)
+	, StationCockpitIndex(INDEX_NONE)
+	, PowerDirty(false)
 	, LastDamageCauser(NULL)
 {
 }
@@ -72,10 +76,16 @@ void UFlareSpacecraftDamageSystem::TickSystem(float DeltaSeconds)
 		if (Data->PowerOutageDelay <=0)
 		{
 			Data->PowerOutageDelay = 0;
-			UpdatePower(); // To update light
+			PowerDirty = true; // To update light
 		}
 	}
 
+	// Update power once for all damages since the last tick
+	if (PowerDirty)
+	{
+		UpdatePower();
+	}
+
 	// Update uncontrollable status
 	if (WasControllable && Parent->IsUncontrollable())
 	{
@@ -169,6 +179,8 @@ void UFlareSpacecraftDamageSystem::Start()
 {
 	// Reload components
 	Components = Spacecraft->GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
+	ComponentTree.Build(Spacecraft->GetRootComponent()->GetComponentTransform(), Components);
+	StationCockpitIndex = (Spacecraft->IsStation() ? Components.Find(Spacecraft->GetCockpit()) : INDEX_NONE);
 	Parent->TickSystem();
 
 	// Init alive status
@@ -190,6 +202,8 @@ void UFlareSpacecraftDamageSystem::SetLastDamageCauser(AFlareSpacecraft* Ship)
 
 void UFlareSpacecraftDamageSystem::UpdatePower()
 {
+	PowerDirty = false;
+
 	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
 	{
 		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
@@ -494,6 +508,8 @@ void UFlareSpacecraftDamageSystem::OnCollision(class AActor* Other, FVector HitL
 
 void UFlareSpacecraftDamageSystem::ApplyDamage(float Energy, float Radius, FVector Location, EFlareDamage::Type DamageType, UFlareSimulatedSpacecraft* DamageSource)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FlareDamageSystem_ApplyDamage);
+
 	// The damages are applied to all component touching the sphere defined by the radius and the
 	// location in parameter.
 	// The maximum damage are applied to a component only if its bounding sphere touch the center of
@@ -534,10 +550,20 @@ void UFlareSpacecraftDamageSystem::ApplyDamage(float Energy, float Radius, FVect
 	FVector LocalLocation = Spacecraft->GetRootComponent()->GetComponentTransform().InverseTransformPosition(Location) / 100.f;
 	CombatLog::SpacecraftDamaged(Spacecraft->GetParent(), Energy, Radius, LocalLocation, DamageType, CompanyDamageSource);
 
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	// Only components whose bounds may touch the damage sphere are tested
+	ComponentTree.QuerySphere(Spacecraft->GetRootComponent()->GetComponentTransform(), Location, Radius * 100, DamagedComponents);
+	if (StationCockpitIndex != INDEX_NONE && !DamagedComponents.Contains(StationCockpitIndex))
+	{
+		DamagedComponents.Add(StationCockpitIndex);
+		DamagedComponents.Sort();
+	}
+	INC_DWORD_STAT_BY(STAT_FlareDamageSystem_DamagedComponents, DamagedComponents.Num());
+
+	for (int32 DamagedIndex = 0; DamagedIndex < DamagedComponents.Num(); DamagedIndex++)
 	{
+		int32 ComponentIndex = DamagedComponents[DamagedIndex];
 		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
-		bool IsStationCockpit = Spacecraft->IsStation() && Spacecraft->GetCockpit() == Component;
+		bool IsStationCockpit = (ComponentIndex == StationCockpitIndex);
 
 		float ComponentSize;
 		FVector ComponentLocation;
@@ -561,8 +587,8 @@ void UFlareSpacecraftDamageSystem::ApplyDamage(float Energy, float Radius, FVect
 		}
 	}
 
-	// Update power
-	UpdatePower();
+	// Update power at the next tick
+	PowerDirty = true;
 
 	// Heat the ship
 	Data->Heat += Energy;
@@ -610,7 +636,7 @@ void UFlareSpacecraftDamageSystem::OnElectricDamage(float DamageRatio)
 		{
 			Data->PowerOutageDelay += FMath::FRandRange(1, 5) /  (2 * PowerRatio);
 			Data->PowerOutageAcculumator = -Data->PowerOutageAcculumator * PowerRatio;
-			UpdatePower();
+			PowerDirty = true;
 		}
 	}
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include "../FlareSpacecraftComponentTree.h"
 #include "FlareSpacecraftDamageSystem.generated.h"
 
 class AFlareSpacecraft;
@@ -85,6 +86,14 @@ protected:
 	UFlareSimulatedSpacecraftDamageSystem*          Parent;
 	TArray<UActorComponent*>                        Components;
 
+	/** Components in spacecraft space, for damage lookups */
+	FFlareSpacecraftComponentTree                   ComponentTree;
+	TArray<int32>                                   DamagedComponents;
+	int32                                           StationCockpitIndex;
+
+	/** Power must be updated at the next tick */
+	bool                                            PowerDirty;
+
 	bool                                            WasControllable; // True if was controllable at the last tick
 	bool                                            WasAlive;
 	float											TimeSinceLastExternalDamage;
@@ -100,4 +109,9 @@ public:
 	{
 		return TimeSinceLastExternalDamage;
 	}
+
+	inline const FFlareSpacecraftComponentTree& GetComponentTree() const
+	{
+		return ComponentTree;
+	}
 };
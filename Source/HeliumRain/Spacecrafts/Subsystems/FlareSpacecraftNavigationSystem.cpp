@@ -734,10 +734,10 @@ void UFlareSpacecraftNavigationSystem::ConfirmDock(AFlareSpacecraft* DockStation
 	DockConstraint->SetConstrainedComponents(Spacecraft->Airframe, NAME_None, DockStation->Airframe,NAME_None);
 
 	// Cut engines
-	TArray<UActorComponent*> Engines = Spacecraft->GetComponentsByClass(UFlareEngine::StaticClass());
+	const TArray<UFlareEngine*>& Engines = Spacecraft->GetEngines();
 	for (int32 EngineIndex = 0; EngineIndex < Engines.Num(); EngineIndex++)
 	{
-		UFlareEngine* Engine = Cast<UFlareEngine>(Engines[EngineIndex]);
+		UFlareEngine* Engine = Engines[EngineIndex];
 		Engine->SetAlpha(0.0f);
 	}
 
@@ -889,33 +889,26 @@ AFlareSpacecraft* UFlareSpacecraftNavigationSystem::GetNearestShip(AFlareSpacecr
 	// - Is the nearest
 	// - Is not me
 
-	FVector PilotLocation = Spacecraft->GetActorLocation();
-	float MinDistanceSquared = -1;
-	AFlareSpacecraft* NearestShip = NULL;
-
-	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Spacecraft->GetGame()->GetActiveSector()->GetSpacecrafts().Num(); SpacecraftIndex++)
+	const FFlareSpatialEntry* NearestShip = Spacecraft->GetGame()->GetActiveSector()->GetSpatialIndex().FindNearest(Spacecraft->GetActorLocation(), EFlareSpatialBody::Spacecraft, false,
+		[=](const FFlareSpatialEntry& Entry)
 	{
-		AFlareSpacecraft* ShipCandidate = Spacecraft->GetGame()->GetActiveSector()->GetSpacecrafts()[SpacecraftIndex];
+		AFlareSpacecraft* ShipCandidate = Entry.Spacecraft;
 
-		if (ShipCandidate != Spacecraft && ShipCandidate != DockingStation)
+		if (ShipCandidate == Spacecraft || ShipCandidate == DockingStation)
 		{
+			return false;
+		}
 
-			if (DockingStation && (DockingStation->GetDockingSystem()->IsGrantedShip(ShipCandidate) || DockingStation->GetDockingSystem()->IsDockedShip(ShipCandidate)))
-			{
-				// Ignore ship docked or docking at the same station
-				continue;
-			}
+		if (DockingStation && (DockingStation->GetDockingSystem()->IsGrantedShip(ShipCandidate) || DockingStation->GetDockingSystem()->IsDockedShip(ShipCandidate)))
+		{
+			// Ignore ship docked or docking at the same station
+			return false;
+		}
 
-			float DistanceSquared = (PilotLocation - ShipCandidate->GetActorLocation()).SizeSquared();
+		return true;
+	});
 
-			if (NearestShip == NULL || DistanceSquared < MinDistanceSquared)
-			{
-				MinDistanceSquared = DistanceSquared;
-				NearestShip = ShipCandidate;
-			}
-		}
-	}
-	return NearestShip;
+	return NearestShip ? NearestShip->Spacecraft : NULL;
 }
 
 /*----------------------------------------------------
@@ -927,7 +920,7 @@ bool UFlareSpacecraftNavigationSystem::UpdateLinearAttitudeAuto(float DeltaSecon
 {
 	SCOPE_CYCLE_COUNTER(STAT_NavigationSystem_UpdateLinearAttitudeAuto);
 
-	TArray<UActorComponent*> Engines = Spacecraft->GetComponentsByClass(UFlareEngine::StaticClass());
+	const TArray<UFlareEngine*>& Engines = Spacecraft->GetEngines();
 
 	FVector DeltaPosition = (TargetLocation - Spacecraft->GetActorLocation()) / 100; // Distance in meters
 	FVector DeltaPositionDirection = DeltaPosition;
@@ -1014,7 +1007,7 @@ void UFlareSpacecraftNavigationSystem::UpdateAngularAttitudeAuto(float DeltaSeco
 {
 	SCOPE_CYCLE_COUNTER(STAT_NavigationSystem_UpdateAngularAttitudeAuto);
 
-	TArray<UActorComponent*> Engines = Spacecraft->GetComponentsByClass(UFlareEngine::StaticClass());
+	const TArray<UFlareEngine*>& Engines = Spacecraft->GetEngines();
 
 	// Rotation data
 	FFlareShipCommandData Command;
@@ -1092,7 +1085,7 @@ FVector UFlareSpacecraftNavigationSystem::GetAngularVelocityToAlignAxis(FVector
 {
 	SCOPE_CYCLE_COUNTER(STAT_NavigationSystem_GetAngularVelocityToAlignAxis);
 
-	TArray<UActorComponent*> Engines = Spacecraft->GetComponentsByClass(UFlareEngine::StaticClass());
+	const TArray<UFlareEngine*>& Engines = Spacecraft->GetEngines();
 
 	FVector AngularVelocity = Spacecraft->Airframe->GetPhysicsAngularVelocity();
 	FVector WorldShipAxis = Spacecraft->Airframe->GetComponentToWorld().GetRotation().RotateVector(LocalShipAxis);
@@ -1167,14 +1160,14 @@ void UFlareSpacecraftNavigationSystem::PhysicSubTick(float DeltaSeconds)
 {
 	SCOPE_CYCLE_COUNTER(STAT_NavigationSystem_Physics);
 
-	TArray<UActorComponent*> Engines = Spacecraft->GetComponentsByClass(UFlareEngine::StaticClass());
+	const TArray<UFlareEngine*>& Engines = Spacecraft->GetEngines();
 
 	if(Spacecraft->GetParent()->GetDamageSystem()->IsUncontrollable())
 	{
 		// Shutdown engines
 		for (int32 EngineIndex = 0; EngineIndex < Engines.Num(); EngineIndex++)
 		{
-			UFlareEngine* Engine = Cast<UFlareEngine>(Engines[EngineIndex]);
+			UFlareEngine* Engine = Engines[EngineIndex];
 			Engine->SetAlpha(0);
 		}
 
@@ -1263,7 +1256,7 @@ void UFlareSpacecraftNavigationSystem::PhysicSubTick(float DeltaSeconds)
 	// Update engine alpha
 	for (int32 EngineIndex = 0; EngineIndex < Engines.Num(); EngineIndex++)
 	{
-		UFlareEngine* Engine = Cast<UFlareEngine>(Engines[EngineIndex]);
+		UFlareEngine* Engine = Engines[EngineIndex];
 		FVector ThrustAxis = Engine->GetThrustAxis();
 		float LinearAlpha = 0;
 		float AngularAlpha = 0;
@@ -1310,7 +1303,7 @@ void UFlareSpacecraftNavigationSystem::UpdateCOM()
 		Getters (Attitude)
 ----------------------------------------------------*/
 
-FVector UFlareSpacecraftNavigationSystem::GetTotalMaxThrustInAxis(TArray<UActorComponent*>& Engines, FVector Axis, bool WithOrbitalEngines) const
+FVector UFlareSpacecraftNavigationSystem::GetTotalMaxThrustInAxis(const TArray<UFlareEngine*>& Engines, FVector Axis, bool WithOrbitalEngines) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_NavigationSystem_GetTotalMaxThrustInAxis);
 
@@ -1318,7 +1311,7 @@ FVector UFlareSpacecraftNavigationSystem::GetTotalMaxThrustInAxis(TArray<UActorC
 	FVector TotalMaxThrust = FVector::ZeroVector;
 	for (int32 i = 0; i < Engines.Num(); i++)
 	{
-		UFlareEngine* Engine = Cast<UFlareEngine>(Engines[i]);
+		UFlareEngine* Engine = Engines[i];
 
 		FVector WorldThrustAxis = Engine->GetThrustAxis();
 		float Ratio = FVector::DotProduct(WorldThrustAxis, Axis);
@@ -1342,7 +1335,7 @@ FVector UFlareSpacecraftNavigationSystem::GetTotalMaxThrustInAxis(TArray<UActorC
 	return TotalMaxThrust;
 }
 
-float UFlareSpacecraftNavigationSystem::GetTotalMaxTorqueInAxis(TArray<UActorComponent*>& Engines, FVector TorqueAxis, bool WithDamages) const
+float UFlareSpacecraftNavigationSystem::GetTotalMaxTorqueInAxis(const TArray<UFlareEngine*>& Engines, FVector TorqueAxis, bool WithDamages) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_NavigationSystem_GetTotalMaxTorqueInAxis);
 
@@ -1350,7 +1343,7 @@ float UFlareSpacecraftNavigationSystem::GetTotalMaxTorqueInAxis(TArray<UActorCom
 	float TotalMaxTorque = 0;
 
 	for (int32 i = 0; i < Engines.Num(); i++) {
-		UFlareEngine* Engine = Cast<UFlareEngine>(Engines[i]);
+		UFlareEngine* Engine = Engines[i];
 
 		// Ignore orbital engines for torque computation
 		if (Engine->IsA(UFlareOrbitalEngine::StaticClass()))
@@ -6,6 +6,9 @@
 #include "../FlareSpacecraft.h"
 
 DECLARE_CYCLE_STAT(TEXT("FlareWeaponsSystem Tick"), STAT_FlareWeaponsSystem_Tick, STATGROUP_Flare);
+DECLARE_CYCLE_STAT(TEXT("FlareWeaponsSystem GetTurretTargetCandidates"), STAT_FlareWeaponsSystem_GetTurretTargetCandidates, STATGROUP_Flare);
+
+static const float TurretTargetEvaluationPeriod = 0.5f; // Turret targets are rescored twice per second
 
 #define LOCTEXT_NAMESPACE "FlareSpacecraftWeaponsSystem"
 
@@ -153,6 +156,28 @@ void UFlareSpacecraftWeaponsSystem::Initialize(AFlareSpacecraft* OwnerSpacecraft
 	Data = OwnerData;
 }
 
+const TArray<PilotHelper::TargetCandidate>& UFlareSpacecraftWeaponsSystem::GetTurretTargetCandidates(int32 PreferenceSet, const PilotHelper::TargetPreferences& Preferences)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareWeaponsSystem_GetTurretTargetCandidates);
+
+	float Time = Spacecraft->GetWorld()->GetTimeSeconds();
+	FFlareTurretTargetCandidates* TargetCandidates = TurretTargetCandidates.Find(PreferenceSet);
+
+	if (!TargetCandidates)
+	{
+		TargetCandidates = &TurretTargetCandidates.Add(PreferenceSet);
+		TargetCandidates->UpdateTime = -TurretTargetEvaluationPeriod;
+	}
+
+	if (Time - TargetCandidates->UpdateTime >= TurretTargetEvaluationPeriod)
+	{
+		PilotHelper::GetTargetCandidates(Spacecraft, Preferences, TargetCandidates->Candidates);
+		TargetCandidates->UpdateTime = Time;
+	}
+
+	return TargetCandidates->Candidates;
+}
+
 inline static bool ConstPredicate (const FFlareWeaponGroup& ip1, const FFlareWeaponGroup& ip2)
  {
 	 return (ip1.Description->WeaponCharacteristics.Order < ip2.Description->WeaponCharacteristics.Order);
@@ -169,10 +194,10 @@ void UFlareSpacecraftWeaponsSystem::Start()
 	}
 	WeaponGroupList.Empty();
 
-	TArray<UActorComponent*> Weapons = Spacecraft->GetComponentsByClass(UFlareWeapon::StaticClass());
+	const TArray<UFlareWeapon*>& Weapons = Spacecraft->GetWeapons();
 	for (int32 ComponentIndex = 0; ComponentIndex < Weapons.Num(); ComponentIndex++)
 	{
-		UFlareWeapon* Weapon = Cast<UFlareWeapon>(Weapons[ComponentIndex]);
+		UFlareWeapon* Weapon = Weapons[ComponentIndex];
 		if(Weapon->GetDescription() == NULL)
 		{
 			FLOGV("ERROR: Weapon %s has no description", *Weapon->GetName());
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "FlareSpacecraftWeaponsSystemInterface.h"
+#include "../FlarePilotHelper.h"
 #include "FlareSpacecraftWeaponsSystem.generated.h"
 
 class AFlareSpacecraft;
@@ -21,6 +22,13 @@ struct FFlareWeaponGroup
 	AFlareSpacecraft*								Target;
 };
 
+/** Ranked targets shared by the turrets using the same target preferences */
+struct FFlareTurretTargetCandidates
+{
+	TArray<PilotHelper::TargetCandidate>            Candidates;
+	float                                           UpdateTime;
+};
+
 
 /** Spacecraft weapons system class */
 UCLASS()
@@ -115,6 +123,9 @@ public:
 
 	int32 FindBestWeaponGroup(AFlareSpacecraft* Target);
 
+	/** Get the targets ranked for a set of turret preferences, rescored at most once per evaluation period */
+	const TArray<PilotHelper::TargetCandidate>& GetTurretTargetCandidates(int32 PreferenceSet, const PilotHelper::TargetPreferences& Preferences);
+
 protected:
 
 	/*----------------------------------------------------
@@ -139,4 +150,7 @@ protected:
 	FFlareSpacecraftDescription*                     Description;
 	TArray<UActorComponent*>                         Components;
 
+	/** Turret targets, by preference set */
+	TMap<int32, FFlareTurretTargetCandidates>        TurretTargetCandidates;
+
 };
@@ -500,7 +500,7 @@ FText SFlareSectorMenu::GetTravelText() const
 		}
 		else
 		{
-			int64 TravelDuration = UFlareTravel::ComputeTravelDuration(MenuManager->GetGame()->GetGameWorld(), SelectedFleet->GetCurrentSector(), TargetSector);
+			int64 TravelDuration = MenuManager->GetGame()->GetGameWorld()->GetTravelDuration(SelectedFleet->GetCurrentSector(), TargetSector);
 
 			FText TravelWord;
 